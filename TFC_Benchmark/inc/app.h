@@ -0,0 +1,18 @@
+/*
+ * app.h
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Minimal replacement of the Tizen application API for the Linux build of the benchmark. The
+ * application has no data directory, so the response cache keeps its responses in memory.
+ */
+
+#ifndef TFC_BENCHMARK_APP_H_
+#define TFC_BENCHMARK_APP_H_
+
+inline char* app_get_data_path()
+{
+	return nullptr;
+}
+
+#endif /* TFC_BENCHMARK_APP_H_ */
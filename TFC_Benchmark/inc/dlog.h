@@ -0,0 +1,43 @@
+/*
+ * dlog.h
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Minimal replacement of the Tizen logging API for the Linux build of the benchmark. Only
+ * warnings and errors are printed, so the log does not disturb the measurement.
+ */
+
+#ifndef TFC_BENCHMARK_DLOG_H_
+#define TFC_BENCHMARK_DLOG_H_
+
+#include <cstdarg>
+#include <cstdio>
+
+typedef enum
+{
+	DLOG_UNKNOWN = 0,
+	DLOG_DEFAULT,
+	DLOG_VERBOSE,
+	DLOG_DEBUG,
+	DLOG_INFO,
+	DLOG_WARN,
+	DLOG_ERROR,
+	DLOG_FATAL,
+	DLOG_SILENT
+} log_priority;
+
+inline int dlog_print(log_priority prio, const char* tag, const char* fmt, ...)
+{
+	if(prio < DLOG_WARN)
+		return 0;
+
+	va_list args;
+	va_start(args, fmt);
+	fprintf(stderr, "%s: ", tag);
+	int ret = vfprintf(stderr, fmt, args);
+	fputc('\n', stderr);
+	va_end(args);
+	return ret;
+}
+
+#endif /* TFC_BENCHMARK_DLOG_H_ */
@@ -0,0 +1,338 @@
+/*
+ * RESTBenchmark.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Standalone benchmark for the REST client, run against LocalHTTPServer on the loopback interface.
+ * Every scenario reports its time per operation, and each pair of scenarios checks that the
+ * optimized path is faster than the path it replaces. The program exits with a non-zero status if
+ * any check fails.
+ *
+ * Usage: rest_benchmark [-f scenario-prefix]
+ */
+
+#include "TFC/Net/REST.h"
+#include "LocalHTTPServer.h"
+
+#include <Ecore.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+class LocalGetService : public TFC::Net::RESTServiceBase<std::string>
+{
+public:
+	LocalGetService(std::string const& url) :
+		RESTServiceBase(url, TFC::Net::HTTPMode::Get)
+	{
+	}
+protected:
+	virtual std::string* OnProcessResponse(int httpCode, const std::string& responseStr, int& errorCode, std::string& errorMessage)
+	{
+		return new std::string(responseStr);
+	}
+};
+
+class UrlTemplateService : public TFC::Net::RESTServiceBase<std::string>
+{
+public:
+	Parameter<TFC::Net::ParameterType::URL, std::string> UserId;
+	Parameter<TFC::Net::ParameterType::URL, int> PostId;
+
+	UrlTemplateService(std::string const& url) :
+		RESTServiceBase(url, TFC::Net::HTTPMode::Get),
+		UserId(this, "user_id"),
+		PostId(this, "postId")
+	{
+	}
+
+	std::string BuildUrl()
+	{
+		return PrepareUrl();
+	}
+
+	// Regex based implementation which is replaced by the parsed template
+	std::string BuildUrlWithRegex()
+	{
+		std::stringstream urlBuffer;
+		std::regex urlRegex(R"REGEX((\{([A-Za-z0-9_]+)\}))REGEX");
+
+		auto lastToken = Url.cbegin();
+		for(std::sregex_iterator i(Url.begin(), Url.end(), urlRegex), end; i != end; ++i)
+		{
+			std::smatch match = *i;
+			urlBuffer << std::string(lastToken, match[1].first);
+			lastToken = match[1].second;
+			urlBuffer << urlParam.find(match[2].str())->second->GetEncodedValue();
+		}
+
+		urlBuffer << std::string(lastToken, Url.cend());
+		return urlBuffer.str();
+	}
+protected:
+	virtual std::string* OnProcessResponse(int httpCode, const std::string& responseStr, int& errorCode, std::string& errorMessage)
+	{
+		return new std::string(responseStr);
+	}
+};
+
+class FormPostService : public TFC::Net::RESTServiceBase<std::string>
+{
+public:
+	Parameter<TFC::Net::ParameterType::PostData, std::string> Title;
+	Parameter<TFC::Net::ParameterType::PostData, std::string> Body;
+
+	FormPostService() :
+		RESTServiceBase("http://127.0.0.1/posts", TFC::Net::HTTPMode::Post),
+		Title(this, "title"),
+		Body(this, "body")
+	{
+	}
+
+	std::string BuildPostData()
+	{
+		return PreparePostData(postDataParam);
+	}
+
+	// Stream based implementation which is replaced by the shared encoder
+	std::string BuildPostDataWithStream()
+	{
+		std::stringstream postDataStream;
+
+		bool first = true;
+		for(auto& val : postDataParam)
+		{
+			if(!first)
+				postDataStream << "&";
+			first = false;
+
+			std::stringstream st;
+			for(char c : val.second->GetRawValue())
+			{
+				if(isalnum(c))
+					st << c;
+				else
+					st << "%" << std::hex << ((int)c);
+			}
+
+			postDataStream << val.first << "=" << st.str();
+		}
+
+		return postDataStream.str();
+	}
+protected:
+	virtual std::string* OnProcessResponse(int httpCode, const std::string& responseStr, int& errorCode, std::string& errorMessage)
+	{
+		return new std::string(responseStr);
+	}
+};
+
+std::string filter;
+int failureCount = 0;
+
+bool Selected(char const* name)
+{
+	return strncmp(name, filter.c_str(), filter.size()) == 0;
+}
+
+void ReportFailure(char const* name, std::string const& message)
+{
+	std::cerr << "FAILED: " << name << " " << message << '\n';
+	failureCount++;
+}
+
+void Report(char const* name, long long value, char const* unit)
+{
+	std::cout << name << ": " << value << ' ' << unit << '\n';
+}
+
+template<typename TDuration, typename TFunc>
+long long MeasurePerOp(int iteration, TFunc func)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	for(int i = 0; i < iteration; i++)
+		func();
+
+	return std::chrono::duration_cast<TDuration>(std::chrono::steady_clock::now() - start).count() / iteration;
+}
+
+void RunConnectionReuse()
+{
+	if(!Selected("connection."))
+		return;
+
+	int const callCount = 200;
+
+	LocalHTTPServer keepAliveServer([] (LocalHTTPServer::Request const& request) {
+		return LocalHTTPServer::Response { 200, { }, "keep-alive" };
+	});
+
+	LocalHTTPServer closingServer([] (LocalHTTPServer::Request const& request) {
+		return LocalHTTPServer::Response { 200, { { "Connection", "close" } }, "close" };
+	});
+
+	auto call = [] (LocalHTTPServer& server) {
+		LocalGetService service(server.GetBaseUrl() + "/resource");
+		auto result = service.Call();
+		std::string* response = result.Response;
+		delete response;
+	};
+
+	auto reusedTime = MeasurePerOp<std::chrono::microseconds>(callCount, [&] { call(keepAliveServer); });
+	auto freshTime = MeasurePerOp<std::chrono::microseconds>(callCount, [&] { call(closingServer); });
+
+	Report("connection.reused", reusedTime, "us/call");
+	Report("connection.new", freshTime, "us/call");
+
+	if(keepAliveServer.GetConnectionCount() != 1)
+		ReportFailure("connection.reused", "does not reuse the connection between calls");
+
+	if(reusedTime >= freshTime)
+		ReportFailure("connection.reused", "is not faster than a new connection");
+}
+
+void RunUrlTemplate()
+{
+	if(!Selected("url."))
+		return;
+
+	int const buildCount = 20000;
+
+	UrlTemplateService service("https://example.com/api/v1/users/{user_id}/posts/{postId}/comments");
+	service.UserId = "john";
+	service.PostId = 42;
+
+	auto templateTime = MeasurePerOp<std::chrono::nanoseconds>(buildCount, [&] { service.BuildUrl(); });
+	auto regexTime = MeasurePerOp<std::chrono::nanoseconds>(buildCount, [&] { service.BuildUrlWithRegex(); });
+
+	Report("url.template", templateTime, "ns/url");
+	Report("url.regex", regexTime, "ns/url");
+
+	if(templateTime >= regexTime)
+		ReportFailure("url.template", "is not faster than regex");
+}
+
+void RunPercentEncoding()
+{
+	if(!Selected("percent."))
+		return;
+
+	int const buildCount = 20;
+
+	// Large form post of mixed text, with a third of the bytes encoded
+	std::string body;
+	for(int i = 0; i < 64 * 1024; i++)
+		body += "Lorem ipsum, dolor sit amet & caf\xC3\xA9. ";
+
+	FormPostService service;
+	service.Title = "Large form";
+	service.Body = body;
+
+	auto encoderTime = MeasurePerOp<std::chrono::microseconds>(buildCount, [&] { service.BuildPostData(); });
+	auto streamTime = MeasurePerOp<std::chrono::microseconds>(buildCount, [&] { service.BuildPostDataWithStream(); });
+
+	Report("percent.encoder", encoderTime, "us/form");
+	Report("percent.stream", streamTime, "us/form");
+
+	if(encoderTime >= streamTime)
+		ReportFailure("percent.encoder", "is not faster than stream");
+}
+
+struct EngineRun
+{
+	std::string baseUrl;
+	int requestCount;
+	std::vector<std::unique_ptr<LocalGetService>> services;
+	int completed;
+};
+
+void StartEngineRun(void* data)
+{
+	auto& run = *static_cast<EngineRun*>(data);
+
+	for(int i = 0; i < run.requestCount; i++)
+	{
+		run.services.emplace_back(new LocalGetService(run.baseUrl + "/item/" + std::to_string(i)));
+		run.services.back()->CallAsync([&run] (TFC::Net::RESTResult<std::string> result) {
+			std::string* response = result.Response;
+			delete response;
+
+			if(++run.completed == run.requestCount)
+				ecore_main_loop_quit();
+		});
+	}
+}
+
+void RunConcurrentEngine()
+{
+	if(!Selected("engine."))
+		return;
+
+	using Ms = std::chrono::milliseconds;
+	int const requestCount = 100;
+	int const delay = 200;
+
+	// Every response is delayed, so the requests complete in time only if they run concurrently
+	LocalHTTPServer server([delay] (LocalHTTPServer::Request const& request) {
+		std::this_thread::sleep_for(Ms(delay));
+		return LocalHTTPServer::Response { 200, { }, request.target };
+	});
+
+	EngineRun run { server.GetBaseUrl(), requestCount, { }, 0 };
+
+	auto start = std::chrono::steady_clock::now();
+	ecore_job_add(StartEngineRun, &run);
+	ecore_main_loop_begin();
+	auto elapsed = std::chrono::duration_cast<Ms>(std::chrono::steady_clock::now() - start).count();
+
+	run.services.clear();
+	Report("engine.concurrent", elapsed, "ms/run");
+
+	// Sequential requests would take 20 seconds
+	if(elapsed >= requestCount * delay / 4)
+		ReportFailure("engine.concurrent", "does not perform the requests concurrently");
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	int option;
+
+	while((option = getopt(argc, argv, "f:")) != -1)
+	{
+		switch(option)
+		{
+		case 'f': filter = optarg; break;
+		default:
+			std::cerr << "Usage: " << argv[0] << " [-f scenario-prefix]\n";
+			return 2;
+		}
+	}
+
+	ecore_init();
+
+	RunConnectionReuse();
+	RunUrlTemplate();
+	RunPercentEncoding();
+	RunConcurrentEngine();
+
+	ecore_shutdown();
+
+	if(failureCount > 0)
+	{
+		std::cerr << failureCount << " checks failed\n";
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,500 @@
+/*
+ * SerializationBenchmark.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Standalone benchmark for the serialization stack. Every scenario reports the time, the
+ * serialized size and the number of heap allocations per operation. The result is written as tab
+ * separated values, and compared against the baseline if the scenario is listed there. The
+ * program exits with a non-zero status if any scenario regresses.
+ *
+ * Usage: serialization_benchmark [-b baseline.tsv] [-o result.tsv] [-f scenario-prefix]
+ *
+ * To update the baseline, copy the produced file over res/serialization_baseline.tsv. A "-" in
+ * the baseline disables the check for that column. Allocation counts are deterministic for a
+ * given standard library, while the time has to be recorded on the machine which runs the gate.
+ */
+
+#include "TFC/ServiceModel/BinarySerializer.h"
+#include "TFC/ServiceModel/GDBusEndpoint.h"
+#include "TFC/Serialization/ClassSerializer.h"
+#include "TFC/Serialization/DiscriminatedUnionSerializer.h"
+#include "TFC/Serialization/ParameterSerializer.h"
+#include "TFC/Serialization/TableSerializer.h"
+#include "TFC/Serialization/Predicates.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+
+namespace {
+
+std::atomic<size_t> allocationCount { 0 };
+
+}
+
+// Count every heap allocation made by the benchmark, so it can report the number of allocations
+// per operation. Memory allocated by GLib is not counted.
+void* operator new(size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	void* ptr = std::malloc(size != 0 ? size : 1);
+	if(ptr == nullptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+namespace {
+
+struct FlatRecord
+{
+	int32_t id;
+	uint32_t flags;
+	int64_t timestamp;
+	double value;
+	bool valid;
+};
+
+struct NestedRecord
+{
+	FlatRecord first;
+	std::string name;
+	FlatRecord second;
+};
+
+struct VectorRecord
+{
+	std::vector<int32_t> ints;
+	std::vector<double> doubles;
+	std::vector<FlatRecord> records;
+};
+
+struct StringRecord
+{
+	std::string title;
+	std::string body;
+};
+
+struct PredicatedRecord
+{
+	uint32_t mask;
+	std::string label;
+	int64_t counter;
+	double ratio;
+};
+
+struct EventRecord
+{
+	uint32_t kind;
+	union
+	{
+		int32_t code;
+		double measurement;
+		int64_t tick;
+	};
+};
+
+class IBenchmarkService
+{
+public:
+	virtual void Submit(int32_t id, std::string name, double value, std::vector<int32_t> samples) = 0;
+	virtual ~IBenchmarkService() { }
+};
+
+}
+
+TFC_DefineTypeSerializationInfo(FlatRecord,
+	TFC_FieldInfo(FlatRecord::id),
+	TFC_FieldInfo(FlatRecord::flags),
+	TFC_FieldInfo(FlatRecord::timestamp),
+	TFC_FieldInfo(FlatRecord::value),
+	TFC_FieldInfo(FlatRecord::valid));
+
+TFC_DefineTypeSerializationInfo(NestedRecord,
+	TFC_FieldInfo(NestedRecord::first),
+	TFC_FieldInfo(NestedRecord::name),
+	TFC_FieldInfo(NestedRecord::second));
+
+TFC_DefineTypeSerializationInfo(VectorRecord,
+	TFC_FieldInfo(VectorRecord::ints),
+	TFC_FieldInfo(VectorRecord::doubles),
+	TFC_FieldInfo(VectorRecord::records));
+
+TFC_DefineTypeSerializationInfo(StringRecord,
+	TFC_FieldInfo(StringRecord::title),
+	TFC_FieldInfo(StringRecord::body));
+
+TFC_DefineTypeSerializationInfo(PredicatedRecord,
+	TFC_FieldInfo(PredicatedRecord::mask),
+	TFC_FieldInfo(PredicatedRecord::label, TFC_BitFieldCheck(PredicatedRecord::mask, 1)),
+	TFC_FieldInfo(PredicatedRecord::counter, TFC_BitFieldCheck(PredicatedRecord::mask, 2)),
+	TFC_FieldInfo(PredicatedRecord::ratio, TFC_BitFieldCheck(PredicatedRecord::mask, 4)));
+
+TFC_DefineDiscriminatedUnionType(EventRecord, kind,
+	TFC_UnionCase(1, EventRecord::code),
+	TFC_UnionCase(2, EventRecord::measurement),
+	TFC_UnionCase(3, EventRecord::tick));
+
+using namespace TFC::Serialization;
+using TFC::ServiceModel::BinarySerializer;
+using TFC::ServiceModel::BinaryDeserializer;
+using TFC::ServiceModel::GVariantSerializer;
+using TFC::ServiceModel::GVariantDeserializer;
+
+namespace {
+
+struct BenchmarkResult
+{
+	std::string name;
+	double nsPerOp;
+	size_t bytesPerOp;
+	double allocsPerOp;
+};
+
+struct BenchmarkBaseline
+{
+	std::string nsPerOp;
+	std::string bytesPerOp;
+	std::string allocsPerOp;
+};
+
+struct BenchmarkOptions
+{
+	std::string baselinePath;
+	std::string resultPath;
+	std::string filter;
+};
+
+BenchmarkOptions options { "res/serialization_baseline.tsv", "serialization_benchmark.tsv", "" };
+std::map<std::string, BenchmarkBaseline> baseline;
+std::vector<BenchmarkResult> results;
+int regressionCount = 0;
+
+bool LoadBaseline(std::string const& path)
+{
+	std::ifstream in(path);
+	if(!in)
+		return false;
+
+	std::string line;
+
+	while(std::getline(in, line))
+	{
+		if(line.empty() || line[0] == '#')
+			continue;
+
+		std::istringstream fields(line);
+		std::string name;
+		BenchmarkBaseline entry;
+
+		if(std::getline(fields, name, '\t') && std::getline(fields, entry.nsPerOp, '\t')
+			&& std::getline(fields, entry.bytesPerOp, '\t') && std::getline(fields, entry.allocsPerOp, '\t'))
+			baseline[name] = entry;
+	}
+
+	return true;
+}
+
+bool WriteResults(std::string const& path)
+{
+	std::ofstream out(path);
+	if(!out)
+		return false;
+
+	out << "# name\tns_per_op\tbytes_per_op\tallocs_per_op\n";
+
+	for(auto& result : results)
+		out << result.name << '\t' << result.nsPerOp << '\t' << result.bytesPerOp << '\t' << result.allocsPerOp << '\n';
+
+	return out.good();
+}
+
+bool Selected(char const* name)
+{
+	return strncmp(name, options.filter.c_str(), options.filter.size()) == 0;
+}
+
+void ReportRegression(char const* name, char const* message)
+{
+	std::cerr << "REGRESSION: " << name << " " << message << '\n';
+	regressionCount++;
+}
+
+// Time may regress by this factor against the baseline before the check fails
+double const timeTolerance = 1.5;
+
+/**
+ * Run the operation repeatedly and record the result. The operation returns the number of bytes
+ * it produced or consumed, which is taken from the warm-up run.
+ */
+template<typename TFunc>
+void Measure(char const* name, int iteration, TFunc func)
+{
+	using Clock = std::chrono::steady_clock;
+
+	if(!Selected(name))
+		return;
+
+	size_t bytes = func();
+
+	size_t allocBefore = allocationCount.load();
+	auto start = Clock::now();
+
+	for(int i = 0; i < iteration; i++)
+		func();
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+	size_t allocs = allocationCount.load() - allocBefore;
+
+	BenchmarkResult result { name, (double)elapsed / iteration, bytes, (double)allocs / iteration };
+	results.push_back(result);
+
+	std::cout << name << ": " << result.nsPerOp << " ns/op, " << result.bytesPerOp << " bytes/op, "
+			  << result.allocsPerOp << " allocs/op\n";
+
+	auto entry = baseline.find(name);
+
+	if(entry == baseline.end())
+		return;
+
+	if(entry->second.nsPerOp != "-" && result.nsPerOp > std::stod(entry->second.nsPerOp) * timeTolerance)
+		ReportRegression(name, "is slower than the baseline");
+
+	if(entry->second.bytesPerOp != "-" && result.bytesPerOp != std::stoul(entry->second.bytesPerOp))
+		ReportRegression(name, "serialized size differs from the baseline");
+
+	if(entry->second.allocsPerOp != "-" && result.allocsPerOp > std::stod(entry->second.allocsPerOp))
+		ReportRegression(name, "allocates more than the baseline");
+}
+
+template<typename T>
+void MeasureBinary(char const* serializeName, char const* deserializeName, int iteration, T const& obj)
+{
+	if(!Selected(serializeName) && !Selected(deserializeName))
+		return;
+
+	Measure(serializeName, iteration, [&] () {
+		return GenericSerializer<BinarySerializer, T>::Serialize(obj).size();
+	});
+
+	auto packed = GenericSerializer<BinarySerializer, T>::Serialize(obj);
+
+	Measure(deserializeName, iteration, [&] () {
+		GenericDeserializer<BinaryDeserializer, T>::Deserialize(packed);
+		return packed.size();
+	});
+}
+
+template<typename T>
+void MeasureGVariant(char const* serializeName, char const* deserializeName, int iteration, T const& obj)
+{
+	if(!Selected(serializeName) && !Selected(deserializeName))
+		return;
+
+	Measure(serializeName, iteration, [&] () {
+		auto packed = g_variant_ref_sink(GenericSerializer<GVariantSerializer, T>::Serialize(obj));
+		size_t size = g_variant_get_size(packed);
+		g_variant_unref(packed);
+		return size;
+	});
+
+	auto packed = g_variant_ref_sink(GenericSerializer<GVariantSerializer, T>::Serialize(obj));
+
+	Measure(deserializeName, iteration, [&] () {
+		// The deserializer releases the reference on finalization
+		GenericDeserializer<GVariantDeserializer, T>::Deserialize(g_variant_ref(packed));
+		return (size_t)g_variant_get_size(packed);
+	});
+
+	g_variant_unref(packed);
+}
+
+FlatRecord MakeFlat(int32_t id)
+{
+	return { id, 0x0F, 1500000000000LL + id, id * 0.25, true };
+}
+
+NestedRecord MakeNested()
+{
+	return { MakeFlat(1), "nested-record", MakeFlat(2) };
+}
+
+VectorRecord MakeVector()
+{
+	VectorRecord ret;
+
+	for(int i = 0; i < 256; i++)
+	{
+		ret.ints.push_back(i * 3);
+		ret.doubles.push_back(i * 0.5);
+	}
+
+	for(int i = 0; i < 16; i++)
+		ret.records.push_back(MakeFlat(i));
+
+	return ret;
+}
+
+StringRecord MakeString()
+{
+	return { std::string(48, 't'), std::string(1024, 'b') };
+}
+
+PredicatedRecord MakePredicated()
+{
+	// Only the label and the ratio are present
+	return { 5, "predicated", 42, 0.75 };
+}
+
+EventRecord MakeEvent()
+{
+	EventRecord ret;
+	ret.kind = 2;
+	ret.measurement = 36.6;
+	return ret;
+}
+
+void RunBinaryChannel()
+{
+	int const iteration = 20000;
+
+	MeasureBinary("binary.flat.serialize", "binary.flat.deserialize", iteration, MakeFlat(1));
+	MeasureBinary("binary.nested.serialize", "binary.nested.deserialize", iteration, MakeNested());
+	MeasureBinary("binary.vector.serialize", "binary.vector.deserialize", iteration / 10, MakeVector());
+	MeasureBinary("binary.string.serialize", "binary.string.deserialize", iteration, MakeString());
+	MeasureBinary("binary.predicated.serialize", "binary.predicated.deserialize", iteration, MakePredicated());
+}
+
+void RunGVariantChannel()
+{
+	int const iteration = 5000;
+
+	MeasureGVariant("gvariant.flat.serialize", "gvariant.flat.deserialize", iteration, MakeFlat(1));
+	MeasureGVariant("gvariant.nested.serialize", "gvariant.nested.deserialize", iteration, MakeNested());
+	MeasureGVariant("gvariant.vector.serialize", "gvariant.vector.deserialize", iteration / 10, MakeVector());
+	MeasureGVariant("gvariant.string.serialize", "gvariant.string.deserialize", iteration, MakeString());
+	MeasureGVariant("gvariant.predicated.serialize", "gvariant.predicated.deserialize", iteration, MakePredicated());
+}
+
+void RunTableClassSerializer()
+{
+	int const iteration = 20000;
+	auto nested = MakeNested();
+
+	Measure("table.nested.serialize", iteration, [&] () {
+		return TableClassSerializer<BinarySerializer, NestedRecord>::Serialize(nested).size();
+	});
+
+	auto packed = TableClassSerializer<BinarySerializer, NestedRecord>::Serialize(nested);
+
+	Measure("table.nested.deserialize", iteration, [&] () {
+		TableClassDeserializer<BinaryDeserializer, NestedRecord>::Deserialize(packed);
+		return packed.size();
+	});
+}
+
+void RunDiscriminatedUnionSerializer()
+{
+	int const iteration = 20000;
+
+	MeasureBinary("binary.union.serialize", "binary.union.deserialize", iteration, MakeEvent());
+	MeasureGVariant("gvariant.union.serialize", "gvariant.union.deserialize", iteration / 4, MakeEvent());
+}
+
+void RunParameterSerializer()
+{
+	typedef decltype(&IBenchmarkService::Submit) SubmitFunc;
+	int const iteration = 20000;
+	std::string name("parameter");
+	std::vector<int32_t> samples { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+	Measure("binary.parameter.serialize", iteration, [&] () {
+		return ParameterSerializer<BinarySerializer, SubmitFunc>::Serialize(7, name, 2.5, samples).size();
+	});
+
+	auto binaryPacked = ParameterSerializer<BinarySerializer, SubmitFunc>::Serialize(7, name, 2.5, samples);
+
+	Measure("binary.parameter.deserialize", iteration, [&] () {
+		ParameterDeserializer<BinaryDeserializer, SubmitFunc>::Deserialize(binaryPacked);
+		return binaryPacked.size();
+	});
+
+	if(!Selected("gvariant.parameter."))
+		return;
+
+	Measure("gvariant.parameter.serialize", iteration / 4, [&] () {
+		auto packed = g_variant_ref_sink(ParameterSerializer<GVariantSerializer, SubmitFunc>::Serialize(7, name, 2.5, samples));
+		size_t size = g_variant_get_size(packed);
+		g_variant_unref(packed);
+		return size;
+	});
+
+	auto gvariantPacked = g_variant_ref_sink(ParameterSerializer<GVariantSerializer, SubmitFunc>::Serialize(7, name, 2.5, samples));
+
+	Measure("gvariant.parameter.deserialize", iteration / 4, [&] () {
+		ParameterDeserializer<GVariantDeserializer, SubmitFunc>::Deserialize(gvariantPacked, false);
+		return (size_t)g_variant_get_size(gvariantPacked);
+	});
+
+	g_variant_unref(gvariantPacked);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	int option;
+
+	while((option = getopt(argc, argv, "b:o:f:")) != -1)
+	{
+		switch(option)
+		{
+		case 'b': options.baselinePath = optarg; break;
+		case 'o': options.resultPath = optarg; break;
+		case 'f': options.filter = optarg; break;
+		default:
+			std::cerr << "Usage: " << argv[0] << " [-b baseline.tsv] [-o result.tsv] [-f scenario-prefix]\n";
+			return 2;
+		}
+	}
+
+	if(!LoadBaseline(options.baselinePath))
+		std::cerr << "Baseline " << options.baselinePath << " is not found, results are not checked\n";
+
+	RunBinaryChannel();
+	RunGVariantChannel();
+	RunTableClassSerializer();
+	RunDiscriminatedUnionSerializer();
+	RunParameterSerializer();
+
+	if(!WriteResults(options.resultPath))
+	{
+		std::cerr << "Cannot write benchmark result to " << options.resultPath << '\n';
+		return 2;
+	}
+
+	std::cout << "Benchmark result is written to " << options.resultPath << '\n';
+
+	if(regressionCount > 0)
+	{
+		std::cerr << regressionCount << " regressions against the baseline\n";
+		return 1;
+	}
+
+	return 0;
+}
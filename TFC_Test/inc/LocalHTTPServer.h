@@ -0,0 +1,280 @@
+/*
+ * LocalHTTPServer.h
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Minimal HTTP/1.1 server on the loopback interface, which stands in for the remote server in the
+ * REST tests. Each connection is served by its own thread and kept alive until the client closes
+ * it, or until the response contains "Connection: close".
+ */
+
+#ifndef __LocalHTTPServer_H__
+#define __LocalHTTPServer_H__
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class LocalHTTPServer
+{
+public:
+	struct Request
+	{
+		std::string method;
+		std::string target;
+
+		// Header names are converted to lower case
+		std::map<std::string, std::string> headers;
+		std::string body;
+	};
+
+	struct Response
+	{
+		int status;
+		std::vector<std::pair<std::string, std::string>> headers;
+		std::string body;
+	};
+
+	typedef std::function<Response(Request const&)> Handler;
+
+	LocalHTTPServer(Handler handler) :
+		handler(std::move(handler)), port(0), running(true), connectionCount(0), requestCount(0)
+	{
+		listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+
+		int reuse = 1;
+		setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+		sockaddr_in address {};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = 0;
+
+		bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+		listen(listenSocket, 64);
+
+		socklen_t length = sizeof(address);
+		getsockname(listenSocket, reinterpret_cast<sockaddr*>(&address), &length);
+		port = ntohs(address.sin_port);
+
+		acceptThread = std::thread([this] { AcceptLoop(); });
+	}
+
+	~LocalHTTPServer()
+	{
+		running = false;
+		shutdown(listenSocket, SHUT_RDWR);
+		close(listenSocket);
+		acceptThread.join();
+
+		std::vector<std::thread> threads;
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			for(auto fd : clientSockets)
+				shutdown(fd, SHUT_RDWR);
+			threads.swap(clientThreads);
+		}
+
+		for(auto& thread : threads)
+			thread.join();
+	}
+
+	std::string GetBaseUrl() const
+	{
+		return "http://127.0.0.1:" + std::to_string(port);
+	}
+
+	/**
+	 * Number of TCP connections accepted by the server.
+	 */
+	int GetConnectionCount() const { return connectionCount; }
+
+	/**
+	 * Number of requests served by the server.
+	 */
+	int GetRequestCount() const { return requestCount; }
+
+private:
+	void AcceptLoop()
+	{
+		while(running)
+		{
+			int fd = accept(listenSocket, nullptr, nullptr);
+			if(fd < 0)
+				break;
+
+			connectionCount++;
+
+			std::lock_guard<std::mutex> guard(lock);
+			clientSockets.push_back(fd);
+			clientThreads.emplace_back([this, fd] { Serve(fd); });
+		}
+	}
+
+	void Serve(int fd)
+	{
+		std::string buffer;
+		Request request;
+
+		while(ReadRequest(fd, buffer, request))
+		{
+			requestCount++;
+
+			auto response = handler(request);
+			bool closeConnection = false;
+
+			std::string output = "HTTP/1.1 " + std::to_string(response.status) + " " + GetReason(response.status) + "\r\n";
+			bool hasLength = false;
+
+			for(auto& header : response.headers)
+			{
+				output += header.first + ": " + header.second + "\r\n";
+
+				auto name = ToLower(header.first);
+				hasLength |= name == "content-length";
+				closeConnection |= name == "connection" && header.second == "close";
+			}
+
+			// Response to HEAD and 304 response do not have a body
+			bool bodyless = response.status == 304 || response.status == 204 || request.method == "HEAD";
+
+			if(!hasLength && !bodyless)
+				output += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+
+			output += "\r\n";
+
+			if(!bodyless)
+				output += response.body;
+
+			if(!WriteAll(fd, output) || closeConnection)
+				break;
+		}
+
+		std::lock_guard<std::mutex> guard(lock);
+		clientSockets.erase(std::remove(clientSockets.begin(), clientSockets.end(), fd), clientSockets.end());
+		close(fd);
+	}
+
+	static bool ReadMore(int fd, std::string& buffer)
+	{
+		char chunk[16384];
+		auto received = recv(fd, chunk, sizeof(chunk), 0);
+
+		if(received <= 0)
+			return false;
+
+		buffer.append(chunk, received);
+		return true;
+	}
+
+	static bool ReadRequest(int fd, std::string& buffer, Request& request)
+	{
+		size_t headerEnd;
+		while((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos)
+		{
+			if(!ReadMore(fd, buffer))
+				return false;
+		}
+
+		request = Request();
+
+		auto lineEnd = buffer.find("\r\n");
+		auto requestLine = buffer.substr(0, lineEnd);
+		auto methodEnd = requestLine.find(' ');
+		auto targetEnd = requestLine.find(' ', methodEnd + 1);
+		request.method = requestLine.substr(0, methodEnd);
+		request.target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+
+		auto position = lineEnd + 2;
+		while(position < headerEnd)
+		{
+			lineEnd = buffer.find("\r\n", position);
+			auto line = buffer.substr(position, lineEnd - position);
+			auto separator = line.find(':');
+
+			if(separator != std::string::npos)
+			{
+				auto valueStart = line.find_first_not_of(' ', separator + 1);
+				request.headers[ToLower(line.substr(0, separator))] =
+					valueStart == std::string::npos ? std::string() : line.substr(valueStart);
+			}
+
+			position = lineEnd + 2;
+		}
+
+		size_t contentLength = 0;
+		auto lengthHeader = request.headers.find("content-length");
+		if(lengthHeader != request.headers.end())
+			contentLength = std::strtoul(lengthHeader->second.c_str(), nullptr, 10);
+
+		auto bodyStart = headerEnd + 4;
+		while(buffer.size() < bodyStart + contentLength)
+		{
+			if(!ReadMore(fd, buffer))
+				return false;
+		}
+
+		request.body = buffer.substr(bodyStart, contentLength);
+		buffer.erase(0, bodyStart + contentLength);
+		return true;
+	}
+
+	static bool WriteAll(int fd, std::string const& data)
+	{
+		size_t written = 0;
+		while(written < data.size())
+		{
+			auto sent = send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+			if(sent <= 0)
+				return false;
+
+			written += sent;
+		}
+		return true;
+	}
+
+	static std::string ToLower(std::string value)
+	{
+		std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+		return value;
+	}
+
+	static char const* GetReason(int status)
+	{
+		switch(status)
+		{
+		case 200: return "OK";
+		case 204: return "No Content";
+		case 304: return "Not Modified";
+		case 404: return "Not Found";
+		case 503: return "Service Unavailable";
+		default: return status < 400 ? "OK" : "Error";
+		}
+	}
+
+	Handler handler;
+	int listenSocket;
+	int port;
+	std::atomic<bool> running;
+	std::atomic<int> connectionCount;
+	std::atomic<int> requestCount;
+
+	std::thread acceptThread;
+	std::mutex lock;
+	std::vector<int> clientSockets;
+	std::vector<std::thread> clientThreads;
+};
+
+#endif /* __LocalHTTPServer_H__ */
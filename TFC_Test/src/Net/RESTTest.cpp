@@ -6,14 +6,27 @@
  */
 
 #include "TFC/Net/REST.h"
+#include "TFC/Net/RequestPolicy.h"
+#include "TFC/Net/ResponseCache.h"
+#include "TFC/Net/RESTStatistics.h"
+#include "TFC/Net/Util.h"
 #include "TFC/Async.h"
 #include "TFC_Test.h"
+#include "LocalHTTPServer.h"
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <mutex>
 #include <chrono>
 #include <thread>
 #include <fstream>
+#include <iostream>
+#include <regex>
+#include <zlib.h>
+#include <cstdlib>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 class RESTTest : public testing::Test
 {
@@ -182,3 +195,889 @@ TEST_F(RESTTest, RESTAsyncTest)
 		EXPECT_EQ(buffer.str(), tc.result);
 	}
 }
+
+class LocalService : public TFC::Net::RESTServiceBase<std::string>
+{
+public:
+	LocalService(std::string const& url, TFC::Net::HTTPMode mode = TFC::Net::HTTPMode::Get) :
+		RESTServiceBase(url, mode)
+	{
+	}
+
+	using RESTServiceBase::Cache;
+	using RESTServiceBase::Policy;
+	using RESTServiceBase::Statistics;
+protected:
+	virtual std::string* OnProcessResponse(int httpCode, const std::string& responseStr, int& errorCode, std::string& errorMessage)
+	{
+		return new std::string(responseStr);
+	}
+};
+
+struct AsyncResult
+{
+	int httpCode;
+	std::string response;
+};
+
+/*
+ * Call every service with CallAsync on the main loop, and wait until every call completes. The
+ * services are destroyed on the main loop afterwards. If the wait times out, the services are
+ * leaked, as the transfers in progress still refer to them.
+ */
+bool CallAllAsync(std::vector<std::unique_ptr<LocalService>> services, std::vector<AsyncResult>& results,
+	std::chrono::milliseconds timeout)
+{
+	struct SharedData
+	{
+		std::vector<std::unique_ptr<LocalService>> services;
+		std::vector<AsyncResult> results;
+		std::atomic<int> completed;
+		std::timed_mutex mutexDone;
+
+		SharedData(std::vector<std::unique_ptr<LocalService>> services) :
+			services(std::move(services)), results(this->services.size()), completed(0) { }
+	};
+
+	if(services.empty())
+		return true;
+
+	std::unique_ptr<SharedData> sharedPtr(new SharedData(std::move(services)));
+	auto& shared = *sharedPtr;
+	shared.mutexDone.lock();
+
+	EFL_BLOCK_BEGIN;
+		EFL_SYNC_BEGIN(shared);
+
+			int count = shared.services.size();
+			for(int i = 0; i < count; i++)
+			{
+				shared.services[i]->CallAsync([&shared, i, count] (TFC::Net::RESTResult<std::string> result) {
+					std::string* response = result.Response;
+					shared.results[i] = { result.httpCode, response ? *response : std::string() };
+					delete response;
+
+					if(++shared.completed == count)
+						shared.mutexDone.unlock();
+				});
+			}
+
+		EFL_SYNC_END;
+	EFL_BLOCK_END;
+
+	if(!shared.mutexDone.try_lock_for(timeout))
+	{
+		sharedPtr.release();
+		return false;
+	}
+
+	results = std::move(shared.results);
+
+	EFL_BLOCK_BEGIN;
+		EFL_SYNC_BEGIN(shared);
+			shared.services.clear();
+		EFL_SYNC_END;
+	EFL_BLOCK_END;
+
+	return true;
+}
+
+TEST_F(RESTTest, RESTConnectionReuseTest)
+{
+	int const callCount = 20;
+
+	LocalHTTPServer keepAliveServer([] (LocalHTTPServer::Request const& request) {
+		return LocalHTTPServer::Response { 200, { }, "keep-alive" };
+	});
+
+	LocalHTTPServer closingServer([] (LocalHTTPServer::Request const& request) {
+		return LocalHTTPServer::Response { 200, { { "Connection", "close" } }, "close" };
+	});
+
+	auto call = [&] (LocalHTTPServer& server, char const* expected) {
+		for(int i = 0; i < callCount; i++)
+		{
+			LocalService service(server.GetBaseUrl() + "/resource");
+			auto result = service.Call();
+			std::string* response = result.Response;
+
+			EXPECT_EQ(200, result.httpCode);
+			if(response)
+				EXPECT_EQ(expected, *response);
+			delete response;
+		}
+	};
+
+	call(keepAliveServer, "keep-alive");
+	call(closingServer, "close");
+
+	EXPECT_EQ(1, keepAliveServer.GetConnectionCount()) << "Connection is not reused between calls";
+	EXPECT_EQ(callCount, closingServer.GetConnectionCount()) << "Closed connection is reused";
+}
+
+TEST_F(RESTTest, RESTConcurrentEngineTest)
+{
+	using Ms = std::chrono::milliseconds;
+	int const requestCount = 100;
+
+	// Every response is delayed, so the requests overlap at the server if they run concurrently
+	std::atomic<int> inFlight(0);
+	std::atomic<int> maxInFlight(0);
+
+	LocalHTTPServer server([&] (LocalHTTPServer::Request const& request) {
+		int current = ++inFlight;
+		for(int seen = maxInFlight; current > seen && !maxInFlight.compare_exchange_weak(seen, current); )
+			;
+
+		std::this_thread::sleep_for(Ms(200));
+		inFlight--;
+		return LocalHTTPServer::Response { 200, { }, request.target };
+	});
+
+	std::vector<std::unique_ptr<LocalService>> services;
+	for(int i = 0; i < requestCount; i++)
+		services.emplace_back(new LocalService(server.GetBaseUrl() + "/item/" + std::to_string(i)));
+
+	std::vector<AsyncResult> results;
+	ASSERT_TRUE(CallAllAsync(std::move(services), results, Ms(20000))) << "Asynchronous wait timeout";
+
+	for(int i = 0; i < requestCount; i++)
+		EXPECT_EQ("/item/" + std::to_string(i), results[i].response) << "Response of request " << i << " is incorrect";
+
+	EXPECT_LT(1, maxInFlight.load()) << "Requests are not performed concurrently";
+}
+
+class StreamingService : public TFC::Net::RESTServiceBase<std::string>
+{
+public:
+	size_t chunkCount;
+	size_t receivedLength;
+	size_t abortAfter;
+	int chunkHttpCode;
+	char mismatch;
+
+	StreamingService(std::string const& url) :
+		RESTServiceBase(url, TFC::Net::HTTPMode::Get),
+		chunkCount(0), receivedLength(0), abortAfter(0), chunkHttpCode(0), mismatch(0)
+	{
+		StreamResponse = true;
+	}
+protected:
+	virtual bool OnResponseChunk(int httpCode, char const* data, size_t length) override
+	{
+		chunkHttpCode = httpCode;
+
+		// Body is a repeated alphabet, so every byte can be verified by its offset
+		for(size_t i = 0; i < length; i++)
+		{
+			if(data[i] != 'a' + (receivedLength + i) % 26)
+				mismatch = 1;
+		}
+
+		chunkCount++;
+		receivedLength += length;
+		return abortAfter == 0 || chunkCount < abortAfter;
+	}
+
+	virtual std::string* OnProcessResponse(int httpCode, const std::string& responseStr, int& errorCode, std::string& errorMessage)
+	{
+		return new std::string(responseStr);
+	}
+};
+
+TEST_F(RESTTest, RESTStreamingResponseTest)
+{
+	size_t const bodyLength = 4 * 1024 * 1024;
+
+	LocalHTTPServer server([&] (LocalHTTPServer::Request const& request) {
+		std::string body(bodyLength, '\0');
+		for(size_t i = 0; i < bodyLength; i++)
+			body[i] = 'a' + i % 26;
+
+		return LocalHTTPServer::Response { 200, { }, std::move(body) };
+	});
+
+	StreamingService service(server.GetBaseUrl() + "/feed");
+	auto result = service.Call();
+	std::string* response = result.Response;
+
+	EXPECT_EQ(TFC::Net::ResultType::OK, result.resultType);
+	EXPECT_EQ(200, service.chunkHttpCode) << "HTTP code is not available while streaming";
+	EXPECT_EQ(bodyLength, service.receivedLength) << "Streamed body length is incorrect";
+	EXPECT_LT(1u, service.chunkCount) << "Body is not streamed in chunks";
+	EXPECT_EQ(0, service.mismatch) << "Streamed body is corrupted";
+
+	ASSERT_NE(nullptr, response);
+	EXPECT_TRUE(response->empty()) << "Streamed body is buffered";
+	delete response;
+
+	// Returning false from the chunk handler aborts the request
+	StreamingService abortedService(server.GetBaseUrl() + "/feed");
+	abortedService.abortAfter = 1;
+	auto abortedResult = abortedService.Call();
+
+	EXPECT_EQ(TFC::Net::ResultType::LocalError, abortedResult.resultType) << "Request is not aborted";
+	EXPECT_EQ(1u, abortedService.chunkCount) << "Chunk is received after the request is aborted";
+}
+
+class CachedGetService : public LocalService
+{
+public:
+	CachedGetService(std::string const& url, TFC::Net::ResponseCache& cache) :
+		LocalService(url)
+	{
+		Cache = &cache;
+	}
+};
+
+class AuthorizedGetService : public CachedGetService
+{
+public:
+	Parameter<TFC::Net::ParameterType::Header, std::string> Authorization;
+
+	AuthorizedGetService(std::string const& url, TFC::Net::ResponseCache& cache) :
+		CachedGetService(url, cache),
+		Authorization(this, "Authorization")
+	{
+		Authorization = "Bearer secret";
+	}
+};
+
+TEST_F(RESTTest, RESTResponseCacheTest)
+{
+	std::atomic<int> maxAge(0);
+	std::atomic<int> notModifiedCount(0);
+
+	LocalHTTPServer server([&] (LocalHTTPServer::Request const& request) {
+		std::vector<std::pair<std::string, std::string>> headers {
+			{ "ETag", "\"v1\"" },
+			{ "Cache-Control", "max-age=" + std::to_string(maxAge.load()) }
+		};
+
+		auto validator = request.headers.find("if-none-match");
+		if(validator != request.headers.end() && validator->second == "\"v1\"")
+		{
+			notModifiedCount++;
+			return LocalHTTPServer::Response { 304, std::move(headers), "" };
+		}
+
+		return LocalHTTPServer::Response { 200, std::move(headers), "cached body" };
+	});
+
+	char storagePath[] = "/tmp/RESTResponseCacheTestXXXXXX";
+	ASSERT_NE(nullptr, mkdtemp(storagePath));
+
+	auto getStoredFiles = [&storagePath] {
+		std::vector<std::string> paths;
+		std::unique_ptr<DIR, int(*)(DIR*)> files(opendir(storagePath), closedir);
+
+		while(auto file = files ? readdir(files.get()) : nullptr)
+		{
+			if(file->d_name[0] != '.')
+				paths.push_back(std::string(storagePath) + "/" + file->d_name);
+		}
+
+		return paths;
+	};
+
+	auto getInode = [] (std::string const& path) {
+		struct stat st = { 0 };
+		stat(path.c_str(), &st);
+		return st.st_ino;
+	};
+
+	auto call = [&] (TFC::Net::ResponseCache& cache) {
+		CachedGetService service(server.GetBaseUrl() + "/resource?token=secret", cache);
+		auto result = service.Call();
+		std::string* response = result.Response;
+
+		EXPECT_EQ(200, result.httpCode);
+		EXPECT_NE(nullptr, response);
+		if(response)
+			EXPECT_EQ("cached body", *response);
+		delete response;
+	};
+
+	{
+		TFC::Net::ResponseCache cache(16, storagePath);
+
+		// Response which expires immediately is stored, as it can be validated with its ETag
+		call(cache);
+		EXPECT_EQ(1, server.GetRequestCount());
+
+		auto storedFiles = getStoredFiles();
+		ASSERT_EQ(1u, storedFiles.size());
+		auto storedInode = getInode(storedFiles[0]);
+
+		// Stale response is validated, and served again from the cache
+		maxAge = 60;
+		call(cache);
+		EXPECT_EQ(2, server.GetRequestCount());
+		EXPECT_EQ(1, notModifiedCount) << "Stale response is not validated";
+		EXPECT_EQ(storedInode, getInode(storedFiles[0])) << "Validated response is written again to the storage";
+
+		// Fresh response is served without contacting the server
+		call(cache);
+		EXPECT_EQ(2, server.GetRequestCount()) << "Fresh response is requested again";
+
+		auto statistics = cache.GetStatistics();
+		EXPECT_EQ(1u, statistics.hits);
+		EXPECT_EQ(1u, statistics.revalidations);
+		EXPECT_EQ(1u, statistics.misses);
+	}
+
+	{
+		// Response persisted by the previous cache is still fresh
+		TFC::Net::ResponseCache cache(16, storagePath);
+		call(cache);
+		EXPECT_EQ(2, server.GetRequestCount()) << "Response is not persisted in the storage";
+		EXPECT_EQ(1u, cache.GetStatistics().hits);
+	}
+
+	// Storage does not contain the URL, and a truncated file is a miss which is removed
+	auto paths = getStoredFiles();
+	ASSERT_EQ(1u, paths.size()) << "Response is not stored in one file";
+
+	std::ifstream stored(paths[0], std::ios::binary);
+	std::string content { std::istreambuf_iterator<char>(stored), std::istreambuf_iterator<char>() };
+	EXPECT_EQ(std::string::npos, content.find("secret")) << "URL with the token is written to the storage";
+	EXPECT_NE(std::string::npos, content.find("cached body"));
+	ASSERT_EQ(0, truncate(paths[0].c_str(), content.size() - 4));
+
+	{
+		TFC::Net::ResponseCache cache(16, storagePath);
+		call(cache);
+		EXPECT_EQ(3, server.GetRequestCount()) << "Truncated response is served from the storage";
+		EXPECT_EQ(1u, cache.GetStatistics().misses);
+
+		// Request with credentials is never cached
+		for(int i = 0; i < 2; i++)
+		{
+			AuthorizedGetService service(server.GetBaseUrl() + "/private", cache);
+			auto result = service.Call();
+			std::string* response = result.Response;
+			delete response;
+		}
+
+		EXPECT_EQ(5, server.GetRequestCount()) << "Response of a request with credentials is cached";
+		EXPECT_EQ(1u, cache.GetStatistics().misses);
+	}
+
+	{
+		// Storage is bounded, and the file which is just written is kept
+		TFC::Net::ResponseCache cache(1, storagePath, 2500);
+		TFC::Net::CachedResponse response { 200, std::string(1000, 'x'), "", "",
+			std::chrono::system_clock::now() + std::chrono::seconds(60) };
+
+		for(int i = 0; i < 4; i++)
+			cache.Store("key" + std::to_string(i), response);
+
+		auto files = getStoredFiles();
+		EXPECT_EQ(2u, files.size()) << "Storage exceeds its maximum size";
+
+		TFC::Net::ResponseCache other(16, storagePath);
+		EXPECT_NE(nullptr, other.Lookup("key3")) << "File which is just written is removed";
+	}
+
+	{
+		// Files written by the previous caches are removed as well
+		TFC::Net::ResponseCache cache(16, storagePath);
+		cache.Clear();
+		EXPECT_TRUE(getStoredFiles().empty()) << "Storage is not cleared";
+	}
+
+	rmdir(storagePath);
+}
+
+TEST_F(RESTTest, RESTRequestCoalescingTest)
+{
+	using Ms = std::chrono::milliseconds;
+	int const callerCount = 8;
+
+	LocalHTTPServer server([] (LocalHTTPServer::Request const& request) {
+		std::this_thread::sleep_for(Ms(300));
+		return LocalHTTPServer::Response { 200, { }, "profile" };
+	});
+
+	auto url = server.GetBaseUrl() + "/profile";
+
+	// Blocking calls from several threads share one transfer
+	std::vector<std::thread> callers;
+	std::atomic<int> correctResponses(0);
+
+	for(int i = 0; i < callerCount; i++)
+	{
+		callers.emplace_back([&] {
+			LocalService service(url);
+			auto result = service.Call();
+			std::string* response = result.Response;
+
+			if(result.httpCode == 200 && response && *response == "profile")
+				correctResponses++;
+			delete response;
+		});
+	}
+
+	for(auto& caller : callers)
+		caller.join();
+
+	EXPECT_EQ(callerCount, correctResponses.load());
+	EXPECT_EQ(1, server.GetRequestCount()) << "Identical blocking calls are not coalesced";
+
+	// Asynchronous calls on the main loop share one transfer
+	std::vector<std::unique_ptr<LocalService>> services;
+	for(int i = 0; i < callerCount; i++)
+		services.emplace_back(new LocalService(url));
+
+	std::vector<AsyncResult> results;
+	ASSERT_TRUE(CallAllAsync(std::move(services), results, Ms(10000))) << "Asynchronous wait timeout";
+
+	for(auto& result : results)
+	{
+		EXPECT_EQ(200, result.httpCode);
+		EXPECT_EQ("profile", result.response);
+	}
+
+	EXPECT_EQ(2, server.GetRequestCount()) << "Identical asynchronous calls are not coalesced";
+}
+
+class UrlTemplateService : public TFC::Net::RESTServiceBase<std::string>
+{
+public:
+	Parameter<TFC::Net::ParameterType::URL, std::string> UserId;
+	Parameter<TFC::Net::ParameterType::URL, int> PostId;
+
+	UrlTemplateService(std::string const& url) :
+		RESTServiceBase(url, TFC::Net::HTTPMode::Get),
+		UserId(this, "user_id"),
+		PostId(this, "postId")
+	{
+	}
+
+	std::string BuildUrl()
+	{
+		return PrepareUrl();
+	}
+
+	// Regex based implementation which is replaced by the parsed template
+	std::string BuildUrlWithRegex()
+	{
+		std::stringstream urlBuffer;
+		std::regex urlRegex(R"REGEX((\{([A-Za-z0-9_]+)\}))REGEX");
+
+		auto lastToken = Url.cbegin();
+		for(std::sregex_iterator i(Url.begin(), Url.end(), urlRegex), end; i != end; ++i)
+		{
+			std::smatch match = *i;
+			urlBuffer << std::string(lastToken, match[1].first);
+			lastToken = match[1].second;
+			urlBuffer << urlParam.find(match[2].str())->second->GetEncodedValue();
+		}
+
+		urlBuffer << std::string(lastToken, Url.cend());
+		return urlBuffer.str();
+	}
+protected:
+	virtual std::string* OnProcessResponse(int httpCode, const std::string& responseStr, int& errorCode, std::string& errorMessage)
+	{
+		return new std::string(responseStr);
+	}
+};
+
+TEST_F(RESTTest, RESTUrlTemplateTest)
+{
+	UrlTemplateService service("https://example.com/users/{user_id}/posts/{postId}/{not-a-param}/{}?x={");
+
+	EXPECT_THROW(service.BuildUrl(), std::runtime_error) << "Unset parameter is not reported";
+
+	service.UserId = "john";
+	service.PostId = 42;
+
+	EXPECT_EQ("https://example.com/users/john/posts/42/{not-a-param}/{}?x={", service.BuildUrl());
+	EXPECT_EQ(service.BuildUrlWithRegex(), service.BuildUrl());
+
+	UrlTemplateService literalService("https://example.com/plain");
+	EXPECT_EQ("https://example.com/plain", literalService.BuildUrl());
+}
+
+class FormPostService : public TFC::Net::RESTServiceBase<std::string>
+{
+public:
+	Parameter<TFC::Net::ParameterType::PostData, std::string> Title;
+	Parameter<TFC::Net::ParameterType::PostData, std::string> Body;
+
+	FormPostService() :
+		RESTServiceBase("http://127.0.0.1/posts", TFC::Net::HTTPMode::Post),
+		Title(this, "title"),
+		Body(this, "body")
+	{
+	}
+
+	std::string BuildPostData()
+	{
+		return PreparePostData(postDataParam);
+	}
+protected:
+	virtual std::string* OnProcessResponse(int httpCode, const std::string& responseStr, int& errorCode, std::string& errorMessage)
+	{
+		return new std::string(responseStr);
+	}
+};
+
+TEST_F(RESTTest, RESTPercentEncodingTest)
+{
+	// Unreserved characters of RFC 3986 are kept
+	EXPECT_EQ("AZaz09-._~", TFC::Net::PercentEncode("AZaz09-._~"));
+
+	// Reserved characters are encoded with two uppercase digits
+	EXPECT_EQ("%20%21%2A%2F%3D%26%0A%00", TFC::Net::PercentEncode(std::string(" !*/=&\n\0", 8)));
+
+	// UTF-8 bytes are encoded without sign extension
+	EXPECT_EQ("caf%C3%A9%20%E2%82%AC", TFC::Net::PercentEncode("caf\xC3\xA9 \xE2\x82\xAC"));
+
+	std::string output = "key=";
+	TFC::Net::PercentEncode(output, "a b", 3);
+	EXPECT_EQ("key=a%20b", output);
+
+	// Post data uses the same encoder, and the parameter which is not set is skipped
+	FormPostService service;
+	service.Title = "caf\xC3\xA9 & more";
+	EXPECT_EQ("title=caf%C3%A9%20%26%20more", service.BuildPostData());
+}
+
+TEST_F(RESTTest, RESTRequestPolicyTest)
+{
+	using Ms = std::chrono::milliseconds;
+	using Clock = std::chrono::steady_clock;
+
+	std::mutex countLock;
+	std::map<std::string, int> requestCounts;
+
+	// Flaky resources fail twice, and stalled resources stall the first request only
+	LocalHTTPServer server([&] (LocalHTTPServer::Request const& request) {
+		int count;
+		{
+			std::lock_guard<std::mutex> guard(countLock);
+			count = ++requestCounts[request.target];
+		}
+
+		if(request.target.find("/flaky") == 0 && count <= 2)
+			return LocalHTTPServer::Response { 503, { }, "unavailable" };
+
+		if(request.target.find("/stall") == 0 && count == 1)
+			std::this_thread::sleep_for(Ms(1500));
+
+		if(request.target == "/timeout")
+			std::this_thread::sleep_for(Ms(1000));
+
+		return LocalHTTPServer::Response { 200, { }, request.target };
+	});
+
+	auto getCount = [&] (std::string const& target) {
+		std::lock_guard<std::mutex> guard(countLock);
+		return requestCounts[target];
+	};
+
+	TFC::Net::RequestPolicy retryPolicy;
+	retryPolicy.MaxRetries = 3;
+	retryPolicy.BaseBackoff = Ms(10);
+
+	// Idempotent request is retried until it succeeds
+	{
+		LocalService service(server.GetBaseUrl() + "/flaky");
+		service.Policy = &retryPolicy;
+		auto result = service.Call();
+		std::string* response = result.Response;
+
+		EXPECT_EQ(200, result.httpCode);
+		EXPECT_EQ(3, getCount("/flaky"));
+		EXPECT_EQ(2u, retryPolicy.GetStatistics().retries);
+		delete response;
+	}
+
+	// POST is not retried
+	{
+		LocalService service(server.GetBaseUrl() + "/flaky-post", TFC::Net::HTTPMode::Post);
+		service.Policy = &retryPolicy;
+		auto result = service.Call();
+		std::string* response = result.Response;
+
+		EXPECT_EQ(503, result.httpCode);
+		EXPECT_EQ(1, getCount("/flaky-post")) << "Non idempotent request is retried";
+		delete response;
+	}
+
+	// Stalled request is aborted by the total timeout, and retried once
+	{
+		TFC::Net::RequestPolicy timeoutPolicy;
+		timeoutPolicy.TotalTimeout = Ms(100);
+		timeoutPolicy.MaxRetries = 1;
+		timeoutPolicy.BaseBackoff = Ms(10);
+
+		LocalService service(server.GetBaseUrl() + "/timeout");
+		service.Policy = &timeoutPolicy;
+
+		auto start = Clock::now();
+		auto result = service.Call();
+		auto elapsed = std::chrono::duration_cast<Ms>(Clock::now() - start).count();
+
+		EXPECT_EQ(TFC::Net::ResultType::LocalError, result.resultType);
+		EXPECT_EQ(2, getCount("/timeout"));
+		EXPECT_GT(800, elapsed) << "Request is not aborted by the timeout";
+	}
+
+	// Request slower than the latency percentile is hedged by a duplicate request
+	TFC::Net::RequestPolicy hedgePolicy;
+	hedgePolicy.HedgePercentile = 0.9;
+	hedgePolicy.MinHedgeDelay = Ms(50);
+	hedgePolicy.MinHedgeSamples = 20;
+
+	for(int i = 0; i < 20; i++)
+	{
+		LocalService service(server.GetBaseUrl() + "/fast");
+		service.Policy = &hedgePolicy;
+		auto result = service.Call();
+		std::string* response = result.Response;
+		delete response;
+	}
+
+	{
+		LocalService service(server.GetBaseUrl() + "/stall");
+		service.Policy = &hedgePolicy;
+
+		auto start = Clock::now();
+		auto result = service.Call();
+		auto elapsed = std::chrono::duration_cast<Ms>(Clock::now() - start).count();
+		std::string* response = result.Response;
+
+		EXPECT_EQ(200, result.httpCode);
+		ASSERT_NE(nullptr, response);
+		EXPECT_EQ("/stall", *response);
+		EXPECT_GT(1000, elapsed) << "Stalled request is not hedged";
+		delete response;
+
+		auto statistics = hedgePolicy.GetStatistics();
+		EXPECT_EQ(1u, statistics.hedges);
+		EXPECT_EQ(1u, statistics.hedgeWins);
+		EXPECT_EQ(21u, statistics.transfers);
+		EXPECT_GE(statistics.p99, statistics.p50);
+
+		std::cout << "Latency p50: " << statistics.p50.count() << " us, p99: " << statistics.p99.count() << " us\n";
+	}
+
+	// Engine retries and hedges the asynchronous requests in the same way
+	std::vector<std::unique_ptr<LocalService>> services;
+	services.emplace_back(new LocalService(server.GetBaseUrl() + "/flaky-async"));
+	services.back()->Policy = &retryPolicy;
+	services.emplace_back(new LocalService(server.GetBaseUrl() + "/stall-async"));
+	services.back()->Policy = &hedgePolicy;
+
+	auto start = Clock::now();
+
+	std::vector<AsyncResult> results;
+	ASSERT_TRUE(CallAllAsync(std::move(services), results, Ms(10000))) << "Asynchronous wait timeout";
+
+	auto elapsed = std::chrono::duration_cast<Ms>(Clock::now() - start).count();
+
+	EXPECT_EQ(200, results[0].httpCode);
+	EXPECT_EQ("/flaky-async", results[0].response);
+	EXPECT_EQ(3, getCount("/flaky-async")) << "Asynchronous request is not retried";
+	EXPECT_EQ(200, results[1].httpCode);
+	EXPECT_EQ("/stall-async", results[1].response);
+	EXPECT_EQ(2u, hedgePolicy.GetStatistics().hedgeWins) << "Asynchronous request is not hedged";
+	EXPECT_GT(1000, elapsed);
+}
+
+class CompressedPostService : public TFC::Net::RESTServiceBase<std::string>
+{
+public:
+	Parameter<TFC::Net::ParameterType::PostData, std::string> Body;
+
+	CompressedPostService(std::string const& url, size_t threshold) :
+		RESTServiceBase(url, TFC::Net::HTTPMode::Post),
+		Body(this, "body")
+	{
+		CompressRequestThreshold = threshold;
+	}
+protected:
+	virtual std::string* OnProcessResponse(int httpCode, const std::string& responseStr, int& errorCode, std::string& errorMessage)
+	{
+		return new std::string(responseStr);
+	}
+};
+
+TEST_F(RESTTest, RESTCompressionTest)
+{
+	// Repetitive JSON, which compresses well like the responses of the real APIs
+	std::string json = "[";
+	for(int i = 0; i < 2000; i++)
+		json += "{\"id\":" + std::to_string(i) + ",\"name\":\"item\",\"enabled\":true},";
+	json.back() = ']';
+
+	std::atomic<size_t> sentBytes(0);
+	std::mutex uploadLock;
+	std::string uploadEncoding;
+	std::string uploadBody;
+
+	LocalHTTPServer server([&] (LocalHTTPServer::Request const& request) {
+		if(request.method == "POST")
+		{
+			auto encoding = request.headers.find("content-encoding");
+			std::string body = request.body;
+
+			if(encoding != request.headers.end() && encoding->second == "gzip")
+			{
+				// Inflate the gzip body as the server does
+				z_stream stream {};
+				inflateInit2(&stream, 15 + 16);
+
+				std::string inflated(1024 * 1024, '\0');
+				stream.next_in = reinterpret_cast<Bytef*>(&body[0]);
+				stream.avail_in = body.size();
+				stream.next_out = reinterpret_cast<Bytef*>(&inflated[0]);
+				stream.avail_out = inflated.size();
+				inflate(&stream, Z_FINISH);
+				inflated.resize(stream.total_out);
+				inflateEnd(&stream);
+				body = std::move(inflated);
+			}
+
+			std::lock_guard<std::mutex> guard(uploadLock);
+			uploadEncoding = encoding != request.headers.end() ? encoding->second : "";
+			uploadBody = body;
+			return LocalHTTPServer::Response { 200, { }, std::to_string(request.body.size()) };
+		}
+
+		auto encoding = request.headers.find("accept-encoding");
+		if(encoding != request.headers.end() && encoding->second.find("gzip") != std::string::npos)
+		{
+			std::string compressed;
+			TFC::Net::GzipCompress(compressed, json.data(), json.size());
+			sentBytes = compressed.size();
+			return LocalHTTPServer::Response { 200, { { "Content-Encoding", "gzip" } }, std::move(compressed) };
+		}
+
+		sentBytes = json.size();
+		return LocalHTTPServer::Response { 200, { }, json };
+	});
+
+	// Compressed response is decoded before it is processed
+	{
+		LocalService service(server.GetBaseUrl() + "/items");
+		auto result = service.Call();
+		std::string* response = result.Response;
+
+		EXPECT_EQ(200, result.httpCode);
+		ASSERT_NE(nullptr, response);
+		EXPECT_EQ(json, *response) << "Compressed response is not decoded";
+		EXPECT_GT(json.size() / 4, sentBytes.load()) << "Response is not compressed";
+		delete response;
+
+		std::cout << "JSON response of " << json.size() << " bytes is transferred in " << sentBytes << " bytes\n";
+	}
+
+	// Large post data is compressed, and small post data is sent as is
+	{
+		CompressedPostService service(server.GetBaseUrl() + "/upload", 1024);
+		service.Body = json;
+		auto result = service.Call();
+		std::string* response = result.Response;
+
+		std::lock_guard<std::mutex> guard(uploadLock);
+		EXPECT_EQ("gzip", uploadEncoding);
+		EXPECT_EQ("body=" + TFC::Net::PercentEncode(json), uploadBody) << "Compressed post data is corrupted";
+		ASSERT_NE(nullptr, response);
+		EXPECT_GT(uploadBody.size() / 4, std::stoul(*response)) << "Post data is not compressed";
+		delete response;
+	}
+
+	{
+		CompressedPostService service(server.GetBaseUrl() + "/upload", 1024);
+		service.Body = "small";
+		auto result = service.Call();
+		std::string* response = result.Response;
+		delete response;
+
+		std::lock_guard<std::mutex> guard(uploadLock);
+		EXPECT_EQ("", uploadEncoding) << "Small post data is compressed";
+		EXPECT_EQ("body=small", uploadBody);
+	}
+}
+
+class ItemService : public LocalService
+{
+public:
+	Parameter<TFC::Net::ParameterType::URL, std::string> ItemId;
+
+	ItemService(std::string const& url) :
+		LocalService(url),
+		ItemId(this, "id")
+	{
+	}
+};
+
+TEST_F(RESTTest, RESTStatisticsTest)
+{
+	std::string const body(1000, 'x');
+
+	LocalHTTPServer server([&] (LocalHTTPServer::Request const& request) {
+		if(request.target == "/items/missing")
+			return LocalHTTPServer::Response { 404, { }, "not found" };
+
+		return LocalHTTPServer::Response { 200, { }, body };
+	});
+
+	TFC::Net::RESTStatistics statistics;
+	auto endpoint = "GET " + server.GetBaseUrl() + "/items/{id}";
+	int const callCount = 10;
+
+	for(int i = 0; i < callCount; i++)
+	{
+		ItemService service(server.GetBaseUrl() + "/items/{id}");
+		service.Statistics = &statistics;
+		service.ItemId = std::to_string(i);
+		auto result = service.Call();
+		std::string* response = result.Response;
+		delete response;
+
+		auto& metrics = result.metrics;
+		EXPECT_EQ(200, result.httpCode);
+		EXPECT_EQ(body.size(), metrics.bytesDownloaded);
+		EXPECT_EQ(1, metrics.attempts);
+		EXPECT_FALSE(metrics.cached);
+		EXPECT_EQ(i > 0, metrics.connectionReused) << "Connection reuse is not reported for call " << i;
+		EXPECT_LT(0, metrics.totalTime.count());
+		EXPECT_LE(metrics.connectTime, metrics.startTransferTime);
+		EXPECT_LE(metrics.startTransferTime, metrics.totalTime);
+	}
+
+	{
+		ItemService service(server.GetBaseUrl() + "/items/{id}");
+		service.Statistics = &statistics;
+		service.ItemId = "missing";
+		auto result = service.Call();
+		std::string* response = result.Response;
+		delete response;
+
+		EXPECT_EQ(404, result.httpCode);
+	}
+
+	// Requests with different URL parameters are aggregated in the same endpoint
+	auto endpointStatistics = statistics.GetStatistics(endpoint);
+	EXPECT_EQ(callCount + 1u, endpointStatistics.requests);
+	EXPECT_EQ(1u, endpointStatistics.failures);
+	EXPECT_EQ(0u, endpointStatistics.cached);
+	EXPECT_EQ((uint64_t)callCount, endpointStatistics.reusedConnections);
+	EXPECT_EQ(callCount * body.size() + 9, endpointStatistics.bytesDownloaded);
+	EXPECT_LT(0, endpointStatistics.totalTime.p50.count());
+	EXPECT_LE(endpointStatistics.totalTime.p50, endpointStatistics.totalTime.p99);
+	EXPECT_LE(endpointStatistics.totalTime.p99, endpointStatistics.totalTime.max);
+	EXPECT_EQ(1u, statistics.GetStatistics().size());
+
+	auto dump = statistics.Dump();
+	EXPECT_EQ(0u, dump.find(endpoint + ": 11 requests, 1 failed")) << dump;
+	std::cout << dump;
+
+	statistics.Reset();
+	EXPECT_EQ(0u, statistics.GetStatistics(endpoint).requests);
+}
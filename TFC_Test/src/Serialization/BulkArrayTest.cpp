@@ -0,0 +1,177 @@
+/*
+ * BulkArrayTest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "TFC/ServiceModel/BinarySerializer.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+class BulkArrayTest : public testing::Test
+{
+	protected:
+	// virtual void SetUp() will be called before each test is run.
+	// You should define it if you need to initialize the variables.
+	// Otherwise, you don't have to provide it.
+	virtual void SetUp()
+	{
+
+	}
+	// virtual void TearDown() will be called after each test is run.
+	// You should define it if there is cleanup work to do.
+	// Otherwise, you don't have to provide it.
+	virtual void TearDown()
+	{
+
+	}
+};
+
+namespace {
+
+struct Point
+{
+	int32_t x;
+	int32_t y;
+};
+
+struct Label
+{
+	std::string text;
+};
+
+struct Sample
+{
+	std::vector<double> readings;
+	std::vector<int16_t> deltas;
+	std::array<int32_t, 4> window;
+	std::vector<Point> path;
+	std::vector<Label> labels;
+};
+
+}
+
+TFC_DefineTypeSerializationInfo(Label,
+	TFC_FieldInfo(Label::text));
+
+TFC_DefineTypeSerializationInfo(Sample,
+	TFC_FieldInfo(Sample::readings),
+	TFC_FieldInfo(Sample::deltas),
+	TFC_FieldInfo(Sample::window),
+	TFC_FieldInfo(Sample::path),
+	TFC_FieldInfo(Sample::labels));
+
+using namespace TFC::Serialization;
+using TFC::ServiceModel::BinarySerializer;
+using TFC::ServiceModel::BinaryDeserializer;
+using TFC::ServiceModel::BinaryBlockCopyable;
+
+static_assert(BinaryBlockCopyable<double>::value && BinaryBlockCopyable<Point>::value, "Numeric and plain struct must be block copyable");
+static_assert(!BinaryBlockCopyable<bool>::value && !BinaryBlockCopyable<Label>::value, "Bool and class with serialization info must not be block copyable");
+
+TEST_F(BulkArrayTest, RoundTrip)
+{
+	Sample sample;
+	sample.readings = { 1.5, -2.25, 1e100 };
+	sample.deltas = { -1, 32767, -32768 };
+	sample.window = {{ 1, -2, 3, -4 }};
+	sample.path = { { 1, 2 }, { -3, 4 } };
+	sample.labels = { { "first" }, { "second" } };
+
+	auto serialized = GenericSerializer<BinarySerializer, Sample>::Serialize(sample);
+	auto result = GenericDeserializer<BinaryDeserializer, Sample>::Deserialize(serialized);
+
+	EXPECT_EQ(sample.readings, result.readings);
+	EXPECT_EQ(sample.deltas, result.deltas);
+	EXPECT_EQ(sample.window, result.window);
+	ASSERT_EQ(sample.path.size(), result.path.size());
+	EXPECT_EQ(-3, result.path[1].x);
+	EXPECT_EQ(4, result.path[1].y);
+	ASSERT_EQ(sample.labels.size(), result.labels.size());
+	EXPECT_EQ("second", result.labels[1].text);
+}
+
+TEST_F(BulkArrayTest, BlockLayout)
+{
+	std::vector<int32_t> values { 1, -1, 0x12345678 };
+
+	BinarySerializer ser;
+	ser.Serialize(values);
+	auto serialized = ser.EndPack();
+
+	// Count followed by the elements in their memory representation
+	ASSERT_EQ(sizeof(uint32_t) + sizeof(int32_t) * values.size(), serialized.size());
+
+	uint32_t count = 0;
+	std::memcpy(&count, serialized.data(), sizeof(count));
+	EXPECT_EQ(3u, count);
+	EXPECT_EQ(0, std::memcmp(values.data(), serialized.data() + sizeof(count), sizeof(int32_t) * values.size()));
+}
+
+TEST_F(BulkArrayTest, TruncatedBuffer)
+{
+	std::vector<double> values { 1.0, 2.0, 3.0 };
+
+	BinarySerializer ser;
+	ser.Serialize(values);
+	auto serialized = ser.EndPack();
+
+	std::array<double, 2> wrongSize;
+	BinaryDeserializer sizeMismatch(serialized);
+	EXPECT_THROW(sizeMismatch.Deserialize(wrongSize), SerializationException);
+
+	serialized.pop_back();
+
+	BinaryDeserializer truncated(serialized);
+	std::vector<double> result;
+	EXPECT_THROW(truncated.Deserialize(result), SerializationException);
+}
+
+TEST_F(BulkArrayTest, BenchmarkBlockAndElementWise)
+{
+	using Clock = std::chrono::steady_clock;
+	int const iteration = 1000;
+
+	std::vector<double> values(4096);
+	for(size_t i = 0; i < values.size(); i++)
+		values[i] = i * 0.5;
+
+	auto start = Clock::now();
+	for(int i = 0; i < iteration; i++)
+	{
+		BinarySerializer ser;
+		ser.Serialize((uint32_t)values.size());
+		for(auto val : values)
+			ser.Serialize(val);
+		ser.EndPack();
+	}
+	auto elementWrite = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+	start = Clock::now();
+	for(int i = 0; i < iteration; i++)
+	{
+		BinarySerializer ser;
+		ser.Serialize(values);
+		ser.EndPack();
+	}
+	auto blockWrite = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+	BinarySerializer ser;
+	ser.Serialize(values);
+	auto serialized = ser.EndPack();
+
+	start = Clock::now();
+	for(int i = 0; i < iteration; i++)
+	{
+		BinaryDeserializer deser(serialized);
+		std::vector<double> result;
+		deser.Deserialize(result);
+	}
+	auto blockRead = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+	std::cout << "Serialize 4096 doubles: element-wise " << (elementWrite / iteration) << " ns/op, block " << (blockWrite / iteration) << " ns/op\n";
+	std::cout << "Deserialize 4096 doubles: block " << (blockRead / iteration) << " ns/op\n";
+}
@@ -0,0 +1,254 @@
+/*
+ * DiscriminatedUnionTest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "TFC/ServiceModel/BinarySerializer.h"
+#include "TFC/Serialization/DiscriminatedUnionSerializer.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+
+class DiscriminatedUnionTest : public testing::Test
+{
+	protected:
+	// virtual void SetUp() will be called before each test is run.
+	// You should define it if you need to initialize the variables.
+	// Otherwise, you don't have to provide it.
+	virtual void SetUp()
+	{
+
+	}
+	// virtual void TearDown() will be called after each test is run.
+	// You should define it if there is cleanup work to do.
+	// Otherwise, you don't have to provide it.
+	virtual void TearDown()
+	{
+
+	}
+};
+
+namespace {
+
+struct DenseEvent
+{
+	uint32_t kind;
+	union
+	{
+		int32_t intValue;
+		double doubleValue;
+	};
+};
+
+struct SparseEvent
+{
+	uint32_t kind;
+	union
+	{
+		int32_t intValue;
+		double doubleValue;
+	};
+};
+
+}
+
+// Event stream with 40 kinds, odd kinds carry integer and even kinds carry floating point payload
+TFC_DefineDiscriminatedUnionType(DenseEvent, kind,
+	TFC_UnionCase(1, DenseEvent::intValue),
+	TFC_UnionCase(2, DenseEvent::doubleValue),
+	TFC_UnionCase(3, DenseEvent::intValue),
+	TFC_UnionCase(4, DenseEvent::doubleValue),
+	TFC_UnionCase(5, DenseEvent::intValue),
+	TFC_UnionCase(6, DenseEvent::doubleValue),
+	TFC_UnionCase(7, DenseEvent::intValue),
+	TFC_UnionCase(8, DenseEvent::doubleValue),
+	TFC_UnionCase(9, DenseEvent::intValue),
+	TFC_UnionCase(10, DenseEvent::doubleValue),
+	TFC_UnionCase(11, DenseEvent::intValue),
+	TFC_UnionCase(12, DenseEvent::doubleValue),
+	TFC_UnionCase(13, DenseEvent::intValue),
+	TFC_UnionCase(14, DenseEvent::doubleValue),
+	TFC_UnionCase(15, DenseEvent::intValue),
+	TFC_UnionCase(16, DenseEvent::doubleValue),
+	TFC_UnionCase(17, DenseEvent::intValue),
+	TFC_UnionCase(18, DenseEvent::doubleValue),
+	TFC_UnionCase(19, DenseEvent::intValue),
+	TFC_UnionCase(20, DenseEvent::doubleValue),
+	TFC_UnionCase(21, DenseEvent::intValue),
+	TFC_UnionCase(22, DenseEvent::doubleValue),
+	TFC_UnionCase(23, DenseEvent::intValue),
+	TFC_UnionCase(24, DenseEvent::doubleValue),
+	TFC_UnionCase(25, DenseEvent::intValue),
+	TFC_UnionCase(26, DenseEvent::doubleValue),
+	TFC_UnionCase(27, DenseEvent::intValue),
+	TFC_UnionCase(28, DenseEvent::doubleValue),
+	TFC_UnionCase(29, DenseEvent::intValue),
+	TFC_UnionCase(30, DenseEvent::doubleValue),
+	TFC_UnionCase(31, DenseEvent::intValue),
+	TFC_UnionCase(32, DenseEvent::doubleValue),
+	TFC_UnionCase(33, DenseEvent::intValue),
+	TFC_UnionCase(34, DenseEvent::doubleValue),
+	TFC_UnionCase(35, DenseEvent::intValue),
+	TFC_UnionCase(36, DenseEvent::doubleValue),
+	TFC_UnionCase(37, DenseEvent::intValue),
+	TFC_UnionCase(38, DenseEvent::doubleValue),
+	TFC_UnionCase(39, DenseEvent::intValue),
+	TFC_UnionCase(40, DenseEvent::doubleValue));
+
+TFC_DefineDiscriminatedUnionType(SparseEvent, kind,
+	TFC_UnionCase(1000, SparseEvent::intValue),
+	TFC_UnionCase(2007, SparseEvent::doubleValue),
+	TFC_UnionCase(3014, SparseEvent::intValue),
+	TFC_UnionCase(4021, SparseEvent::doubleValue),
+	TFC_UnionCase(5028, SparseEvent::intValue),
+	TFC_UnionCase(6035, SparseEvent::doubleValue),
+	TFC_UnionCase(7042, SparseEvent::intValue),
+	TFC_UnionCase(8049, SparseEvent::doubleValue),
+	TFC_UnionCase(9056, SparseEvent::intValue),
+	TFC_UnionCase(10063, SparseEvent::doubleValue),
+	TFC_UnionCase(11070, SparseEvent::intValue),
+	TFC_UnionCase(12077, SparseEvent::doubleValue),
+	TFC_UnionCase(13084, SparseEvent::intValue),
+	TFC_UnionCase(14091, SparseEvent::doubleValue),
+	TFC_UnionCase(15098, SparseEvent::intValue),
+	TFC_UnionCase(16105, SparseEvent::doubleValue),
+	TFC_UnionCase(17112, SparseEvent::intValue),
+	TFC_UnionCase(18119, SparseEvent::doubleValue),
+	TFC_UnionCase(19126, SparseEvent::intValue),
+	TFC_UnionCase(20133, SparseEvent::doubleValue),
+	TFC_UnionCase(21140, SparseEvent::intValue),
+	TFC_UnionCase(22147, SparseEvent::doubleValue),
+	TFC_UnionCase(23154, SparseEvent::intValue),
+	TFC_UnionCase(24161, SparseEvent::doubleValue),
+	TFC_UnionCase(25168, SparseEvent::intValue),
+	TFC_UnionCase(26175, SparseEvent::doubleValue),
+	TFC_UnionCase(27182, SparseEvent::intValue),
+	TFC_UnionCase(28189, SparseEvent::doubleValue),
+	TFC_UnionCase(29196, SparseEvent::intValue),
+	TFC_UnionCase(30203, SparseEvent::doubleValue),
+	TFC_UnionCase(31210, SparseEvent::intValue),
+	TFC_UnionCase(32217, SparseEvent::doubleValue),
+	TFC_UnionCase(33224, SparseEvent::intValue),
+	TFC_UnionCase(34231, SparseEvent::doubleValue),
+	TFC_UnionCase(35238, SparseEvent::intValue),
+	TFC_UnionCase(36245, SparseEvent::doubleValue),
+	TFC_UnionCase(37252, SparseEvent::intValue),
+	TFC_UnionCase(38259, SparseEvent::doubleValue),
+	TFC_UnionCase(39266, SparseEvent::intValue),
+	TFC_UnionCase(40273, SparseEvent::doubleValue));
+
+using namespace TFC::Serialization;
+using TFC::ServiceModel::BinarySerializer;
+using TFC::ServiceModel::BinaryDeserializer;
+
+typedef DiscriminatedUnionTypeInfoSelector<DenseEvent>::Type DenseInfo;
+typedef DiscriminatedUnionTypeInfoSelector<SparseEvent>::Type SparseInfo;
+
+template<typename TDUType>
+struct DispatchOf;
+
+template<typename TDUType, typename TDiscriminator, TDiscriminator TDUType::* discriminator, typename... TCase>
+struct DispatchOf<DiscriminatedUnionTypeInfo<TDUType, TDiscriminator, discriminator, TCase...>>
+{
+	typedef DiscriminatedUnionDispatch<TCase...> Type;
+};
+
+typedef DispatchOf<DenseInfo>::Type DenseDispatch;
+typedef DispatchOf<SparseInfo>::Type SparseDispatch;
+
+static_assert(DenseDispatch::dense, "Sequential discriminators must use lookup table");
+static_assert(!SparseDispatch::dense, "Sparse discriminators must use binary search");
+
+TEST_F(DiscriminatedUnionTest, DispatchFindsEveryCase)
+{
+	for(uint32_t i = 0; i < 40; i++)
+	{
+		EXPECT_EQ((int)i, DenseDispatch::Find(i + 1));
+		EXPECT_EQ((int)i, SparseDispatch::Find((i + 1) * 1000 + i * 7));
+	}
+
+	EXPECT_EQ(-1, DenseDispatch::Find(0));
+	EXPECT_EQ(-1, DenseDispatch::Find(41));
+	EXPECT_EQ(-1, SparseDispatch::Find(0));
+	EXPECT_EQ(-1, SparseDispatch::Find(1001));
+	EXPECT_EQ(-1, SparseDispatch::Find(0xFFFFFFFF));
+}
+
+template<typename TEvent>
+static void RoundTrip(uint32_t kind, bool intPayload)
+{
+	TEvent evt;
+	evt.kind = kind;
+
+	if(intPayload)
+		evt.intValue = kind * 3;
+	else
+		evt.doubleValue = kind * 1.5;
+
+	auto packed = GenericSerializer<BinarySerializer, TEvent>::Serialize(evt);
+	auto result = GenericDeserializer<BinaryDeserializer, TEvent>::Deserialize(packed);
+
+	EXPECT_EQ(kind, result.kind);
+	if(intPayload)
+		EXPECT_EQ(evt.intValue, result.intValue);
+	else
+		EXPECT_EQ(evt.doubleValue, result.doubleValue);
+}
+
+TEST_F(DiscriminatedUnionTest, SerializeEveryCase)
+{
+	for(uint32_t i = 0; i < 40; i++)
+	{
+		RoundTrip<DenseEvent>(i + 1, i % 2 == 0);
+		RoundTrip<SparseEvent>((i + 1) * 1000 + i * 7, i % 2 == 0);
+	}
+}
+
+template<typename TEvent>
+static long long BenchmarkDeserialize(uint32_t kind, bool intPayload, int iteration)
+{
+	using Clock = std::chrono::steady_clock;
+
+	TEvent evt;
+	evt.kind = kind;
+	if(intPayload)
+		evt.intValue = 1;
+	else
+		evt.doubleValue = 1.0;
+
+	auto packed = GenericSerializer<BinarySerializer, TEvent>::Serialize(evt);
+
+	auto start = Clock::now();
+	for(int i = 0; i < iteration; i++)
+		GenericDeserializer<BinaryDeserializer, TEvent>::Deserialize(packed);
+
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() / iteration;
+}
+
+TEST_F(DiscriminatedUnionTest, BenchmarkDispatch)
+{
+	int const iteration = 100000;
+
+	// With sequential matching, the last case costs 40 compares while the first costs one
+	std::cout << "Dense first case: " << BenchmarkDeserialize<DenseEvent>(1, true, iteration) << " ns/op\n";
+	std::cout << "Dense last case: " << BenchmarkDeserialize<DenseEvent>(40, false, iteration) << " ns/op\n";
+	std::cout << "Sparse first case: " << BenchmarkDeserialize<SparseEvent>(1000, true, iteration) << " ns/op\n";
+	std::cout << "Sparse last case: " << BenchmarkDeserialize<SparseEvent>(40273, false, iteration) << " ns/op\n";
+
+	using Clock = std::chrono::steady_clock;
+	volatile int sink = 0;
+
+	auto start = Clock::now();
+	for(int i = 0; i < iteration; i++)
+		sink += SparseDispatch::Find((i % 40 + 1) * 1000 + (i % 40) * 7);
+	auto sparseLookup = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+	start = Clock::now();
+	for(int i = 0; i < iteration; i++)
+		sink += DenseDispatch::Find(i % 40 + 1);
+	auto denseLookup = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+	std::cout << "Lookup: dense " << denseLookup << " ns, sparse " << sparseLookup << " ns per " << iteration << " ops\n";
+}
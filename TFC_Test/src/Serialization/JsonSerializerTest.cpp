@@ -0,0 +1,253 @@
+/*
+ * JsonSerializerTest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "TFC/Serialization/JsonSerializer.h"
+#include "TFC_Test.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <regex>
+#include <sstream>
+
+class JsonSerializerTest : public testing::Test
+{
+	protected:
+	// virtual void SetUp() will be called before each test is run.
+	// You should define it if you need to initialize the variables.
+	// Otherwise, you don't have to provide it.
+	virtual void SetUp()
+	{
+
+	}
+	// virtual void TearDown() will be called after each test is run.
+	// You should define it if there is cleanup work to do.
+	// Otherwise, you don't have to provide it.
+	virtual void TearDown()
+	{
+
+	}
+};
+
+namespace {
+
+std::string ReadFixture(char const* path)
+{
+	char* resourcePath = app_get_resource_path();
+	std::string respath(resourcePath != nullptr ? resourcePath : "");
+	free(resourcePath);
+
+	std::ifstream in(respath + path);
+	std::stringstream buffer;
+	buffer << in.rdbuf();
+	return buffer.str();
+}
+
+struct Post
+{
+	int userId;
+	int id;
+	std::string title;
+	std::string body;
+
+	bool operator==(Post const& other) const
+	{
+		return userId == other.userId && id == other.id && title == other.title && body == other.body;
+	}
+};
+
+struct Author
+{
+	std::string name;
+	bool active;
+	double rating;
+	std::vector<Post> posts;
+};
+
+/*
+ * Ad-hoc parsing the way a REST client would do without serialization support, used as the
+ * baseline for the benchmark
+ */
+std::vector<Post> ParseAdHoc(std::string const& text)
+{
+	static std::regex const objRegex(
+		"\\{\\s*\"userId\":\\s*(\\d+),\\s*\"id\":\\s*(\\d+),\\s*"
+		"\"title\":\\s*\"((?:[^\"\\\\]|\\\\.)*)\",\\s*\"body\":\\s*\"((?:[^\"\\\\]|\\\\.)*)\"\\s*\\}");
+	static std::regex const escapeRegex("\\\\n");
+
+	std::vector<Post> ret;
+	for(std::sregex_iterator it(text.begin(), text.end(), objRegex), end; it != end; ++it)
+	{
+		auto& match = *it;
+		ret.push_back({
+			std::stoi(match[1].str()),
+			std::stoi(match[2].str()),
+			std::regex_replace(match[3].str(), escapeRegex, "\n"),
+			std::regex_replace(match[4].str(), escapeRegex, "\n")
+		});
+	}
+	return ret;
+}
+
+}
+
+TFC_DefineTypeSerializationInfo(Post,
+	TFC_FieldInfo(Post::userId),
+	TFC_FieldInfo(Post::id),
+	TFC_FieldInfo(Post::title),
+	TFC_FieldInfo(Post::body));
+
+TFC_DefineTypeSerializationInfo(Author,
+	TFC_FieldInfo(Author::name),
+	TFC_FieldInfo(Author::active),
+	TFC_FieldInfo(Author::rating),
+	TFC_FieldInfo(Author::posts));
+
+using TFC::Serialization::JsonSerializer;
+using TFC::Serialization::JsonDeserializer;
+using TFC::Serialization::GenericSerializer;
+using TFC::Serialization::GenericDeserializer;
+
+TEST_F(JsonSerializerTest, SerializeObject)
+{
+	Author author { "Kevin \"K\"\n", true, 4.5, { { 1, 2, "Title", "Body" } } };
+
+	JsonSerializer ser;
+	GenericSerializer<JsonSerializer, Author>::Serialize(ser, author);
+	auto result = ser.EndPack();
+
+	EXPECT_EQ("{\"name\":\"Kevin \\\"K\\\"\\n\",\"active\":true,\"rating\":4.5,"
+			  "\"posts\":[{\"userId\":1,\"id\":2,\"title\":\"Title\",\"body\":\"Body\"}]}", result);
+}
+
+TEST_F(JsonSerializerTest, RoundTrip)
+{
+	Author author { "\xC3\xBC \\ \t", false, -0.1, { { 1, 2, "A", "B" }, { 3, 4, "C", "D" } } };
+
+	JsonSerializer ser;
+	GenericSerializer<JsonSerializer, Author>::Serialize(ser, author);
+	auto text = ser.EndPack();
+
+	Author result {};
+	JsonDeserializer deser(text);
+	GenericDeserializer<JsonDeserializer, Author>::Deserialize(deser, result);
+	deser.Finalize();
+
+	EXPECT_EQ(author.name, result.name);
+	EXPECT_EQ(author.active, result.active);
+	EXPECT_EQ(author.rating, result.rating);
+	EXPECT_EQ(author.posts, result.posts);
+}
+
+TEST_F(JsonSerializerTest, DeserializeUnorderedAndUnknownKeys)
+{
+	std::string text = "{ \"posts\": null, \"extra\": { \"a\": [1, \"}\", {}] }, \"rating\": 1e2, "
+					   "\"name\": \"\\u00fc\\ud83d\\ude00\", \"active\": true }";
+
+	Author result { "", false, 0, { { 1, 1, "", "" } } };
+	JsonDeserializer deser(text);
+	GenericDeserializer<JsonDeserializer, Author>::Deserialize(deser, result);
+	deser.Finalize();
+
+	EXPECT_EQ("\xC3\xBC\xF0\x9F\x98\x80", result.name);
+	EXPECT_TRUE(result.active);
+	EXPECT_EQ(100.0, result.rating);
+	EXPECT_EQ(1, result.posts.size());
+}
+
+TEST_F(JsonSerializerTest, MalformedInput)
+{
+	std::vector<Post> result;
+
+	EXPECT_THROW({
+		std::string text = "[{\"userId\":1,}]";
+		JsonDeserializer deser(text);
+		deser.Deserialize(result);
+	}, TFC::Serialization::JsonParseException);
+
+	EXPECT_THROW({
+		std::string text = "[{\"userId\":99999999999}]";
+		JsonDeserializer deser(text);
+		deser.Deserialize(result);
+	}, TFC::Serialization::JsonParseException);
+
+	EXPECT_THROW({
+		std::string text = "[] []";
+		JsonDeserializer deser(text);
+		deser.Deserialize(result);
+		deser.Finalize();
+	}, TFC::Serialization::JsonParseException);
+
+	// Unknown member without a value is not skipped as an empty value
+	EXPECT_THROW({
+		std::string text = "[{\"userId\":1,\"extra\":}]";
+		JsonDeserializer deser(text);
+		deser.Deserialize(result);
+	}, TFC::Serialization::JsonParseException);
+
+	// Forms accepted by strtod which are not JSON numbers
+	for(auto number : { "inf", "-Infinity", "nan", "0x10", ".5", "1.", "1e" })
+	{
+		double value;
+		std::string text = number;
+		JsonDeserializer deser(text);
+		EXPECT_THROW(deser.Deserialize(value), TFC::Serialization::JsonParseException) << number;
+	}
+
+	// Integer target only accepts fraction or exponent which is integral and in range
+	for(auto number : { "1.5", "1e-1", "1e30", "-1e30", "1e400" })
+	{
+		int64_t value;
+		std::string text = number;
+		JsonDeserializer deser(text);
+		EXPECT_THROW(deser.Deserialize(value), TFC::Serialization::JsonParseException) << number;
+	}
+
+	{
+		int64_t value = 0;
+		std::string text = "-1.0e2";
+		JsonDeserializer deser(text);
+		deser.Deserialize(value);
+		EXPECT_EQ(-100, value);
+	}
+}
+
+TEST_F(JsonSerializerTest, BenchmarkRESTFixture)
+{
+	using Clock = std::chrono::steady_clock;
+	int const iteration = 50;
+
+	char const* fixtures[] = { "testcase/REST/get_posts_all.txt", "testcase/REST/get_posts_userid-1.txt" };
+
+	for(auto fixture : fixtures)
+	{
+		auto text = ReadFixture(fixture);
+		ASSERT_NE(0, text.size());
+
+		std::vector<Post> adHoc, json;
+
+		auto start = Clock::now();
+		for(int i = 0; i < iteration; i++)
+			adHoc = ParseAdHoc(text);
+		auto adHocTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+		start = Clock::now();
+		for(int i = 0; i < iteration; i++)
+		{
+			JsonDeserializer deser(text);
+			deser.Deserialize(json);
+			deser.Finalize();
+		}
+		auto jsonTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+		std::cout << fixture << ": " << json.size() << " posts, ad-hoc " << (adHocTime / iteration)
+				  << " us/op, JsonDeserializer " << (jsonTime / iteration) << " us/op\n";
+
+		ASSERT_NE(0, json.size());
+		EXPECT_EQ(adHoc, json);
+	}
+}
@@ -0,0 +1,156 @@
+/*
+ * TableSerializerTest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "TFC/ServiceModel/BinarySerializer.h"
+#include "TFC/Serialization/TableSerializer.h"
+#include "TFC/Serialization/Predicates.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+
+class TableSerializerTest : public testing::Test
+{
+	protected:
+	// virtual void SetUp() will be called before each test is run.
+	// You should define it if you need to initialize the variables.
+	// Otherwise, you don't have to provide it.
+	virtual void SetUp()
+	{
+
+	}
+	// virtual void TearDown() will be called after each test is run.
+	// You should define it if there is cleanup work to do.
+	// Otherwise, you don't have to provide it.
+	virtual void TearDown()
+	{
+
+	}
+};
+
+namespace {
+
+enum class RecordKind : int32_t
+{
+	Plain = 1,
+	Tagged = 2
+};
+
+struct RecordHeader
+{
+	uint32_t sequence;
+	double timestamp;
+};
+
+struct Record
+{
+	uint32_t flags;
+	RecordKind kind;
+	RecordHeader header;
+	std::string tag;
+	bool active;
+	int64_t value;
+	std::vector<int> samples;
+};
+
+}
+
+TFC_DefineTypeSerializationInfo(RecordHeader,
+	TFC_FieldInfo(RecordHeader::sequence),
+	TFC_FieldInfo(RecordHeader::timestamp));
+
+TFC_DefineTypeSerializationInfo(Record,
+	TFC_ConstantValue(0x1234),
+	TFC_FieldInfo(Record::flags),
+	TFC_FieldInfo(Record::kind),
+	TFC_FieldInfo(Record::header),
+	TFC_FieldInfo(Record::tag, TFC_BitFieldCheck(Record::flags, 1)),
+	TFC_FieldInfo(Record::active),
+	TFC_FieldInfo(Record::value),
+	TFC_FieldInfo(Record::samples));
+
+using namespace TFC::Serialization;
+using TFC::ServiceModel::BinarySerializer;
+using TFC::ServiceModel::BinaryDeserializer;
+
+typedef FieldTable<Record> RecordTable;
+
+static_assert(RecordTable::count == 8, "Field table must contain every declared entry");
+static_assert(RecordTable::fields[0].constant && RecordTable::fields[0].nameLength == 0, "Constant value must not have name");
+static_assert(RecordTable::fields[2].typeCode == FieldTypeCode::Int32, "Enumeration must use its underlying type code");
+static_assert(RecordTable::fields[3].typeCode == FieldTypeCode::Object, "Nested class must use object type code");
+static_assert(RecordTable::fields[4].evaluate != nullptr && RecordTable::fields[5].evaluate == nullptr, "Only field with predicate has evaluator");
+static_assert(RecordTable::fields[7].typeCode == FieldTypeCode::Other, "Container must use other type code");
+
+TEST_F(TableSerializerTest, FieldNames)
+{
+	char const* expected[] = { "", "flags", "kind", "header", "tag", "active", "value", "samples" };
+
+	for(size_t i = 0; i < RecordTable::count; i++)
+		EXPECT_EQ(expected[i], RecordTable::fields[i].Name());
+}
+
+TEST_F(TableSerializerTest, SameAsRecursiveSerializer)
+{
+	Record record { 5, RecordKind::Tagged, { 10, 1234.5 }, "tagged", true, -42, { 1, 2, 3 } };
+
+	auto recursive = GenericSerializer<BinarySerializer, Record>::Serialize(record);
+	auto table = TableClassSerializer<BinarySerializer, Record>::Serialize(record);
+	EXPECT_EQ(recursive, table);
+
+	auto result = TableClassDeserializer<BinaryDeserializer, Record>::Deserialize(recursive);
+	EXPECT_EQ(record.flags, result.flags);
+	EXPECT_EQ(record.kind, result.kind);
+	EXPECT_EQ(record.header.sequence, result.header.sequence);
+	EXPECT_EQ(record.header.timestamp, result.header.timestamp);
+	EXPECT_EQ(record.tag, result.tag);
+	EXPECT_EQ(record.active, result.active);
+	EXPECT_EQ(record.value, result.value);
+	EXPECT_EQ(record.samples, result.samples);
+
+	// Predicate must exclude the tag
+	record.flags = 4;
+	recursive = GenericSerializer<BinarySerializer, Record>::Serialize(record);
+	table = TableClassSerializer<BinarySerializer, Record>::Serialize(record);
+	EXPECT_EQ(recursive, table);
+	auto excluded = TableClassDeserializer<BinaryDeserializer, Record>::Deserialize(table);
+	EXPECT_EQ("", excluded.tag);
+}
+
+TEST_F(TableSerializerTest, BenchmarkRecursiveAndTable)
+{
+	using Clock = std::chrono::steady_clock;
+	int const iteration = 100000;
+
+	Record record { 5, RecordKind::Tagged, { 10, 1234.5 }, "tagged", true, -42, { 1, 2, 3 } };
+	auto serialized = GenericSerializer<BinarySerializer, Record>::Serialize(record);
+
+	auto start = Clock::now();
+	for(int i = 0; i < iteration; i++)
+		GenericSerializer<BinarySerializer, Record>::Serialize(record);
+	auto recursiveWrite = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+	start = Clock::now();
+	for(int i = 0; i < iteration; i++)
+		TableClassSerializer<BinarySerializer, Record>::Serialize(record);
+	auto tableWrite = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+	start = Clock::now();
+	for(int i = 0; i < iteration; i++)
+		GenericDeserializer<BinaryDeserializer, Record>::Deserialize(serialized);
+	auto recursiveRead = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+	start = Clock::now();
+	for(int i = 0; i < iteration; i++)
+		TableClassDeserializer<BinaryDeserializer, Record>::Deserialize(serialized);
+	auto tableRead = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+	std::cout << "Serialize: recursive " << (recursiveWrite / iteration) << " ns/op, table " << (tableWrite / iteration) << " ns/op\n";
+	std::cout << "Deserialize: recursive " << (recursiveRead / iteration) << " ns/op, table " << (tableRead / iteration) << " ns/op\n";
+
+	auto table = TableClassSerializer<BinarySerializer, Record>::Serialize(record);
+	EXPECT_EQ(serialized, table);
+}
@@ -15,6 +15,8 @@
 #include "TFC_Test.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <chrono>
 #include <thread>
@@ -84,6 +86,14 @@ public:
 	virtual ~ITestAgain() { }
 };
 
+class IBlob
+{
+public:
+	virtual std::vector<uint8_t> Echo(std::vector<uint8_t> data) = 0;
+	virtual TFC::ServiceModel::SharedBuffer EchoShared(TFC::ServiceModel::SharedBuffer data) = 0;
+	virtual ~IBlob() { }
+};
+
 class MyException : public std::exception
 {
 	std::string whoa;
@@ -117,6 +127,62 @@ public:
 	}
 };
 
+class ServerBenchmark : public TFC::ServiceModel::ServerObject<ServiceEndpoint, ITest>
+{
+public:
+	virtual std::string FunctionA(int a, int b, double c, std::string d) override
+	{
+		d.append(std::to_string(a));
+		return d;
+	}
+
+	virtual void FunctionB(int s) override
+	{
+		if(s < 0)
+			throw MyException("Negative value");
+	}
+};
+
+class ServerSlow : public TFC::ServiceModel::ServerObject<ServiceEndpoint, ITest>
+{
+public:
+	static std::atomic<int> totalInFlight;
+	static std::atomic<int> peakInFlight;
+	static std::atomic<int> overlapCount;
+
+	ServerSlow() : inFlight(0) { }
+
+	virtual std::string FunctionA(int a, int b, double c, std::string d) override
+	{
+		// Calls to the same object must never overlap when the server runs with per-object strand
+		if(++inFlight > 1)
+			overlapCount++;
+
+		int total = ++totalInFlight;
+		int peak = peakInFlight;
+		while(total > peak && !peakInFlight.compare_exchange_weak(peak, total));
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		d.append(std::to_string(a));
+
+		--totalInFlight;
+		--inFlight;
+		return d;
+	}
+
+	virtual void FunctionB(int s) override
+	{
+
+	}
+
+private:
+	std::atomic<int> inFlight;
+};
+
+std::atomic<int> ServerSlow::totalInFlight { 0 };
+std::atomic<int> ServerSlow::peakInFlight { 0 };
+std::atomic<int> ServerSlow::overlapCount { 0 };
+
 class ServerTestMultiIface : public TFC::ServiceModel::ServerObject<ServiceEndpoint, ITest>,
 							 public TFC::ServiceModel::ServerObject<ServiceEndpoint, ITestAgain>
 {
@@ -143,19 +209,60 @@ public:
 	}
 };
 
+class ServerBlob : public TFC::ServiceModel::ServerObject<ServiceEndpoint, IBlob>
+{
+public:
+	virtual std::vector<uint8_t> Echo(std::vector<uint8_t> data) override
+	{
+		return data;
+	}
+
+	virtual TFC::ServiceModel::SharedBuffer EchoShared(TFC::ServiceModel::SharedBuffer data) override
+	{
+		return data;
+	}
+};
+
+class BlobClient : TFC::ServiceModel::ClientEndpoint<ServiceEndpoint, IBlob>
+{
+public:
+	BlobClient() :
+		ClientEndpoint("/com/srin/tfc/RPCTest/Blob")
+	{
+
+	}
+
+	virtual std::vector<uint8_t> Echo(std::vector<uint8_t> data) override
+	{
+		return Invoke(&IBlob::Echo, data);
+	}
+
+	virtual TFC::ServiceModel::SharedBuffer EchoShared(TFC::ServiceModel::SharedBuffer data) override
+	{
+		return Invoke(&IBlob::EchoShared, data);
+	}
+};
+
 class TestClient : TFC::ServiceModel::ClientEndpoint<ServiceEndpoint, ITest>
 {
 public:
 	void EventHandlerTest(ITest* sender, int event);
 
 	TestClient() :
-		ClientEndpoint(RPCTEST_OBJECT_PATH)
+		TestClient(RPCTEST_OBJECT_PATH)
+	{
+
+	}
+
+	TestClient(char const* objectPath) :
+		ClientEndpoint(objectPath)
 	{
 		RegisterEvent(&ITest::eventSomething);
 
 		this->eventSomething += EventHandler(TestClient::EventHandlerTest);
 
 		storedValueAfterEvent = 0;
+		eventCount = 0;
 	}
 
 	virtual std::string FunctionA(int a, int b, double c, std::string d) override
@@ -168,13 +275,59 @@ public:
 		Invoke(&ITest::FunctionB, s);
 	}
 
+	void StopEventSomething()
+	{
+		this->eventSomething -= EventHandler(TestClient::EventHandlerTest);
+		UnregisterEvent(&ITest::eventSomething);
+	}
+
+	void FunctionAAsync(int a, int b, double c, std::string d,
+		std::function<void(TFC::ServiceModel::InvokeResult<std::string>&)> completion)
+	{
+		InvokeAsync(&ITest::FunctionA, std::move(completion), a, b, c, d);
+	}
+
+	std::vector<std::string> FunctionABatch(int count, bool& failedCallThrows)
+	{
+		auto batch = CreateBatch();
+		std::vector<TFC::ServiceModel::InvokeResult<std::string>*> results;
+
+		for(int i = 0; i < count; i++)
+			results.push_back(&batch.Add(&ITest::FunctionA, i, 2, 3.5, "batch"));
+
+		auto& failedCall = batch.Add(&ITest::FunctionB, -1);
+		auto& voidCall = batch.Add(&ITest::FunctionB, 1);
+
+		batch.Execute();
+
+		std::vector<std::string> ret;
+		for(auto result : results)
+			ret.push_back(result->Get());
+
+		voidCall.Get();
+
+		try
+		{
+			failedCall.Get();
+			failedCallThrows = false;
+		}
+		catch(MyException const& ex)
+		{
+			failedCallThrows = true;
+		}
+
+		return ret;
+	}
+
 	int storedValueAfterEvent;
+	std::atomic<int> eventCount;
 };
 
 
 void TestClient::EventHandlerTest(ITest* sender, int event)
 {
 	storedValueAfterEvent = event;
+	eventCount++;
 }
 
 }
@@ -189,6 +342,11 @@ TFC_DefineTypeInfo(GDBusServerTestNS::ITestAgain) {
 	{ &GDBusServerTestNS::ITestAgain::FunctionC, "FunctionC" }
 };
 
+TFC_DefineTypeInfo(GDBusServerTestNS::IBlob) {
+	{ &GDBusServerTestNS::IBlob::Echo, "Echo" },
+	{ &GDBusServerTestNS::IBlob::EchoShared, "EchoShared" }
+};
+
 TFC_DefineTypeInfo(GDBusServerTestNS::MyException) {
 	{ TFC::Core::Constructor<GDBusServerTestNS::MyException>(), "Default" },
 	{ TFC::Core::Constructor<GDBusServerTestNS::MyException, std::string>(), "String" }
@@ -302,6 +460,397 @@ TEST_F(GDBusServerTest, GDBusServerCall)
 	ASSERT_STREQ("some123.500000", actualStr.c_str()) << "Invocation via GDBus client server returning string failed";
 }
 
+TEST_F(GDBusServerTest, BenchmarkConcurrentCalls)
+{
+	using namespace GDBusServerTestNS;
+	using Clock = std::chrono::steady_clock;
+	using Ms = std::chrono::milliseconds;
+	int const callCount = 2000;
+
+	TFC::ServiceModel::GDBusServer server({ "com.srin.tfc.RPCTest", RPCTEST_BUS_NAME,  G_BUS_TYPE_NONE, G_BUS_NAME_OWNER_FLAGS_NONE, RPCTEST_BUS_PATH });
+	auto ptr = new ServerBenchmark;
+	ptr->SetName("MyObject");
+
+	server.AddServerObject(ptr);
+	server.Initialize();
+
+	std::this_thread::sleep_for(Ms(1000));
+
+	// Replies of the asynchronous calls are dispatched to this context, iterated by the test itself
+	auto context = g_main_context_new();
+	g_main_context_push_thread_default(context);
+
+	{
+		TestClient client;
+
+		auto start = Clock::now();
+		for(int i = 0; i < callCount; i++)
+			client.FunctionA(i, 2, 3.5, "sync");
+		auto syncElapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+		int completed = 0;
+		int failed = 0;
+		std::string firstResult;
+
+		start = Clock::now();
+		for(int i = 0; i < callCount; i++)
+		{
+			client.FunctionAAsync(i, 2, 3.5, "async", [&] (TFC::ServiceModel::InvokeResult<std::string>& result)
+			{
+				try
+				{
+					if(completed == 0)
+						firstResult = result.Get();
+					else
+						result.Get();
+				}
+				catch(std::exception const& ex)
+				{
+					std::cout << "Asynchronous call failed: " << ex.what() << '\n';
+					failed++;
+				}
+
+				completed++;
+			});
+		}
+
+		while(completed < callCount)
+			g_main_context_iteration(context, TRUE);
+
+		auto asyncElapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+		std::cout << callCount << " calls: synchronous " << syncElapsed << " us (" << (callCount * 1000000LL / syncElapsed)
+				  << " calls/sec), pipelined " << asyncElapsed << " us (" << (callCount * 1000000LL / asyncElapsed) << " calls/sec)\n";
+
+		EXPECT_EQ(0, failed) << "Some asynchronous calls failed";
+		EXPECT_EQ(0u, firstResult.find("async")) << "Asynchronous call returned incorrect string";
+	}
+
+	g_main_context_pop_thread_default(context);
+	g_main_context_unref(context);
+}
+
+TEST_F(GDBusServerTest, BatchInvocation)
+{
+	using namespace GDBusServerTestNS;
+	using Clock = std::chrono::steady_clock;
+	using Ms = std::chrono::milliseconds;
+	int const callCount = 20;
+	int const iteration = 50;
+
+	TFC::ServiceModel::GDBusServer server({ "com.srin.tfc.RPCTest", RPCTEST_BUS_NAME,  G_BUS_TYPE_NONE, G_BUS_NAME_OWNER_FLAGS_NONE, RPCTEST_BUS_PATH });
+	auto ptr = new ServerBenchmark;
+	ptr->SetName("MyObject");
+
+	server.AddServerObject(ptr);
+	server.Initialize();
+
+	std::this_thread::sleep_for(Ms(1000));
+
+	TestClient client;
+
+	bool failedCallThrows = false;
+	auto results = client.FunctionABatch(callCount, failedCallThrows);
+
+	ASSERT_EQ((size_t)callCount, results.size()) << "Batch returned incorrect number of results";
+	for(int i = 0; i < callCount; i++)
+		EXPECT_EQ("batch" + std::to_string(i), results[i]) << "Batch returned incorrect string";
+
+	EXPECT_TRUE(failedCallThrows) << "Exception of a call in the batch was not propagated";
+
+	auto start = Clock::now();
+	for(int i = 0; i < iteration; i++)
+		for(int j = 0; j < callCount; j++)
+			client.FunctionA(j, 2, 3.5, "single");
+	auto singleElapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+	start = Clock::now();
+	for(int i = 0; i < iteration; i++)
+		client.FunctionABatch(callCount, failedCallThrows);
+	auto batchElapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+	std::cout << callCount << " calls: separate " << (singleElapsed / iteration) << " us, batched "
+			  << (batchElapsed / iteration) << " us\n";
+}
+
+TEST_F(GDBusServerTest, WorkerPoolThroughput)
+{
+	using namespace GDBusServerTestNS;
+	using Clock = std::chrono::steady_clock;
+	using Ms = std::chrono::milliseconds;
+	int const objectCount = 4;
+	int const callCount = 50;
+
+	TFC::ServiceModel::GDBusServer server({ "com.srin.tfc.RPCTest", RPCTEST_BUS_NAME,  G_BUS_TYPE_NONE, G_BUS_NAME_OWNER_FLAGS_NONE, RPCTEST_BUS_PATH });
+	server.EnableWorkerPool(objectCount, true);
+
+	for(int i = 0; i < objectCount; i++)
+	{
+		auto ptr = new ServerSlow;
+		ptr->SetName("Worker" + std::to_string(i));
+		server.AddServerObject(ptr);
+	}
+
+	server.Initialize();
+
+	std::this_thread::sleep_for(Ms(1000));
+
+	std::atomic<int> failed { 0 };
+	std::vector<std::thread> clients;
+
+	auto start = Clock::now();
+
+	// Each client hammers its own object, while a second client shares the first object
+	for(int i = 0; i <= objectCount; i++)
+	{
+		clients.emplace_back([i, &failed] ()
+		{
+			std::string objectPath("/com/srin/tfc/RPCTest/Worker");
+			objectPath.append(std::to_string(i % objectCount));
+
+			TestClient client(objectPath.c_str());
+
+			for(int j = 0; j < callCount; j++)
+			{
+				try
+				{
+					if(client.FunctionA(j, 0, 0, "worker").compare("worker" + std::to_string(j)) != 0)
+						failed++;
+				}
+				catch(std::exception const& ex)
+				{
+					std::cout << "Call failed: " << ex.what() << '\n';
+					failed++;
+				}
+			}
+		});
+	}
+
+	for(auto& thread : clients)
+		thread.join();
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+	auto totalCalls = (objectCount + 1) * callCount;
+
+	std::cout << totalCalls << " calls from " << (objectCount + 1) << " clients: " << elapsed << " us ("
+			  << (totalCalls * 1000000LL / elapsed) << " calls/sec), peak concurrent calls " << ServerSlow::peakInFlight << '\n';
+
+	EXPECT_EQ(0, failed.load()) << "Some calls failed or returned incorrect string";
+	EXPECT_EQ(0, ServerSlow::overlapCount.load()) << "Calls to the same object were executed concurrently";
+}
+
+TEST_F(GDBusServerTest, SharedMemoryPayload)
+{
+	using namespace GDBusServerTestNS;
+	using Clock = std::chrono::steady_clock;
+	using Ms = std::chrono::milliseconds;
+	using TFC::ServiceModel::SharedBuffer;
+	size_t const megabyte = 1024 * 1024;
+
+	TFC::ServiceModel::GDBusServer server({ "com.srin.tfc.RPCTest", RPCTEST_BUS_NAME,  G_BUS_TYPE_NONE, G_BUS_NAME_OWNER_FLAGS_NONE, RPCTEST_BUS_PATH });
+	auto ptr = new ServerBlob;
+	ptr->SetName("Blob");
+
+	server.AddServerObject(ptr);
+	server.Initialize();
+
+	std::this_thread::sleep_for(Ms(1000));
+
+	BlobClient client;
+
+	std::vector<uint8_t> small { 1, 2, 3 };
+	EXPECT_EQ(small, client.Echo(small)) << "Inline byte array is not echoed correctly";
+	EXPECT_EQ(small, client.EchoShared(SharedBuffer(small)).ToVector()) << "Small shared buffer is not echoed correctly";
+	EXPECT_EQ(0u, client.EchoShared(SharedBuffer()).GetSize()) << "Empty shared buffer is not echoed correctly";
+
+	for(size_t size = megabyte; size <= 64 * megabyte; size *= 4)
+	{
+		std::vector<uint8_t> blob(size);
+		for(size_t i = 0; i < size; i++)
+			blob[i] = (uint8_t)(i * 31);
+
+		long long inlineElapsed = -1;
+
+		// Message bus limits array to 64 MB, so the inline transfer stops before
+		if(size < 64 * megabyte)
+		{
+			auto start = Clock::now();
+			auto result = client.Echo(blob);
+			inlineElapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+			EXPECT_TRUE(result == blob) << "Inline blob of " << (size / megabyte) << " MB is not echoed correctly";
+		}
+
+		// Writing the shared memory file is part of the transfer
+		auto start = Clock::now();
+		auto result = client.EchoShared(SharedBuffer(blob));
+		auto sharedElapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+		EXPECT_TRUE(result.GetSize() == size && std::equal(blob.begin(), blob.end(), result.GetData()))
+			<< "Shared memory blob of " << (size / megabyte) << " MB is not echoed correctly";
+
+		std::cout << "Echo " << (size / megabyte) << " MB: inline " << inlineElapsed << " us, shared memory " << sharedElapsed << " us\n";
+	}
+}
+
+TEST_F(GDBusServerTest, ConnectionPoolReconnect)
+{
+	using namespace GDBusServerTestNS;
+	using Clock = std::chrono::steady_clock;
+	using Ms = std::chrono::milliseconds;
+	int const clientCount = 100;
+
+	std::unique_ptr<TestClient> longLived;
+
+	{
+		TFC::ServiceModel::GDBusServer server({ "com.srin.tfc.RPCTest", RPCTEST_BUS_NAME,  G_BUS_TYPE_NONE, G_BUS_NAME_OWNER_FLAGS_NONE, RPCTEST_BUS_PATH });
+		auto ptr = new ServerTest;
+		ptr->SetName("MyObject");
+		server.AddServerObject(ptr);
+		server.Initialize();
+
+		std::this_thread::sleep_for(Ms(1000));
+
+		longLived.reset(new TestClient);
+		EXPECT_STREQ("pool123.500000", longLived->FunctionA(1, 2, 3.5, "pool").c_str()) << "Call on the first server failed";
+
+		// Short-lived endpoints share the connection of the long-lived one
+		auto start = Clock::now();
+		for(int i = 0; i < clientCount; i++)
+		{
+			TestClient client;
+			client.FunctionA(i, 2, 3.5, "short");
+		}
+		auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+		std::cout << clientCount << " short-lived clients: " << elapsed << " us (" << (elapsed / clientCount) << " us/client)\n";
+	}
+
+	// The first server closed the shared connection, the client reconnects on its next call
+	TFC::ServiceModel::GDBusServer server({ "com.srin.tfc.RPCTest", RPCTEST_BUS_NAME,  G_BUS_TYPE_NONE, G_BUS_NAME_OWNER_FLAGS_NONE, RPCTEST_BUS_PATH });
+	auto ptr = new ServerTest;
+	ptr->SetName("MyObject");
+	server.AddServerObject(ptr);
+	server.Initialize();
+
+	std::this_thread::sleep_for(Ms(1000));
+
+	EXPECT_STREQ("again123.500000", longLived->FunctionA(1, 2, 3.5, "again").c_str()) << "Client did not reconnect to the new server";
+
+	int random = rand();
+	longLived->FunctionB(random);
+	std::this_thread::sleep_for(Ms(1000));
+	EXPECT_EQ(random, longLived->storedValueAfterEvent) << "Event subscription was not restored after reconnecting";
+}
+
+TEST_F(GDBusServerTest, EventCoalescing)
+{
+	using namespace GDBusServerTestNS;
+	using Ms = std::chrono::milliseconds;
+	int const eventCount = 50;
+
+	TFC::ServiceModel::GDBusServer server({ "com.srin.tfc.RPCTest", RPCTEST_BUS_NAME,  G_BUS_TYPE_NONE, G_BUS_NAME_OWNER_FLAGS_NONE, RPCTEST_BUS_PATH });
+	server.SetEventCoalescing("eventSomething", 200);
+
+	auto ptr = new ServerTest;
+	ptr->SetName("MyObject");
+	server.AddServerObject(ptr);
+
+	server.Initialize();
+
+	std::this_thread::sleep_for(Ms(1000));
+
+	TestClient client;
+
+	// Every call raises the event, but the burst fits in a few coalescing windows
+	for(int i = 0; i < eventCount; i++)
+		client.FunctionB(i);
+
+	std::this_thread::sleep_for(Ms(1000));
+
+	std::cout << eventCount << " events raised, " << client.eventCount << " events received\n";
+
+	EXPECT_EQ(eventCount - 1, client.storedValueAfterEvent) << "Latest event argument was not delivered";
+	EXPECT_GE(client.eventCount.load(), 1) << "No event was delivered";
+	EXPECT_LT(client.eventCount.load(), eventCount) << "Events were not coalesced";
+}
+
+TEST_F(GDBusServerTest, EventUnsubscribe)
+{
+	using namespace GDBusServerTestNS;
+	using Ms = std::chrono::milliseconds;
+
+	TFC::ServiceModel::GDBusServer server({ "com.srin.tfc.RPCTest", RPCTEST_BUS_NAME,  G_BUS_TYPE_NONE, G_BUS_NAME_OWNER_FLAGS_NONE, RPCTEST_BUS_PATH });
+	auto ptr = new ServerTest;
+	ptr->SetName("MyObject");
+	server.AddServerObject(ptr);
+	server.Initialize();
+
+	std::this_thread::sleep_for(Ms(1000));
+
+	TestClient client;
+
+	client.FunctionB(1);
+	std::this_thread::sleep_for(Ms(500));
+	EXPECT_EQ(1, client.eventCount.load()) << "Subscribed event was not delivered";
+
+	client.StopEventSomething();
+
+	client.FunctionB(2);
+	std::this_thread::sleep_for(Ms(500));
+	EXPECT_EQ(1, client.eventCount.load()) << "Event was delivered after unsubscribing";
+	EXPECT_EQ(1, client.storedValueAfterEvent);
+
+	// Clients of the same connection share the subscription, so a destroyed client does not
+	// unsubscribe the others
+	TestClient other;
+
+	{
+		TestClient shortLived;
+	}
+
+	other.FunctionB(3);
+	std::this_thread::sleep_for(Ms(500));
+	EXPECT_EQ(1, other.eventCount.load()) << "Event was not delivered to the client sharing the connection";
+}
+
+TEST_F(GDBusServerTest, SharedBufferReconnect)
+{
+	using namespace GDBusServerTestNS;
+	using Ms = std::chrono::milliseconds;
+	using TFC::ServiceModel::SharedBuffer;
+
+	std::vector<uint8_t> blob(4 * 1024 * 1024);
+	for(size_t i = 0; i < blob.size(); i++)
+		blob[i] = (uint8_t)(i * 31);
+
+	std::unique_ptr<BlobClient> client;
+
+	{
+		TFC::ServiceModel::GDBusServer server({ "com.srin.tfc.RPCTest", RPCTEST_BUS_NAME,  G_BUS_TYPE_NONE, G_BUS_NAME_OWNER_FLAGS_NONE, RPCTEST_BUS_PATH });
+		auto ptr = new ServerBlob;
+		ptr->SetName("Blob");
+		server.AddServerObject(ptr);
+		server.Initialize();
+
+		std::this_thread::sleep_for(Ms(1000));
+
+		client.reset(new BlobClient);
+		EXPECT_EQ(blob, client->EchoShared(SharedBuffer(blob)).ToVector()) << "Shared buffer is not echoed by the first server";
+	}
+
+	TFC::ServiceModel::GDBusServer server({ "com.srin.tfc.RPCTest", RPCTEST_BUS_NAME,  G_BUS_TYPE_NONE, G_BUS_NAME_OWNER_FLAGS_NONE, RPCTEST_BUS_PATH });
+	auto ptr = new ServerBlob;
+	ptr->SetName("Blob");
+	server.AddServerObject(ptr);
+	server.Initialize();
+
+	std::this_thread::sleep_for(Ms(1000));
+
+	// The descriptor of the buffer is sent on the call which reconnects
+	EXPECT_EQ(blob, client->EchoShared(SharedBuffer(blob)).ToVector()) << "Shared buffer is not echoed after reconnecting";
+}
+
 class SomeClass
 {
 public:
@@ -358,6 +907,43 @@ TEST_F(GDBusServerTest, ClassSerializer)
 	ASSERT_EQ(p.c, deserialized.c) << "Deserialized variable c is incorrect";
 }
 
+TEST_F(GDBusServerTest, TypedElementArray)
+{
+	std::vector<SomeClass> list(3);
+	for(int i = 0; i < 3; i++)
+	{
+		list[i].a = i;
+		list[i].b = i * 1.5;
+		list[i].c = -i;
+		list[i].d = "item" + std::to_string(i);
+	}
+
+	std::vector<std::string> names { "first", "second" };
+
+	TFC::ServiceModel::GVariantSerializer ser;
+	ser.Serialize(list);
+	ser.Serialize(names);
+	auto packed = g_variant_ref_sink(ser.EndPack());
+
+	// Elements are stored by their own type instead of boxed in variant
+	ASSERT_STREQ("(a(iidis)as)", g_variant_get_type_string(packed)) << "Array is not typed after its elements";
+
+	TFC::ServiceModel::GVariantDeserializer deser(packed);
+	std::vector<SomeClass> actualList;
+	std::vector<std::string> actualNames;
+	deser.Deserialize(actualList);
+	deser.Deserialize(actualNames);
+
+	ASSERT_EQ(list.size(), actualList.size()) << "Deserialized class array size is incorrect";
+	EXPECT_EQ(2, actualList[2].a) << "Deserialized variable a is incorrect";
+	EXPECT_DOUBLE_EQ(3.0, actualList[2].b) << "Deserialized variable b is incorrect";
+	EXPECT_EQ(-2, actualList[2].c) << "Deserialized variable c is incorrect";
+	EXPECT_EQ("item2", actualList[2].d) << "Deserialized variable d is incorrect";
+	EXPECT_EQ(names, actualNames) << "Deserialized string array is incorrect";
+
+	g_variant_unref(packed);
+}
+
 template<>
 void TFC::ServiceModel::ServerObject<GDBusServerTestNS::ServiceEndpoint, GDBusServerTestNS::ITest>::InitializeInterface()
 {
@@ -372,6 +958,13 @@ void TFC::ServiceModel::ServerObject<GDBusServerTestNS::ServiceEndpoint, GDBusSe
 	RegisterFunction(&ITestAgain::FunctionC, "FunctionC");
 }
 
+template<>
+void TFC::ServiceModel::ServerObject<GDBusServerTestNS::ServiceEndpoint, GDBusServerTestNS::IBlob>::InitializeInterface()
+{
+	RegisterFunction(&IBlob::Echo, "Echo");
+	RegisterFunction(&IBlob::EchoShared, "EchoShared");
+}
+
 class ReflectableClass
 {
 public:
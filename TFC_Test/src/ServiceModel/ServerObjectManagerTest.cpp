@@ -0,0 +1,210 @@
+/*
+ * ServerObjectManagerTest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "TFC/Core/Reflection.h"
+#include "TFC/ServiceModel/GDBusEndpoint.h"
+#include "TFC/ServiceModel/ServerEndpoint.h"
+#include "TFC_Test.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class ServerObjectManagerTest : public testing::Test
+{
+	protected:
+	virtual void SetUp()
+	{
+
+	}
+
+	virtual void TearDown()
+	{
+
+	}
+};
+
+namespace ServerObjectManagerTestNS
+{
+
+struct ServiceEndpoint
+{
+	typedef TFC::ServiceModel::GDBusChannel Channel;
+	static constexpr char const* interfacePrefix = "com.srin.tfc";
+};
+
+class ICounter
+{
+public:
+	virtual int Increment(int by) = 0;
+	virtual ~ICounter() { }
+};
+
+std::atomic<int> liveObjects { 0 };
+std::atomic<int> createdObjects { 0 };
+
+class ServerCounter : public TFC::ServiceModel::ServerObject<ServiceEndpoint, ICounter>
+{
+	int value;
+public:
+	ServerCounter() : value(0) { liveObjects++; createdObjects++; }
+	~ServerCounter() { liveObjects--; }
+
+	virtual int Increment(int by) override
+	{
+		value += by;
+		return value;
+	}
+};
+
+typedef TFC::ServiceModel::ServerObjectManager<ServiceEndpoint, ICounter> CounterManager;
+
+std::unique_ptr<CounterManager> CreateManager(size_t maxObjects, std::chrono::milliseconds idleTimeToLive)
+{
+	return std::unique_ptr<CounterManager> {
+		new CounterManager([] (int id) { return new ServerCounter(); }, maxObjects, idleTimeToLive)
+	};
+}
+
+int Increment(CounterManager& manager, int id, int by)
+{
+	typedef TFC::ServiceModel::GDBusChannel Channel;
+
+	auto param = TFC::Serialization::ParameterSerializer<Channel::Serializer, decltype(&ICounter::Increment)>::Serialize(by);
+	g_variant_ref_sink(param);
+
+	auto result = manager.Invoke(id, "Increment", param);
+	auto value = TFC::Serialization::ObjectDeserializer<Channel::Deserializer, int>::Deserialize(result);
+
+	g_variant_unref(param);
+	g_variant_unref(result);
+	return value;
+}
+
+}
+
+TFC_DefineTypeInfo(ServerObjectManagerTestNS::ICounter) {
+	{ &ServerObjectManagerTestNS::ICounter::Increment, "Increment" }
+};
+
+template<>
+void TFC::ServiceModel::ServerObject<ServerObjectManagerTestNS::ServiceEndpoint, ServerObjectManagerTestNS::ICounter>::InitializeInterface()
+{
+	RegisterFunction(&ServerObjectManagerTestNS::ICounter::Increment, "Increment");
+}
+
+using namespace ServerObjectManagerTestNS;
+
+TEST_F(ServerObjectManagerTest, CreateOnDemand)
+{
+	createdObjects = 0;
+
+	{
+		auto manager = CreateManager(4, std::chrono::milliseconds::zero());
+
+		EXPECT_EQ(1, Increment(*manager, 1, 1)) << "Object of client 1 is not created";
+		EXPECT_EQ(3, Increment(*manager, 1, 2)) << "Object of client 1 does not keep its state";
+		EXPECT_EQ(5, Increment(*manager, 2, 5)) << "Object of client 2 shares the state of client 1";
+
+		EXPECT_EQ(2, createdObjects.load()) << "Object is created more than once for a client";
+		EXPECT_EQ(2u, manager->GetObjectCount()) << "Object count is incorrect";
+
+		// Without time to live, no object is ever idle
+		manager->EvictIdle();
+		EXPECT_EQ(2u, manager->GetObjectCount()) << "Objects are evicted without time to live";
+		EXPECT_EQ(TFC::Core::GetInterfaceName(ServiceEndpoint::interfacePrefix, typeid(ICounter)),
+			std::string(manager->GetInterfaceDefinition().GetInterfaceInfo().name)) << "Interface definition is not initialized";
+	}
+
+	EXPECT_EQ(0, liveObjects.load()) << "Objects are not destroyed with the manager";
+}
+
+TEST_F(ServerObjectManagerTest, EvictLeastRecentlyUsed)
+{
+	createdObjects = 0;
+
+	auto manager = CreateManager(2, std::chrono::milliseconds::zero());
+
+	Increment(*manager, 1, 1);
+	Increment(*manager, 2, 1);
+
+	// Touching client 1 makes client 2 the least recently used
+	Increment(*manager, 1, 1);
+	Increment(*manager, 3, 1);
+
+	EXPECT_TRUE(manager->Contains(1)) << "Recently used object is evicted";
+	EXPECT_FALSE(manager->Contains(2)) << "Least recently used object is not evicted";
+	EXPECT_TRUE(manager->Contains(3)) << "New object is not stored";
+	EXPECT_EQ(2, liveObjects.load()) << "Evicted object is not destroyed";
+
+	// Evicted client starts again with a new object
+	EXPECT_EQ(10, Increment(*manager, 2, 10)) << "Evicted object is reused";
+	EXPECT_EQ(4, createdObjects.load()) << "Evicted object is not re-created";
+	EXPECT_FALSE(manager->Contains(1)) << "Least recently used object is not evicted";
+	EXPECT_EQ(2u, manager->GetObjectCount()) << "Object count exceeds the limit";
+}
+
+TEST_F(ServerObjectManagerTest, FactoryRunsWithoutLock)
+{
+	CounterManager* owner = nullptr;
+	size_t countInFactory = 0;
+
+	// Factory which calls back into the manager would deadlock if it runs under the lock
+	CounterManager manager([&] (int id) {
+		countInFactory = owner->GetObjectCount();
+		return new ServerCounter();
+	}, 4);
+	owner = &manager;
+
+	Increment(manager, 1, 1);
+	Increment(manager, 2, 1);
+
+	EXPECT_EQ(1u, countInFactory) << "Factory does not see the objects created before";
+	EXPECT_EQ(2u, manager.GetObjectCount()) << "Object count is incorrect";
+}
+
+TEST_F(ServerObjectManagerTest, EvictIdleObjects)
+{
+	using Ms = std::chrono::milliseconds;
+
+	createdObjects = 0;
+
+	std::unique_ptr<CounterManager> manager;
+
+	// The eviction timer is an ecore timer, so the manager is created on the main loop
+	EFL_BLOCK_BEGIN;
+		EFL_SYNC_BEGIN(manager);
+			manager = CreateManager(8, Ms(200));
+		EFL_SYNC_END;
+	EFL_BLOCK_END;
+
+	Increment(*manager, 1, 1);
+	std::this_thread::sleep_for(Ms(250));
+	Increment(*manager, 2, 1);
+
+	manager->EvictIdle();
+
+	EXPECT_FALSE(manager->Contains(1)) << "Idle object is not evicted";
+	EXPECT_TRUE(manager->Contains(2)) << "Recently used object is evicted";
+
+	// Periodic eviction removes the remaining object once it becomes idle
+	std::this_thread::sleep_for(Ms(700));
+
+	EXPECT_EQ(0u, manager->GetObjectCount()) << "Idle objects are not evicted periodically";
+	EXPECT_EQ(0, liveObjects.load()) << "Evicted objects are not destroyed";
+
+	EXPECT_EQ(1, Increment(*manager, 1, 1)) << "Idle object is not re-created";
+	EXPECT_EQ(3, createdObjects.load()) << "Idle object is not re-created";
+
+	EFL_BLOCK_BEGIN;
+		EFL_SYNC_BEGIN(manager);
+			manager.reset();
+		EFL_SYNC_END;
+	EFL_BLOCK_END;
+}
@@ -0,0 +1,117 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Net/ConnectionPool.h
+ *
+ * Pool of libcurl handles which reuse connections between requests
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#ifndef TFCFW_CONNECTIONPOOL_H_
+#define TFCFW_CONNECTIONPOOL_H_
+
+#include "TFC/Core.h"
+
+#include <curl/curl.h>
+#include <mutex>
+#include <vector>
+
+namespace TFC {
+namespace Net {
+
+/**
+ * Pool of libcurl easy handles which share the DNS cache, the TLS session cache, and the
+ * connection cache. Successive requests to the same host reuse the established connection instead
+ * of performing the TCP and TLS handshake again. Handles are reset when they are returned to the
+ * pool, which clears their options but keeps their connections alive.
+ */
+class LIBAPI ConnectionPool
+{
+public:
+	/**
+	 * Easy handle acquired from the pool, which is returned to the pool on destruction.
+	 */
+	class LIBAPI Handle
+	{
+	public:
+		Handle(Handle&& other);
+		~Handle();
+
+		Handle(Handle const&) = delete;
+		Handle& operator=(Handle const&) = delete;
+
+		/**
+		 * Get the easy handle, which is null if libcurl failed to create the handle.
+		 */
+		CURL* Get() const { return handle; }
+		operator CURL*() const { return handle; }
+
+	private:
+		friend class ConnectionPool;
+		Handle(ConnectionPool* pool, CURL* handle);
+
+		ConnectionPool* pool;
+		CURL* handle;
+	};
+
+	/**
+	 * Constructor of ConnectionPool.
+	 *
+	 * @param maxIdleHandles Maximum number of handles kept in the pool while they are not used.
+	 */
+	ConnectionPool(size_t maxIdleHandles = 8);
+	~ConnectionPool();
+
+	/**
+	 * Get the pool shared by the REST services.
+	 */
+	static ConnectionPool& GetDefault();
+
+	/**
+	 * Acquire a handle from the pool, or create a new handle if no handle is idle. The handle
+	 * which is used most recently is preferred, as its connections are the most likely to be alive.
+	 */
+	Handle Acquire();
+
+	size_t GetIdleHandleCount();
+
+	/**
+	 * Let a handle which is not acquired from the pool use the caches shared by the pool, e.g.
+	 * the handle duplicated from a pooled handle, as the duplicate does not keep the share option.
+	 *
+	 * @param handle Easy handle which uses the caches of the pool.
+	 */
+	void Share(CURL* handle);
+
+private:
+	void Release(CURL* handle);
+
+	friend void ConnectionPool_Lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+	friend void ConnectionPool_Unlock(CURL* handle, curl_lock_data data, void* userptr);
+
+	CURLSH* share;
+	std::mutex shareLock[CURL_LOCK_DATA_LAST];
+
+	std::mutex poolLock;
+	std::vector<CURL*> idleHandles;
+	size_t maxIdleHandles;
+};
+
+}
+}
+
+#endif /* TFCFW_CONNECTIONPOOL_H_ */
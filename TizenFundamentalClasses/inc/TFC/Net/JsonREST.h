@@ -0,0 +1,100 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Net/JsonREST.h
+ *
+ * REST service base class which deserializes JSON response automatically
+ * using TFC Serialization Templates
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#ifndef TFC_NET_JSONREST_H_
+#define TFC_NET_JSONREST_H_
+
+#include <memory>
+#include <dlog.h>
+
+#include "TFC/Net/REST.h"
+#include "TFC/Serialization/JsonSerializer.h"
+
+namespace TFC {
+namespace Net {
+
+/**
+ * Base class for a REST Service which response body is a JSON text. The response is deserialized
+ * directly into ResponseType, which has to be declared using TFC_DefineTypeSerializationInfo, or
+ * a std::vector of such type.
+ */
+template<class ResponseType>
+class JsonRESTServiceBase: public RESTServiceBase<ResponseType>
+{
+protected:
+	/**
+	 * Constructor for JsonRESTServiceBase.
+	 *
+	 * @param url The base URL of the request.
+	 * @param httpMode HTTP Mode of the request.
+	 */
+	JsonRESTServiceBase(std::string url, HTTPMode httpMode) :
+		RESTServiceBase<ResponseType>(url, httpMode)
+	{
+	}
+
+	/**
+	 * Implement OnProcessResponse that deserializes the JSON response body. Responses with HTTP
+	 * error code are not deserialized, and the response body is returned as error message instead.
+	 *
+	 * @param httpCode HTTP code of the response.
+	 * @param responseStr String reference of the response body.
+	 * @param errorCode Error code of the response.
+	 * @param errorMessage Error message of the response.
+	 *
+	 * @return Pointer to the deserialized response object.
+	 */
+	virtual ResponseType* OnProcessResponse(int httpCode, const std::string& responseStr, int& errorCode,
+		std::string& errorMessage) override
+	{
+		if(httpCode >= 400)
+		{
+			errorCode = httpCode;
+			errorMessage = responseStr;
+			return nullptr;
+		}
+
+		std::unique_ptr<ResponseType> ret(new ResponseType);
+
+		try
+		{
+			Serialization::JsonDeserializer deser(responseStr);
+			Serialization::GenericDeserializer<Serialization::JsonDeserializer, ResponseType>::Deserialize(deser, *ret);
+			deser.Finalize();
+		}
+		catch(Serialization::SerializationException const& ex)
+		{
+			dlog_print(DLOG_ERROR, "TFC-REST", "Failed parsing JSON response: %s", ex.what());
+			errorCode = -1;
+			errorMessage = ex.what();
+			return nullptr;
+		}
+
+		return ret.release();
+	}
+};
+
+}}
+
+#endif /* TFC_NET_JSONREST_H_ */
@@ -27,6 +27,11 @@
 
 #include "TFC/Core.h"
 
+#include <curl/curl.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <tuple>
 #include <vector>
 #include <unordered_map>
@@ -34,6 +39,12 @@
 namespace TFC {
 namespace Net {
 
+class ConnectionPool;
+class ResponseCache;
+struct CachedResponse;
+class RequestPolicy;
+class RESTStatistics;
+
 /**
  * Enumeration for various HTTP request methods.
  */
@@ -103,6 +114,59 @@ protected:
 	virtual std::string GetEncodedValue();
 };
 
+/**
+ * Timing and size of the transfer of a request, as measured by libcurl. Each time is measured from
+ * the start of the transfer, so the time spent in a phase is the difference to the previous phase.
+ * Retried requests report the last attempt only.
+ */
+struct LIBAPI TransferMetrics
+{
+	/**
+	 * Constructor of TransferMetrics, which sets every value to zero.
+	 */
+	TransferMetrics();
+
+	/**
+	 * Time until the host name is resolved, the connection is established, and the TLS handshake
+	 * is completed. They are zero if an existing connection is reused.
+	 */
+	std::chrono::microseconds nameLookupTime;
+	std::chrono::microseconds connectTime;
+	std::chrono::microseconds appConnectTime;
+
+	/**
+	 * Time until the first byte of the response is received.
+	 */
+	std::chrono::microseconds startTransferTime;
+
+	/**
+	 * Time until the response is completely received.
+	 */
+	std::chrono::microseconds totalTime;
+
+	/**
+	 * Size of the request body sent and the response body received, before decompression.
+	 */
+	uint64_t bytesUploaded;
+	uint64_t bytesDownloaded;
+
+	/**
+	 * Number of attempts, which is more than one if the request is retried, or zero if the
+	 * response is served from the cache.
+	 */
+	int attempts;
+
+	/**
+	 * Whether the request is sent on a connection kept from a previous request.
+	 */
+	bool connectionReused;
+
+	/**
+	 * Whether the response is served from the cache without contacting the server.
+	 */
+	bool cached;
+};
+
 /**
  * Base class for holding response from a REST call.
  */
@@ -139,6 +203,12 @@ public:
 	 */
 	std::string errorMessage;
 
+	/**
+	 * Timing and size of the transfer. Requests which share an identical request in progress
+	 * receive the metrics of that request.
+	 */
+	TransferMetrics metrics;
+
 	/**
 	 * Enable access to private/protected member of base REST service class
 	 */
@@ -182,6 +252,7 @@ public:
 		httpCode = p.httpCode;
 		errorCode = p.errorCode;
 		errorMessage = std::move(p.errorMessage);
+		metrics = p.metrics;
 	}
 
 	/**
@@ -210,6 +281,7 @@ public:
 		httpCode = p.httpCode;
 		errorCode = p.errorCode;
 		errorMessage = p.errorMessage;
+		metrics = p.metrics;
 	}
 
 	RESTResult& operator=(RESTResult&& p)
@@ -221,6 +293,7 @@ public:
 		httpCode = p.httpCode;
 		errorCode = p.errorCode;
 		errorMessage = std::move(p.errorMessage);
+		metrics = p.metrics;
 		return *this;
 	}
 
@@ -231,6 +304,12 @@ public:
 
 };
 
+/*
+ * libcurl callbacks of RESTServiceTemplateBase, which receive the transfer state as their user data
+ */
+size_t RESTServiceTemplateBase_WriteCallback(char* data, size_t size, size_t nmemb, void* d);
+size_t RESTServiceTemplateBase_HeaderCallback(char* data, size_t size, size_t nmemb, void* d);
+
 /**
  * Base template for REST Service.
  * It defines a Parameter class and handles request building.
@@ -292,9 +371,86 @@ protected:
 	virtual void OnAfterUrlReady(std::string& url) {}
 	virtual void OnAfterPOSTDataReady(std::string& postData) {}
 
+	/**
+	 * Method to receive a chunk of the response body as soon as it arrives, which is called only if
+	 * StreamResponse is set. It allows the response to be parsed incrementally or written to a file
+	 * without keeping the whole body in memory.
+	 *
+	 * @param httpCode HTTP code of the response.
+	 * @param data Pointer to the chunk, which is valid only during the call.
+	 * @param length Length of the chunk.
+	 *
+	 * @return true to continue receiving the response, false to abort the request.
+	 */
+	virtual bool OnResponseChunk(int httpCode, char const* data, size_t length) { return true; }
+
 	std::string UserAgent, Url, FinalUrl;
+
+	/**
+	 * Pass the response body to OnResponseChunk instead of buffering it. The response string received
+	 * by OnProcessResponse is empty in this mode.
+	 */
+	bool StreamResponse;
+
+	/**
+	 * Advertise every content encoding supported by libcurl, such as gzip, deflate, and br, which
+	 * is decoded before the response is processed. Default is true.
+	 */
+	bool AcceptCompressedResponse;
+
+	/**
+	 * Size from which the POST and PUT data is sent compressed with "Content-Encoding: gzip", or zero
+	 * to never compress it, which is the default. The server must support compressed requests.
+	 */
+	size_t CompressRequestThreshold;
+
+	/**
+	 * Negotiate HTTP/2 on HTTPS connections, which falls back to HTTP/1.1 if the server does not
+	 * support it. Requests submitted to RESTEngine are multiplexed on a single HTTP/2 connection
+	 * to the server. It only applies to RESTEngine, as the requests performed by Call() share the
+	 * connections of the pool between threads, which is not supported for multiplexed connections.
+	 * Default is true.
+	 */
+	bool PreferHTTP2;
+
+	/**
+	 * Cache which stores the response of GET requests, or null to disable caching, which is the
+	 * default. The key of the response is the final URL and the request headers, so responses
+	 * requested with different credentials are not mixed. Streamed responses are not cached.
+	 *
+	 * The storage of the cache is read and written on the thread which performs the request. A
+	 * service using a cache with a storage path should be performed with Call() on a worker thread,
+	 * as CallAsync() performs the request on the main loop, which is blocked by the disk I/O. A
+	 * cache which keeps the responses in memory only can be used with both.
+	 */
+	ResponseCache* Cache;
+
+	/**
+	 * Policy which sets the timeouts, the retries, and the hedging of the requests, and records
+	 * their latency. Default is RequestPolicy::GetDefault(), which only sets the timeouts. Services
+	 * of the same server usually share a static policy, so its statistics describe that server.
+	 */
+	RequestPolicy* Policy;
+
+	/**
+	 * Registry which aggregates the metrics of the transfers by endpoint, or null to disable it.
+	 * Default is null, as recording locks the registry on every request. Set it to
+	 * RESTStatistics::GetDefault() or to a registry of the service. The endpoint is the HTTP method
+	 * and Url, so requests with different URL parameters are counted as the same endpoint.
+	 */
+	RESTStatistics* Statistics;
 	RESTResultBase CallInternal();
 
+	/**
+	 * Build the URL by replacing each {name} in Url with the encoded value of the URL parameter with
+	 * the same name. The template is parsed once, and parsed again only if Url is changed.
+	 *
+	 * @throw std::runtime_error if a parameter in the template is not registered or not set.
+	 */
+	std::string PrepareUrl();
+
+	void CallAsyncInternal(std::function<void(RESTResultBase&&)> onComplete);
+
 	HTTPMode httpMode;
 
 	std::vector<std::pair<char const*, IServiceParameter*>> queryStringParam;
@@ -308,13 +464,102 @@ private:
 	{
 		return nullptr;
 	}
+	/**
+	 * Data which has to be kept alive while the request is transferred.
+	 */
+	struct TransferState
+	{
+		RESTServiceTemplateBase* service;
+		CURL* handle;
+		std::string buffer;
+		std::string postData;
+		struct curl_slist* headerList;
+
+		std::string cacheKey;
+		std::shared_ptr<CachedResponse const> cachedResponse;
+		bool cacheHit;
+
+		// Response headers which control the caching
+		std::string eTag;
+		std::string lastModified;
+		std::string cacheControl;
+		std::string expires;
+
+		// Identical requests with the same key share a single transfer
+		std::string sharedKey;
+
+		// Response code of the completed attempt, read before a duplicate request is discarded
+		long responseCode;
+
+		int attempt;
+		std::chrono::steady_clock::time_point attemptStart;
+
+		// Streamed response cannot be retried after a chunk is delivered
+		bool responseStarted;
+
+		TransferMetrics metrics;
+
+		TransferState();
+		~TransferState();
+
+		/**
+		 * Discard the response of the failed attempt before the request is retried.
+		 */
+		void ResetResponse();
+
+		/**
+		 * Take the response received by the duplicate request.
+		 */
+		void AdoptResponse(TransferState& hedge);
+
+		/**
+		 * Read the response code and the metrics of the completed attempt from the handle.
+		 */
+		void ReadTransferInfo(CURL* completedHandle);
+	};
+
+	friend class RESTEngine;
+	friend size_t RESTServiceTemplateBase_WriteCallback(char* data, size_t size, size_t nmemb, void* d);
+	friend size_t RESTServiceTemplateBase_HeaderCallback(char* data, size_t size, size_t nmemb, void* d);
+
 	RESTResultBase PerformCall();
+	bool PrepareTransfer(CURL* curlHandle, TransferState& state, bool multiplexed);
+	RESTResultBase CompleteTransfer(CURLcode res, TransferState& state);
+	RESTResultBase PerformSharedCall(CURL* curlHandle, TransferState& state);
+	CURLcode PerformTransfer(CURL* curlHandle, TransferState& state);
+	CURLcode PerformHedgedTransfer(CURL* curlHandle, TransferState& state, std::chrono::milliseconds delay);
+	CURL* StartHedge(ConnectionPool& pool, CURL* curlHandle, TransferState& state, TransferState& hedge);
+	bool ShouldHedge(std::chrono::milliseconds& delay);
+	bool ShouldRetry(CURLcode res, TransferState const& state);
+	std::string const& ResolveResponse(CURLcode& res, int& httpCode, TransferState& state);
+	RESTResultBase ProcessResponse(CURLcode res, int httpCode, std::string const& body, TransferMetrics const& metrics);
+	void RecordStatistics(CURLcode res, int httpCode, TransferState const& state);
+	std::string GetRequestIdentity(TransferState const& state);
+	void PrepareCache(TransferState& state);
+	std::string const& UpdateCache(int& httpCode, TransferState& state);
 	void RegisterParameter(ParameterType paramType, char const* key, IServiceParameter* ref);
 
 	bool working;
 
+	/**
+	 * Span of the URL template, which is either a literal text or the name of a URL parameter.
+	 */
+	struct UrlToken
+	{
+		size_t offset;
+		size_t length;
+		bool isParameter;
+
+		// Resolved when the URL is prepared first, as parameters are registered after construction
+		IServiceParameter* parameter;
+	};
+
+	void ParseUrlTemplate();
+
+	std::string urlTemplate;
+	std::vector<UrlToken> urlTokens;
+
 	struct curl_slist* PrepareHeader();
-	std::string PrepareUrl();
 	std::string PrepareQueryString();
 };
 
@@ -383,6 +628,20 @@ public:
 		return std::move(CallInternal());
 	}
 
+	/**
+	 * Perform the REST request without blocking the calling thread. The request is transferred by
+	 * the default RESTEngine, so it must be called on the main loop thread, and the service object
+	 * must be kept alive until the completion function is called on the main loop thread.
+	 *
+	 * @param onComplete Function which receives the result of the request.
+	 */
+	void CallAsync(std::function<void(RESTResult<ResponseType>)> onComplete)
+	{
+		CallAsyncInternal([onComplete] (RESTResultBase&& result) {
+			onComplete(RESTResult<ResponseType>(std::move(result)));
+		});
+	}
+
 	/**
 	 * Destructor of RESTServiceBase.
 	 */
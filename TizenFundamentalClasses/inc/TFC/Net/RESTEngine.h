@@ -0,0 +1,121 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Net/RESTEngine.h
+ *
+ * Engine to perform concurrent REST requests on the main loop
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#ifndef TFCFW_RESTENGINE_H_
+#define TFCFW_RESTENGINE_H_
+
+#include "TFC/Net/ConnectionPool.h"
+#include "TFC/Net/REST.h"
+
+#include <Ecore.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TFC {
+namespace Net {
+
+/**
+ * Engine which transfers REST requests concurrently using libcurl multi interface. The sockets and
+ * the timeouts of the transfers are watched by ecore fd handlers and timers, so the requests are
+ * performed by the main loop without any additional thread. All members must be called on the
+ * main loop thread, and the completion functions are also called on the main loop thread.
+ */
+class LIBAPI RESTEngine
+{
+public:
+	typedef std::function<void(RESTResultBase&&)> CompletionHandler;
+
+	/**
+	 * Constructor of RESTEngine.
+	 *
+	 * @param pool Pool which provides the handles of the transfers. Transfers to HTTP/2 servers
+	 * 			   are multiplexed, so the pool should not be used by other threads at the same time.
+	 */
+	RESTEngine(ConnectionPool& pool = ConnectionPool::GetDefault());
+
+	/**
+	 * Destructor of RESTEngine. Transfers which are not complete are aborted without calling their
+	 * completion function.
+	 */
+	~RESTEngine();
+
+	/**
+	 * Get the engine used by RESTServiceBase::CallAsync.
+	 */
+	static RESTEngine& GetDefault();
+
+	/**
+	 * Start transferring the request of the service. The service must be kept alive and must not be
+	 * called again until the completion function is called. A GET request identical to a request in
+	 * progress is not transferred again, but completed with the response of that request. The
+	 * retries and the hedging of the request follow the policy of the service. The cache of the
+	 * service is looked up and updated on the main loop, so its storage should not be on disk, see
+	 * RESTServiceTemplateBase::Cache. The completion function is called by the main loop after
+	 * Submit returns, even if the response is served from the cache.
+	 *
+	 * @param service Service to be called.
+	 * @param onComplete Function which receives the result of the request.
+	 */
+	void Submit(RESTServiceTemplateBase& service, CompletionHandler onComplete);
+
+	size_t GetActiveTransferCount() const { return transfers.size(); }
+
+private:
+	struct Transfer;
+	struct Waiter;
+	struct Completion;
+
+	friend int RESTEngine_SocketCallback(CURL* easy, curl_socket_t socket, int what, void* userp, void* socketp);
+	friend int RESTEngine_TimerCallback(CURLM* multi, long timeoutMs, void* userp);
+	friend Eina_Bool RESTEngine_FdHandlerCallback(void* data, Ecore_Fd_Handler* handler);
+	friend Eina_Bool RESTEngine_TimeoutCallback(void* data);
+	friend Eina_Bool RESTEngine_TransferTimerCallback(void* data);
+	friend void RESTEngine_CompletionJob(void* data);
+
+	void WatchSocket(curl_socket_t socket, int what, Ecore_Fd_Handler* handler);
+	void ScheduleTimeout(long timeoutMs);
+	void OnSocketReady(Ecore_Fd_Handler* handler);
+	void OnTimeout();
+	void ProcessCompletedTransfers();
+	void CompleteLater(CompletionHandler onComplete, RESTResultBase&& result);
+	void StartAttempt(Transfer& transfer);
+	void OnTransferTimer(Transfer& transfer);
+	void DiscardHedge(Transfer& transfer);
+
+	ConnectionPool& pool;
+	CURLM* multi;
+	Ecore_Timer* timer;
+	std::unordered_map<CURL*, std::unique_ptr<Transfer>> transfers;
+	std::unordered_map<std::string, Transfer*> sharedTransfers;
+
+	// Handles of the duplicate requests, which belong to the transfers in progress
+	std::unordered_map<CURL*, Transfer*> hedges;
+};
+
+}
+}
+
+#endif /* TFCFW_RESTENGINE_H_ */
@@ -0,0 +1,182 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Net/RESTStatistics.h
+ *
+ * Registry of the transfer metrics of REST services by endpoint
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#ifndef TFCFW_RESTSTATISTICS_H_
+#define TFCFW_RESTSTATISTICS_H_
+
+#include "TFC/Core.h"
+#include "TFC/Net/REST.h"
+#include "TFC/Net/Util.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TFC {
+namespace Net {
+
+/**
+ * Registry which aggregates the metrics of the requests by endpoint, to show where the time of the
+ * requests is spent. Counters cover every recorded request, while the percentiles are computed from
+ * a window of the most recent requests of each endpoint. A registry can be shared by services on
+ * different threads.
+ */
+class LIBAPI RESTStatistics
+{
+public:
+	/**
+	 * Percentiles of a time in the recent requests.
+	 */
+	struct Percentiles
+	{
+		std::chrono::microseconds p50;
+		std::chrono::microseconds p90;
+		std::chrono::microseconds p99;
+		std::chrono::microseconds max;
+	};
+
+	struct Endpoint
+	{
+		/**
+		 * Number of recorded requests, including the failed requests and the cached responses.
+		 */
+		uint64_t requests;
+
+		/**
+		 * Requests which fail to transfer or receive an HTTP error code.
+		 */
+		uint64_t failures;
+
+		/**
+		 * Requests served from the cache, which are not included in the percentiles.
+		 */
+		uint64_t cached;
+
+		/**
+		 * Requests sent on a connection kept from a previous request.
+		 */
+		uint64_t reusedConnections;
+
+		uint64_t bytesUploaded;
+		uint64_t bytesDownloaded;
+
+		/**
+		 * Percentiles of each time in TransferMetrics.
+		 */
+		Percentiles nameLookupTime;
+		Percentiles connectTime;
+		Percentiles appConnectTime;
+		Percentiles startTransferTime;
+		Percentiles totalTime;
+	};
+
+	/**
+	 * Constructor of RESTStatistics.
+	 *
+	 * @param windowSize Number of recent requests of each endpoint used for the percentiles.
+	 */
+	RESTStatistics(size_t windowSize = 256);
+
+	/**
+	 * Get the registry shared by the services which opt in by setting their Statistics member to
+	 * it. Services record nothing by default.
+	 */
+	static RESTStatistics& GetDefault();
+
+	/**
+	 * Add the metrics of a request to the endpoint.
+	 *
+	 * @param endpoint Name of the endpoint.
+	 * @param success Whether the request receives a successful response.
+	 * @param metrics Metrics of the request.
+	 */
+	void Record(std::string const& endpoint, bool success, TransferMetrics const& metrics);
+
+	/**
+	 * Get the statistics of the endpoint, which are zero if no request is recorded for it.
+	 */
+	Endpoint GetStatistics(std::string const& endpoint) const;
+
+	/**
+	 * Get the statistics of every endpoint, sorted by the name of the endpoint.
+	 */
+	std::map<std::string, Endpoint> GetStatistics() const;
+
+	/**
+	 * Format the statistics of every endpoint as text, one line per endpoint, with the times in
+	 * milliseconds.
+	 */
+	std::string Dump() const;
+
+	/**
+	 * Write the statistics of every endpoint to the log.
+	 */
+	void DumpToLog() const;
+
+	void Reset();
+
+private:
+	// Times of a request in microseconds, in the order of TransferMetrics
+	struct Sample
+	{
+		int64_t nameLookupTime;
+		int64_t connectTime;
+		int64_t appConnectTime;
+		int64_t startTransferTime;
+		int64_t totalTime;
+	};
+
+	struct EndpointState
+	{
+		uint64_t requests;
+		uint64_t failures;
+		uint64_t cached;
+		uint64_t reusedConnections;
+		uint64_t bytesUploaded;
+		uint64_t bytesDownloaded;
+
+		// Recent transfers
+		SampleWindow<Sample> samples;
+
+		EndpointState(size_t windowSize) :
+			requests(0), failures(0), cached(0), reusedConnections(0), bytesUploaded(0),
+			bytesDownloaded(0), samples(windowSize)
+		{
+		}
+	};
+
+	Endpoint Summarize(EndpointState const& state) const;
+
+	size_t windowSize;
+
+	mutable std::mutex statisticsLock;
+	std::map<std::string, EndpointState> endpoints;
+};
+
+}
+}
+
+#endif /* TFCFW_RESTSTATISTICS_H_ */
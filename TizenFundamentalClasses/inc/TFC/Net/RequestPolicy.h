@@ -0,0 +1,187 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Net/RequestPolicy.h
+ *
+ * Timeout, retry, and hedging policy of REST services
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#ifndef TFCFW_REQUESTPOLICY_H_
+#define TFCFW_REQUESTPOLICY_H_
+
+#include "TFC/Core.h"
+#include "TFC/Net/Util.h"
+
+#include <curl/curl.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace TFC {
+namespace Net {
+
+/**
+ * Policy which controls how the requests of REST services are transferred, and collects the latency
+ * of the transfers. Services which call the same server usually share one policy, so the latency
+ * statistics describe that server. A policy can be shared by services on different threads.
+ *
+ * Failed requests are retried only if their HTTP method is idempotent (GET, PUT, and DELETE). A
+ * request is hedged by sending a duplicate request when the response is not received within the
+ * latency percentile of the previous requests, and the first successful response is used. Hedging
+ * applies only to GET requests.
+ */
+class LIBAPI RequestPolicy
+{
+public:
+	struct Statistics
+	{
+		/**
+		 * Number of successful transfers whose latency is recorded.
+		 */
+		uint64_t transfers;
+
+		/**
+		 * Number of failed attempts which are retried.
+		 */
+		uint64_t retries;
+
+		/**
+		 * Number of duplicate requests sent, and the number of those which respond first.
+		 */
+		uint64_t hedges;
+		uint64_t hedgeWins;
+
+		/**
+		 * Latency percentiles of the recent successful transfers.
+		 */
+		std::chrono::microseconds p50;
+		std::chrono::microseconds p90;
+		std::chrono::microseconds p99;
+		std::chrono::microseconds max;
+	};
+
+	/**
+	 * Constructor of RequestPolicy, which has the same settings as the default policy.
+	 */
+	RequestPolicy();
+
+	/**
+	 * Get the policy used by the services which do not set their own policy. It only sets the
+	 * timeouts, so a stalled server does not block the request indefinitely.
+	 */
+	static RequestPolicy& GetDefault();
+
+	/**
+	 * Maximum time to establish the connection. Default is 30 seconds.
+	 */
+	std::chrono::milliseconds ConnectTimeout;
+
+	/**
+	 * Maximum time of the whole transfer, or zero for no limit, which is the default.
+	 */
+	std::chrono::milliseconds TotalTimeout;
+
+	/**
+	 * Maximum time without receiving any data before the transfer is aborted, or zero for no limit.
+	 * Default is 60 seconds.
+	 */
+	std::chrono::milliseconds StallTimeout;
+
+	/**
+	 * Number of times a failed request is retried. Default is zero.
+	 */
+	int MaxRetries;
+
+	/**
+	 * Delay before the first retry, which is doubled for every following retry up to MaxBackoff.
+	 * The actual delay is a random duration up to that delay, so clients which fail at the same
+	 * time do not retry at the same time.
+	 */
+	std::chrono::milliseconds BaseBackoff;
+	std::chrono::milliseconds MaxBackoff;
+
+	/**
+	 * Latency percentile, between 0 and 1, after which a duplicate request is sent, or zero to
+	 * disable hedging, which is the default. For example, 0.95 hedges the requests which are slower
+	 * than 95% of the recent requests.
+	 */
+	double HedgePercentile;
+
+	/**
+	 * Minimum delay before a duplicate request is sent, so fast servers are not flooded.
+	 */
+	std::chrono::milliseconds MinHedgeDelay;
+
+	/**
+	 * Minimum number of recorded transfers before requests are hedged.
+	 */
+	size_t MinHedgeSamples;
+
+	Statistics GetStatistics() const;
+
+	/**
+	 * Check whether the result of an attempt should be retried, which are the network errors, the
+	 * timeouts, and the HTTP codes 502, 503, and 504.
+	 */
+	virtual bool IsRetryable(CURLcode res, long httpCode) const;
+
+	/**
+	 * Get the randomized delay before the retry.
+	 *
+	 * @param attempt Number of the attempt which failed, starting from 1.
+	 */
+	std::chrono::milliseconds GetBackoff(int attempt) const;
+
+	/**
+	 * Get the delay before a duplicate request is sent.
+	 *
+	 * @return true if the request should be hedged, false otherwise.
+	 */
+	bool GetHedgeDelay(std::chrono::milliseconds& delay) const;
+
+	/**
+	 * Set the timeouts of the policy on the curl handle.
+	 */
+	void ApplyTimeouts(CURL* curlHandle) const;
+
+	void RecordLatency(std::chrono::steady_clock::duration latency);
+
+	virtual ~RequestPolicy();
+
+private:
+	friend class RESTServiceTemplateBase;
+	friend class RESTEngine;
+
+	mutable std::mutex latencyLock;
+
+	// Latencies of the recent transfers, in microseconds
+	SampleWindow<int64_t> latencySamples;
+
+	std::atomic<uint64_t> transferCount;
+	std::atomic<uint64_t> retryCount;
+	std::atomic<uint64_t> hedgeCount;
+	std::atomic<uint64_t> hedgeWinCount;
+};
+
+}
+}
+
+#endif /* TFCFW_REQUESTPOLICY_H_ */
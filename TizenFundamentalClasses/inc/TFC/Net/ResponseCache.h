@@ -0,0 +1,180 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Net/ResponseCache.h
+ *
+ * Cache of HTTP responses for REST services
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#ifndef TFCFW_RESPONSECACHE_H_
+#define TFCFW_RESPONSECACHE_H_
+
+#include "TFC/Core.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace TFC {
+namespace Net {
+
+/**
+ * Response stored in the cache with the information to validate it.
+ */
+struct CachedResponse
+{
+	int httpCode;
+	std::string body;
+
+	/**
+	 * Validators sent by the server, which are empty if the server does not send them.
+	 */
+	std::string eTag;
+	std::string lastModified;
+
+	/**
+	 * Time until the response can be used without validating it to the server.
+	 */
+	std::chrono::system_clock::time_point expiresAt;
+};
+
+/**
+ * Cache of GET responses, which is used by REST services that set their Cache member. Responses are
+ * kept in memory up to the maximum number of entries, with the least recently used response evicted
+ * first. If a storage path is specified, responses are also written to that directory so they
+ * survive restarts of the application, up to the maximum storage size, with the least recently
+ * written file removed first. A fresh response is served without contacting the server,
+ * while a stale response is validated with If-None-Match or If-Modified-Since, and served again if
+ * the server answers 304 Not Modified. Requests with Authorization, Proxy-Authorization or Cookie
+ * header are not cached, and the storage only contains a hash of the key, so the tokens in the URL
+ * are not written to it.
+ */
+class LIBAPI ResponseCache
+{
+public:
+	struct Statistics
+	{
+		/**
+		 * Requests served from a fresh response without contacting the server.
+		 */
+		uint64_t hits;
+
+		/**
+		 * Requests served from a stale response after the server answered 304 Not Modified.
+		 */
+		uint64_t revalidations;
+
+		/**
+		 * Requests whose response is received from the server.
+		 */
+		uint64_t misses;
+	};
+
+	/**
+	 * Constructor of ResponseCache.
+	 *
+	 * @param maxEntries Maximum number of responses kept in memory.
+	 * @param storagePath Directory where the responses are persisted, or an empty string to keep
+	 * 					  the responses in memory only.
+	 * @param maxStorageSize Maximum total size in bytes of the files in the storage.
+	 */
+	ResponseCache(size_t maxEntries, std::string const& storagePath = std::string(),
+		size_t maxStorageSize = 4 * 1024 * 1024);
+
+	/**
+	 * Get the cache shared by the REST services, which persists the responses in the data
+	 * directory of the application.
+	 */
+	static ResponseCache& GetDefault();
+
+	/**
+	 * Find the response stored with the key, either in memory or in the storage.
+	 *
+	 * @return The response, or null if there is no response stored with the key.
+	 */
+	std::shared_ptr<CachedResponse const> Lookup(std::string const& key);
+
+	/**
+	 * Store the response with the key, replacing the response previously stored with the key.
+	 *
+	 * @return The stored response.
+	 */
+	std::shared_ptr<CachedResponse const> Store(std::string const& key, CachedResponse response);
+
+	void Remove(std::string const& key);
+
+	/**
+	 * Remove every response, including the files in the storage which are written by other
+	 * instances or by the previous run of the application.
+	 */
+	void Clear();
+
+	Statistics GetStatistics() const;
+
+private:
+	friend class RESTServiceTemplateBase;
+
+	struct Entry
+	{
+		std::shared_ptr<CachedResponse const> response;
+		std::list<std::string>::iterator position;
+	};
+
+	/**
+	 * Replace the expiry time of the response validated by the server, without writing the body to
+	 * the storage again.
+	 */
+	std::shared_ptr<CachedResponse const> Refresh(std::string const& key, CachedResponse const& response,
+		std::chrono::system_clock::time_point expiresAt);
+
+	void Insert(std::string const& key, std::shared_ptr<CachedResponse const> response);
+	std::string GetFilePath(std::string const& key) const;
+	void WriteFile(std::string const& key, CachedResponse const& response);
+	void WriteFileExpiry(std::string const& key, std::chrono::system_clock::time_point expiresAt);
+	std::shared_ptr<CachedResponse const> ReadFile(std::string const& key);
+
+	/**
+	 * Remove the least recently written files until the storage fits its maximum size. The file
+	 * which is just written is kept.
+	 */
+	void TrimStorage(std::string const& writtenPath);
+
+	size_t maxEntries;
+	std::string storagePath;
+	size_t maxStorageSize;
+
+	std::mutex cacheLock;
+	std::unordered_map<std::string, Entry> entries;
+
+	// Most recently used key is at the front
+	std::list<std::string> recentList;
+
+	std::atomic<uint64_t> hitCount;
+	std::atomic<uint64_t> revalidationCount;
+	std::atomic<uint64_t> missCount;
+};
+
+}
+}
+
+#endif /* TFCFW_RESPONSECACHE_H_ */
@@ -26,7 +26,12 @@
 #ifndef TFCFW_UTIL_H_
 #define TFCFW_UTIL_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
+
+#include "TFC/Core.h"
 
 namespace TFC {
 namespace Net {
@@ -40,6 +45,87 @@ namespace Net {
  * @return Base64 encoded string.
  */
 std::string Base64Encode(const uint8_t* buffer, size_t length);
+
+/**
+ * Static method do percent encoding of a string according to RFC 3986. Every byte except the
+ * unreserved characters (letters, digits, '-', '.', '_', and '~') is encoded as '%' followed by two
+ * uppercase hexadecimal digits, so UTF-8 multibyte characters are encoded byte by byte.
+ *
+ * @param output String where the encoded string is appended to.
+ * @param data String that will be encoded.
+ * @param length Length of the string.
+ */
+LIBAPI void PercentEncode(std::string& output, char const* data, size_t length);
+
+/**
+ * Static method do percent encoding of a string according to RFC 3986.
+ *
+ * @param value String that will be encoded.
+ *
+ * @return Percent encoded string.
+ */
+LIBAPI std::string PercentEncode(std::string const& value);
+
+/**
+ * Static method do gzip compression of a buffer, which produces a body that can be sent with
+ * "Content-Encoding: gzip". It uses zlib's deflate with the gzip wrapper.
+ *
+ * @param output String which receives the compressed data.
+ * @param data Buffer that will be compressed.
+ * @param length Length of the buffer.
+ *
+ * @return true if the buffer is compressed, false otherwise.
+ */
+LIBAPI bool GzipCompress(std::string& output, char const* data, size_t length);
+
+/**
+ * Ring buffer of the most recent samples, which keeps up to its capacity and then replaces the
+ * oldest sample. It is used to compute the percentiles of the recent transfers.
+ */
+template<typename T>
+class SampleWindow
+{
+public:
+	SampleWindow(size_t capacity) : capacity(capacity > 0 ? capacity : 1), next(0)
+	{
+	}
+
+	void Add(T const& sample)
+	{
+		if(samples.size() < capacity)
+		{
+			samples.push_back(sample);
+		}
+		else
+		{
+			samples[next] = sample;
+			next = (next + 1) % capacity;
+		}
+	}
+
+	/**
+	 * Get the samples, which are not ordered by their age.
+	 */
+	std::vector<T> const& GetSamples() const { return samples; }
+
+	size_t GetSize() const { return samples.size(); }
+
+private:
+	size_t capacity;
+	std::vector<T> samples;
+	size_t next;
+};
+
+/**
+ * Get the value at the percentile of the samples, where percentile 1 is the maximum value. The
+ * samples are partially reordered.
+ *
+ * @param samples Samples to select from.
+ * @param percentile Percentile between 0 and 1.
+ *
+ * @return The value at the percentile, or zero if there is no sample.
+ */
+int64_t GetPercentile(std::vector<int64_t>& samples, double percentile);
 }
 }
 
@@ -296,6 +296,7 @@ TValueType TFC::Serialization::ConstantValue<TValueType, theValue, TPredicates>:
 	{ \
 		static constexpr bool available = true; \
 		typedef TFC::Serialization::TypeSerializationInfo< CLASS , ##__VA_ARGS__ > Type; \
+		static constexpr char const* GetDeclaration() { return #__VA_ARGS__; } \
 	}
 
 #define TFC_FieldInfo(MEMPTR, ...) TFC::Serialization::FieldInfo<typename TFC::Core::Introspect::MemberField<decltype( & MEMPTR )>::DeclaringType, decltype( MEMPTR ), & MEMPTR, std::tuple < __VA_ARGS__ > >
@@ -131,6 +131,161 @@ struct DiscriminatedUnionCase
 	static ValueType const& Get(TDUType const& o) { return o.*targetPtr; }
 };
 
+template<size_t N>
+struct DiscriminatorArray
+{
+	uint32_t value[N];
+};
+
+template<size_t N>
+struct CaseIndexArray
+{
+	int16_t value[N];
+};
+
+/**
+ * Constant expression helpers to build the dispatch tables of DiscriminatedUnionDispatch. The
+ * functions are written using single return statement so it can be evaluated by C++11 constexpr
+ * evaluator.
+ */
+struct DiscriminatedUnionDispatchHelper
+{
+	static constexpr uint32_t Smaller(uint32_t a, uint32_t b) { return a < b ? a : b; }
+	static constexpr uint32_t Larger(uint32_t a, uint32_t b) { return a > b ? a : b; }
+
+	template<size_t N>
+	static constexpr uint32_t Min(DiscriminatorArray<N> const& d, size_t count, size_t i = 0)
+	{
+		return i + 1 >= count ? d.value[i] : Smaller(d.value[i], Min(d, count, i + 1));
+	}
+
+	template<size_t N>
+	static constexpr uint32_t Max(DiscriminatorArray<N> const& d, size_t count, size_t i = 0)
+	{
+		return i + 1 >= count ? d.value[i] : Larger(d.value[i], Max(d, count, i + 1));
+	}
+
+	// Index of the first case matching the value, which is the case picked by sequential matching
+	template<size_t N>
+	static constexpr int FirstIndexOf(DiscriminatorArray<N> const& d, size_t count, uint32_t v, size_t i = 0)
+	{
+		return i >= count ? -1 : (d.value[i] == v ? (int)i : FirstIndexOf(d, count, v, i + 1));
+	}
+
+	template<size_t N>
+	static constexpr size_t CountLess(DiscriminatorArray<N> const& d, size_t count, uint32_t v, size_t i = 0)
+	{
+		return i >= count ? 0 : (d.value[i] < v ? 1 : 0) + CountLess(d, count, v, i + 1);
+	}
+
+	template<size_t N>
+	static constexpr size_t CountEqualBefore(DiscriminatorArray<N> const& d, size_t end, uint32_t v, size_t i = 0)
+	{
+		return i >= end ? 0 : (d.value[i] == v ? 1 : 0) + CountEqualBefore(d, end, v, i + 1);
+	}
+
+	// Position of case i when sorted by discriminator, where duplicates keep the declaration order
+	template<size_t N>
+	static constexpr size_t Rank(DiscriminatorArray<N> const& d, size_t count, size_t i)
+	{
+		return CountLess(d, count, d.value[i]) + CountEqualBefore(d, i, d.value[i]);
+	}
+
+	template<size_t N>
+	static constexpr size_t FindByRank(DiscriminatorArray<N> const& d, size_t count, size_t rank, size_t i = 0)
+	{
+		return i >= count ? 0 : (Rank(d, count, i) == rank ? i : FindByRank(d, count, rank, i + 1));
+	}
+
+	template<size_t N, int... S>
+	static constexpr CaseIndexArray<sizeof...(S)> BuildDense(DiscriminatorArray<N> const& d, size_t count, uint32_t min, Core::Metaprogramming::Sequence<S...>)
+	{
+		return {{ (int16_t)FirstIndexOf(d, count, min + S)... }};
+	}
+
+	template<size_t N, int... S>
+	static constexpr CaseIndexArray<N> BuildSortedIndex(DiscriminatorArray<N> const& d, size_t count, Core::Metaprogramming::Sequence<S...>)
+	{
+		return {{ (int16_t)FindByRank(d, count, S)... }};
+	}
+
+	template<size_t N, int... S>
+	static constexpr DiscriminatorArray<N> BuildSortedValue(DiscriminatorArray<N> const& d, size_t count, Core::Metaprogramming::Sequence<S...>)
+	{
+		return {{ d.value[FindByRank(d, count, S)]... }};
+	}
+};
+
+/**
+ * Maps discriminator value to the index of the matching case. The mapping is resolved using a
+ * lookup table indexed by the discriminator if the values are dense enough, or using binary
+ * search over the sorted discriminator values otherwise. Both tables are built in compile-time.
+ */
+template<typename... TCase>
+struct DiscriminatedUnionDispatch
+{
+	typedef DiscriminatedUnionDispatchHelper Helper;
+
+	static constexpr size_t caseCount = sizeof...(TCase);
+	static constexpr size_t maxDenseRange = 256;
+
+	// The array has extra element so it can be declared for union without any case
+	static constexpr DiscriminatorArray<caseCount + 1> discriminators = {{ TCase::discriminator..., 0 }};
+
+	static constexpr uint32_t minValue = caseCount == 0 ? 0 : Helper::Min(discriminators, caseCount);
+	static constexpr uint64_t range = caseCount == 0 ? 0 : (uint64_t)Helper::Max(discriminators, caseCount) - minValue + 1;
+	static constexpr bool dense = caseCount != 0 && range <= maxDenseRange && range <= 4 * caseCount + 8;
+
+	static constexpr CaseIndexArray<dense ? range : 1> denseIndex =
+		Helper::BuildDense(discriminators, caseCount, minValue, typename Core::Metaprogramming::SequenceGenerator<dense ? range : 1>::Type());
+
+	static constexpr DiscriminatorArray<caseCount + 1> sortedValue =
+		Helper::BuildSortedValue(discriminators, caseCount, typename Core::Metaprogramming::SequenceGenerator<caseCount + 1>::Type());
+
+	static constexpr CaseIndexArray<caseCount + 1> sortedIndex =
+		Helper::BuildSortedIndex(discriminators, caseCount, typename Core::Metaprogramming::SequenceGenerator<caseCount + 1>::Type());
+
+	/**
+	 * Returns the index of the case matching the discriminator, or -1 if there is no matching case.
+	 */
+	static int Find(uint32_t discriminator)
+	{
+		if(dense)
+		{
+			// Values below minValue wrap around and fail the range check
+			uint32_t offset = discriminator - minValue;
+			return offset < range ? denseIndex.value[offset] : -1;
+		}
+
+		size_t low = 0;
+		size_t high = caseCount;
+
+		while(low < high)
+		{
+			size_t mid = (low + high) / 2;
+
+			if(sortedValue.value[mid] < discriminator)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+
+		return (low < caseCount && sortedValue.value[low] == discriminator) ? sortedIndex.value[low] : -1;
+	}
+};
+
+template<typename... TCase>
+constexpr DiscriminatorArray<DiscriminatedUnionDispatch<TCase...>::caseCount + 1> DiscriminatedUnionDispatch<TCase...>::discriminators;
+
+template<typename... TCase>
+constexpr CaseIndexArray<DiscriminatedUnionDispatch<TCase...>::dense ? DiscriminatedUnionDispatch<TCase...>::range : 1> DiscriminatedUnionDispatch<TCase...>::denseIndex;
+
+template<typename... TCase>
+constexpr DiscriminatorArray<DiscriminatedUnionDispatch<TCase...>::caseCount + 1> DiscriminatedUnionDispatch<TCase...>::sortedValue;
+
+template<typename... TCase>
+constexpr CaseIndexArray<DiscriminatedUnionDispatch<TCase...>::caseCount + 1> DiscriminatedUnionDispatch<TCase...>::sortedIndex;
+
 
 
 }}
@@ -89,57 +89,54 @@ struct DiscriminatedUnionDeserializerSelector<TValueType, Core::Metaprogramming:
 	}
 };
 
-template<typename TDUType, typename TCurrent, typename... TTail>
-struct DiscriminatedUnionSelector<TDUType, TCurrent, TTail...>
+/**
+ * Selects the case matching the discriminator using DiscriminatedUnionDispatch, then invokes the
+ * handler of the case from a function table. Discriminator without matching case is ignored.
+ */
+template<typename TDUType, typename... TCase>
+struct DiscriminatedUnionSelector
 {
-	template<typename TSerializerClass>
-	static void Serialize(TSerializerClass& ser, TDUType const& obj, uint32_t discriminator)
-	{
+	typedef DiscriminatedUnionDispatch<TCase...> Dispatch;
 
-		if(TCurrent::Match(discriminator))
-		{
-			SerializerSelect<TSerializerClass, typename TCurrent::ValueType>::Serialize(ser, TCurrent::Get(obj));
-			//ser.Serialize();
-		}
-		else
-			DiscriminatedUnionSelector<TDUType, TTail...>::Serialize(ser, obj, discriminator);
+	template<typename TSerializerClass, typename TCurrent>
+	static void SerializeCase(TSerializerClass& ser, TDUType const& obj)
+	{
+		SerializerSelect<TSerializerClass, typename TCurrent::ValueType>::Serialize(ser, TCurrent::Get(obj));
 	}
 
-	template<typename TDeserializerClass>
-	static void DeserializeAndSet(TDeserializerClass& ser, TDUType& obj, uint32_t discriminator, int curIdx)
+	template<typename TDeserializerClass, typename TCurrent>
+	static void DeserializeCase(TDeserializerClass& ser, TDUType& obj)
 	{
-		if(TCurrent::Match(discriminator))
-		{
-			//typename TCurrent::ValueType ret;
-			//ser.Deserialize(ret);
-
-			auto& storage = obj.*(TCurrent::targetPointer);
-
-			// Initialize the value
-			new (&storage) typename TCurrent::ValueType;
+		auto& storage = obj.*(TCurrent::targetPointer);
 
-			DiscriminatedUnionDeserializerSelector<typename TCurrent::ValueType>::DeserializeAndSet(ser, obj.*(TCurrent::targetPointer));
+		// Initialize the value
+		new (&storage) typename TCurrent::ValueType;
 
-			//InPlaceConstructorHelper<typename TCurrent::ValueType>::Assign(&(), std::move(ret));
-		}
-		else
-			DiscriminatedUnionSelector<TDUType, TTail...>::DeserializeAndSet(ser, obj, discriminator, curIdx);
+		DiscriminatedUnionDeserializerSelector<typename TCurrent::ValueType>::DeserializeAndSet(ser, storage);
 	}
-};
 
-template<typename TDUType>
-struct DiscriminatedUnionSelector<TDUType>
-{
 	template<typename TSerializerClass>
 	static void Serialize(TSerializerClass& ser, TDUType const& obj, uint32_t discriminator)
 	{
+		typedef void (*CaseFunc)(TSerializerClass&, TDUType const&);
+		static constexpr CaseFunc handlers[] = { &SerializeCase<TSerializerClass, TCase>..., nullptr };
+
+		int idx = Dispatch::Find(discriminator);
 
+		if(idx >= 0)
+			handlers[idx](ser, obj);
 	}
 
 	template<typename TDeserializerClass>
-	static void DeserializeAndSet(TDeserializerClass& ser, TDUType const& obj, uint32_t discriminator, int curIdx)
+	static void DeserializeAndSet(TDeserializerClass& ser, TDUType& obj, uint32_t discriminator, int curIdx)
 	{
+		typedef void (*CaseFunc)(TDeserializerClass&, TDUType&);
+		static constexpr CaseFunc handlers[] = { &DeserializeCase<TDeserializerClass, TCase>..., nullptr };
+
+		int idx = Dispatch::Find(discriminator);
 
+		if(idx >= 0)
+			handlers[idx](ser, obj);
 	}
 };
 
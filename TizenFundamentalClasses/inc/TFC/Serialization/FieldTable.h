@@ -0,0 +1,337 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Serialization/FieldTable.h
+ *
+ * Compile-time table describing the fields declared using
+ * TFC_DefineTypeSerializationInfo, containing the field names, type codes
+ * and accessors in declaration order
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#ifndef TFC_SERIALIZATION_FIELDTABLE_H_
+#define TFC_SERIALIZATION_FIELDTABLE_H_
+
+#include <array>
+#include <string>
+#include <cstring>
+
+#include "TFC/Serialization.h"
+
+namespace TFC {
+namespace Serialization {
+
+/**
+ * Type code of a field stored in FieldTable. Enumeration fields are reported using the type code
+ * of its underlying type. Fields which type is not a primitive, string, or a class with type
+ * serialization info (i.e. containers and discriminated unions) are reported as Other.
+ */
+enum class FieldTypeCode : uint8_t
+{
+	Bool,
+	Int8,
+	UInt8,
+	Int16,
+	UInt16,
+	Int32,
+	UInt32,
+	Int64,
+	UInt64,
+	Double,
+	String,
+	Object,
+	Other
+};
+
+struct FieldDescriptor
+{
+	/**
+	 * Name of the member, which points to the declaration text and is NOT null terminated. Use
+	 * nameLength to get its length. Constant values have empty name.
+	 */
+	char const* name;
+	size_t nameLength;
+
+	FieldTypeCode typeCode;
+	bool constant;
+
+	/**
+	 * Returns the address of the field value inside the object. Pointer-to-member cannot be
+	 * converted to offset in a constant expression, so the address is resolved by this accessor
+	 * instead. The accessor is nullptr if the value is not addressable (i.e. discriminated union).
+	 */
+	void const* (*address)(void const* obj);
+
+	/**
+	 * Evaluates the predicate of the field against the object. The evaluator is nullptr if the
+	 * field does not have any predicate.
+	 */
+	bool (*evaluate)(void const* obj);
+
+	bool NameEquals(char const* str, size_t len) const
+	{
+		return nameLength == len && std::strncmp(name, str, len) == 0;
+	}
+
+	std::string Name() const
+	{
+		return std::string(name, nameLength);
+	}
+};
+
+template<typename TValue, typename = void>
+struct FieldTypeCodeOf 							{ static constexpr FieldTypeCode value = FieldTypeCode::Other; };
+
+template<> struct FieldTypeCodeOf<bool> 		{ static constexpr FieldTypeCode value = FieldTypeCode::Bool; };
+template<> struct FieldTypeCodeOf<int8_t> 		{ static constexpr FieldTypeCode value = FieldTypeCode::Int8; };
+template<> struct FieldTypeCodeOf<uint8_t> 		{ static constexpr FieldTypeCode value = FieldTypeCode::UInt8; };
+template<> struct FieldTypeCodeOf<int16_t> 		{ static constexpr FieldTypeCode value = FieldTypeCode::Int16; };
+template<> struct FieldTypeCodeOf<uint16_t> 	{ static constexpr FieldTypeCode value = FieldTypeCode::UInt16; };
+template<> struct FieldTypeCodeOf<int32_t> 		{ static constexpr FieldTypeCode value = FieldTypeCode::Int32; };
+template<> struct FieldTypeCodeOf<uint32_t> 	{ static constexpr FieldTypeCode value = FieldTypeCode::UInt32; };
+template<> struct FieldTypeCodeOf<int64_t> 		{ static constexpr FieldTypeCode value = FieldTypeCode::Int64; };
+template<> struct FieldTypeCodeOf<uint64_t> 	{ static constexpr FieldTypeCode value = FieldTypeCode::UInt64; };
+template<> struct FieldTypeCodeOf<double> 		{ static constexpr FieldTypeCode value = FieldTypeCode::Double; };
+template<> struct FieldTypeCodeOf<std::string> 	{ static constexpr FieldTypeCode value = FieldTypeCode::String; };
+
+template<typename TValue>
+struct FieldTypeCodeOf<TValue, typename std::enable_if<std::is_enum<TValue>::value>::type>
+{
+	static constexpr FieldTypeCode value = FieldTypeCodeOf<typename std::underlying_type<TValue>::type>::value;
+};
+
+template<typename TValue>
+struct FieldTypeCodeOf<TValue, typename std::enable_if<TypeSerializationInfoSelector<TValue>::available>::type>
+{
+	static constexpr FieldTypeCode value = FieldTypeCode::Object;
+};
+
+/**
+ * Type of the value stored in the field address, which is the underlying type for enumeration.
+ */
+template<typename TValue, typename = void>
+struct FieldStorageType { typedef TValue Type; };
+
+template<typename TValue>
+struct FieldStorageType<TValue, typename std::enable_if<std::is_enum<TValue>::value>::type>
+{
+	typedef typename std::underlying_type<TValue>::type Type;
+};
+
+/**
+ * Constant expression parser to locate member names inside the declaration text produced by
+ * TFC_DefineTypeSerializationInfo. The functions are written using single return statement
+ * so it can be evaluated by C++11 constexpr evaluator. The recursion depth is bounded by the
+ * length of a single entry plus the number of entries.
+ */
+struct FieldNameParser
+{
+	static constexpr bool IsWhitespace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	static constexpr bool IsIdentifierChar(char c)
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+	}
+
+	static constexpr int NextDepth(char c, int depth)
+	{
+		return (c == '(' || c == '<') ? depth + 1 : (c == ')' || c == '>') ? depth - 1 : depth;
+	}
+
+	// Position of the top level comma or the terminator ending the entry started at pos
+	static constexpr size_t EntryEnd(char const* decl, size_t pos, int depth = 0)
+	{
+		return (decl[pos] == '\0' || (depth == 0 && decl[pos] == ',')) ? pos : EntryEnd(decl, pos + 1, NextDepth(decl[pos], depth));
+	}
+
+	static constexpr size_t EntryBegin(char const* decl, size_t index, size_t pos = 0)
+	{
+		return index == 0 ? pos : EntryBegin(decl, index - 1, EntryEnd(decl, pos) + 1);
+	}
+
+	static constexpr size_t SkipWhitespace(char const* decl, size_t pos)
+	{
+		return IsWhitespace(decl[pos]) ? SkipWhitespace(decl, pos + 1) : pos;
+	}
+
+	static constexpr bool StartsWith(char const* decl, size_t pos, char const* prefix)
+	{
+		return *prefix == '\0' ? true : (decl[pos] == *prefix && StartsWith(decl, pos + 1, prefix + 1));
+	}
+
+	static constexpr size_t Find(char const* decl, size_t pos, char c)
+	{
+		return (decl[pos] == '\0' || decl[pos] == c) ? pos : Find(decl, pos + 1, c);
+	}
+
+	// End of the member path, which is the first argument of TFC_FieldInfo
+	static constexpr size_t PathEnd(char const* decl, size_t pos)
+	{
+		return (decl[pos] == '\0' || decl[pos] == ',' || decl[pos] == ')') ? pos : PathEnd(decl, pos + 1);
+	}
+
+	static constexpr size_t TrimEnd(char const* decl, size_t begin, size_t end)
+	{
+		return (end > begin && IsWhitespace(decl[end - 1])) ? TrimEnd(decl, begin, end - 1) : end;
+	}
+
+	static constexpr size_t IdentifierBegin(char const* decl, size_t begin, size_t end)
+	{
+		return (end > begin && IsIdentifierChar(decl[end - 1])) ? IdentifierBegin(decl, begin, end - 1) : end;
+	}
+
+	static constexpr bool IsFieldInfo(char const* decl, size_t index)
+	{
+		return StartsWith(decl, SkipWhitespace(decl, EntryBegin(decl, index)), "TFC_FieldInfo");
+	}
+
+	static constexpr size_t PathBegin(char const* decl, size_t index)
+	{
+		return Find(decl, SkipWhitespace(decl, EntryBegin(decl, index)), '(') + 1;
+	}
+
+	static constexpr size_t NameEnd(char const* decl, size_t index)
+	{
+		return TrimEnd(decl, PathBegin(decl, index), PathEnd(decl, PathBegin(decl, index)));
+	}
+
+	static constexpr size_t NameBegin(char const* decl, size_t index)
+	{
+		return IsFieldInfo(decl, index) ? IdentifierBegin(decl, PathBegin(decl, index), NameEnd(decl, index)) : 0;
+	}
+
+	static constexpr size_t NameLength(char const* decl, size_t index)
+	{
+		return IsFieldInfo(decl, index) ? NameEnd(decl, index) - NameBegin(decl, index) : 0;
+	}
+};
+
+template<typename TField>
+struct FieldHasPredicate { static constexpr bool value = true; };
+
+template<typename TDeclaring, typename TValueType, TValueType TDeclaring::* memPtr, typename TAny>
+struct FieldHasPredicate<FieldInfo<TDeclaring, TValueType, memPtr, std::tuple<>, TAny>> { static constexpr bool value = false; };
+
+template<typename TValueType, TValueType theValue>
+struct FieldHasPredicate<ConstantValue<TValueType, theValue, std::tuple<>>> { static constexpr bool value = false; };
+
+template<typename TField>
+struct FieldIsConstant { static constexpr bool value = false; };
+
+template<typename TValueType, TValueType theValue, typename TPredicates>
+struct FieldIsConstant<ConstantValue<TValueType, theValue, TPredicates>> { static constexpr bool value = true; };
+
+template<typename TDeclaring, typename TField>
+struct FieldAccessor
+{
+	typedef decltype(TField::Get(std::declval<TDeclaring const&>())) GetterResult;
+	typedef typename std::decay<GetterResult>::type ValueType;
+
+	static constexpr bool addressable = std::is_reference<GetterResult>::value;
+	static constexpr FieldTypeCode typeCode = addressable ? FieldTypeCodeOf<ValueType>::value : FieldTypeCode::Other;
+
+	static void const* Address(void const* obj)
+	{
+		return &TField::Get(*static_cast<TDeclaring const*>(obj));
+	}
+
+	static bool Evaluate(void const* obj)
+	{
+		return TField::Evaluate(*static_cast<TDeclaring const*>(obj));
+	}
+
+	static constexpr void const* (*AddressFunc())(void const*)
+	{
+		return AddressSelect<addressable>::Get();
+	}
+
+	static constexpr bool (*EvaluateFunc())(void const*)
+	{
+		return EvaluateSelect<FieldHasPredicate<TField>::value>::Get();
+	}
+
+private:
+	template<bool available, typename = void>
+	struct AddressSelect { static constexpr void const* (*Get())(void const*) { return &Address; } };
+
+	template<typename TVoid>
+	struct AddressSelect<false, TVoid> { static constexpr void const* (*Get())(void const*) { return nullptr; } };
+
+	template<bool available, typename = void>
+	struct EvaluateSelect { static constexpr bool (*Get())(void const*) { return &Evaluate; } };
+
+	template<typename TVoid>
+	struct EvaluateSelect<false, TVoid> { static constexpr bool (*Get())(void const*) { return nullptr; } };
+};
+
+template<typename TDeclaring, typename... TField>
+struct FieldTableBuilder
+{
+	typedef std::array<FieldDescriptor, sizeof...(TField)> TableType;
+
+	static constexpr char const* Declaration()
+	{
+		return TypeSerializationInfoSelector<TDeclaring>::GetDeclaration();
+	}
+
+	template<typename TCurrentField>
+	static constexpr FieldDescriptor Describe(size_t index)
+	{
+		return {
+			Declaration() + FieldNameParser::NameBegin(Declaration(), index),
+			FieldNameParser::NameLength(Declaration(), index),
+			FieldAccessor<TDeclaring, TCurrentField>::typeCode,
+			FieldIsConstant<TCurrentField>::value,
+			FieldAccessor<TDeclaring, TCurrentField>::AddressFunc(),
+			FieldAccessor<TDeclaring, TCurrentField>::EvaluateFunc()
+		};
+	}
+
+	template<int... S>
+	static constexpr TableType Build(Core::Metaprogramming::Sequence<S...>)
+	{
+		return {{ Describe<TField>(S)... }};
+	}
+};
+
+/**
+ * FieldTable holds the descriptor of every entry declared in TFC_DefineTypeSerializationInfo,
+ * in the same order as the declaration. The table is a constant expression, so it can be used
+ * as a basis of a table-driven serializer, or for formats which need field names.
+ */
+template<typename TDeclaring, typename TSerializationInfo = typename TypeSerializationInfoSelector<TDeclaring>::Type>
+struct FieldTable;
+
+template<typename TDeclaring, typename... TField>
+struct FieldTable<TDeclaring, TypeSerializationInfo<TDeclaring, TField...>>
+{
+	typedef FieldTableBuilder<TDeclaring, TField...> Builder;
+	typedef typename Builder::TableType TableType;
+
+	static constexpr size_t count = sizeof...(TField);
+	static constexpr TableType fields = Builder::Build(typename Core::Metaprogramming::SequenceGenerator<sizeof...(TField)>::Type());
+};
+
+template<typename TDeclaring, typename... TField>
+constexpr typename FieldTable<TDeclaring, TypeSerializationInfo<TDeclaring, TField...>>::TableType FieldTable<TDeclaring, TypeSerializationInfo<TDeclaring, TField...>>::fields;
+
+}}
+
+#endif /* TFC_SERIALIZATION_FIELDTABLE_H_ */
@@ -0,0 +1,371 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Serialization/JsonSerializer.h
+ *
+ * Serializer class for TFC Serialization Templates to serialize to and
+ * deserialize from JSON text. Classes are written as JSON object using
+ * the member names in FieldTable.
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#ifndef TFC_SERIALIZATION_JSONSERIALIZER_H_
+#define TFC_SERIALIZATION_JSONSERIALIZER_H_
+
+#include <string>
+#include <vector>
+
+#include "TFC/Serialization.h"
+#include "TFC/Serialization/ClassSerializer.h"
+#include "TFC/Serialization/FieldTable.h"
+#include "TFC/Serialization/DiscriminatedUnionSerializer.h"
+
+namespace TFC {
+namespace Serialization {
+
+TFC_ExceptionDeclare	(JsonParseException, SerializationException);
+
+class JsonSerializer
+{
+public:
+	typedef std::string SerializedType;
+
+	JsonSerializer();
+	JsonSerializer(SerializedType* bufferRef);
+	JsonSerializer(JsonSerializer&& that);
+	JsonSerializer(JsonSerializer const&) = delete;
+
+	void Serialize(int32_t args);
+	void Serialize(uint32_t args);
+	void Serialize(int64_t args);
+	void Serialize(uint64_t args);
+	void Serialize(uint8_t args);
+	void Serialize(bool args);
+	void Serialize(double args);
+	void Serialize(std::string const& args);
+
+	JsonSerializer CreateScope();
+	void Serialize(JsonSerializer& p);
+
+	template<typename T>
+	void Serialize(std::vector<T> const& args);
+
+	void BeginObject();
+	void EndObject();
+	void BeginArray();
+	void EndArray();
+	void SerializeKey(std::string const& key);
+
+	/**
+	 * Write object key without escaping. The key must not contain any character which has to be
+	 * escaped, which holds for member names taken from FieldTable.
+	 */
+	void SerializeKey(char const* key, size_t keyLen);
+
+	SerializedType EndPack();
+
+	~JsonSerializer();
+
+private:
+	void WriteSeparator();
+
+	bool doDestruction;
+	bool needSeparator;
+	SerializedType* buffer;
+};
+
+class JsonDeserializer
+{
+public:
+	typedef std::string SerializedType;
+
+	/**
+	 * Construct deserializer over the JSON text. The text is parsed in-place in a single pass, so
+	 * the referenced string must outlive the deserializer.
+	 */
+	JsonDeserializer(SerializedType const& p);
+
+	void Deserialize(int8_t& target);
+	void Deserialize(int16_t& target);
+	void Deserialize(int32_t& target);
+	void Deserialize(int64_t& target);
+
+	void Deserialize(uint8_t& target);
+	void Deserialize(uint16_t& target);
+	void Deserialize(uint32_t& target);
+	void Deserialize(uint64_t& target);
+
+	void Deserialize(std::string& target);
+	void Deserialize(bool& target);
+	void Deserialize(double& target);
+
+	template<typename T>
+	void Deserialize(std::vector<T>& target);
+
+	JsonDeserializer& DeserializeScope() { return *this; }
+
+	/**
+	 * Consume the opening brace of an object. Returns false if the value is null, in which case the
+	 * null token is consumed entirely.
+	 */
+	bool BeginObject();
+
+	/**
+	 * Read the next key of the current object. Returns false when the closing brace is reached. The
+	 * key is returned as a view to the parsed text, or to internal scratch buffer if the key
+	 * contains escape sequences, and only valid until the next call.
+	 */
+	bool NextKey(char const*& key, size_t& keyLen);
+
+	bool BeginArray();
+	bool NextElement();
+
+	void Expect(char c);
+	void SkipValue();
+
+	void Finalize();
+
+private:
+	char const* begin;
+	char const* cur;
+	char const* end;
+	bool first;
+	std::string scratch;
+
+	void SkipWhitespace();
+	bool ConsumeNull();
+	char Peek();
+	bool ParseInteger(int64_t& ret, uint64_t& uret, bool& negative);
+	void ParseString(std::string& target);
+	void SkipString();
+	[[noreturn]] void Fail(char const* message);
+};
+
+template<typename TValue, typename = void, bool = SerializerExist<JsonSerializer, TValue>::Value>
+struct JsonValueWriter
+{
+	static void Write(JsonSerializer& ser, TValue const& val)
+	{
+		ser.Serialize(val);
+	}
+};
+
+template<typename TValue>
+struct JsonValueWriter<TValue, typename std::enable_if<std::is_enum<TValue>::value>::type, false>
+{
+	static void Write(JsonSerializer& ser, TValue const& val)
+	{
+		ser.Serialize(static_cast<typename std::underlying_type<TValue>::type>(val));
+	}
+};
+
+template<typename TValue, typename TVoid>
+struct JsonValueWriter<TValue, TVoid, false>
+{
+	static void Write(JsonSerializer& ser, TValue const& val)
+	{
+		auto scope = ser.CreateScope();
+		GenericSerializer<JsonSerializer, TValue>::Serialize(scope, val);
+		ser.Serialize(scope);
+	}
+};
+
+template<typename TField, typename = void>
+struct JsonFieldWriter
+{
+	template<typename TValue>
+	static void Write(JsonSerializer& ser, TValue const& val)
+	{
+		JsonValueWriter<typename std::decay<TValue>::type>::Write(ser, val);
+	}
+};
+
+template<typename TField>
+struct JsonFieldWriter<TField, Core::Metaprogramming::Void_T<typename TField::DUTypeInfo>>
+{
+	template<typename TValue>
+	static void Write(JsonSerializer& ser, TValue const& val)
+	{
+		// Discriminated union is written as a pair of the discriminator and the active case
+		ser.BeginArray();
+		val.Serialize(ser);
+		ser.EndArray();
+	}
+};
+
+template<typename TDeclaring, typename TField, typename = void>
+struct JsonFieldReader
+{
+	static void Read(JsonDeserializer& deser, TDeclaring& obj)
+	{
+		TField::DeserializeAndSet(obj, deser);
+	}
+};
+
+template<typename TDeclaring, typename TDUType, TDUType TDeclaring::* ptrMem, typename TAny, typename TAny2>
+struct JsonFieldReader<TDeclaring, FieldInfo<TDeclaring, TDUType, ptrMem, TAny, TAny2>,
+					   Core::Metaprogramming::Void_T<typename DiscriminatedUnionTypeInfoSelector<TDUType>::Type>>
+{
+	typedef typename DiscriminatedUnionTypeInfoSelector<TDUType>::Type DUTypeInfo;
+
+	static void Read(JsonDeserializer& deser, TDeclaring& obj)
+	{
+		if(!deser.BeginArray())
+			return;
+
+		uint32_t discriminator = 0;
+		TFCAssert<JsonParseException>(deser.NextElement(), "Discriminated union array is empty");
+		deser.Deserialize(discriminator);
+		TFCAssert<JsonParseException>(deser.NextElement(), "Discriminated union array does not contain the value");
+		DUTypeInfo::DeserializeAndSet(ptrMem, obj, discriminator, deser, 0);
+		TFCAssert<JsonParseException>(!deser.NextElement(), "Discriminated union array must contain exactly two elements");
+	}
+};
+
+template<typename TDeclaring, typename... TField>
+struct ClassSerializer<JsonSerializer, TDeclaring, TypeSerializationInfo<TDeclaring, TField...>>
+{
+	template<typename TCurrentField>
+	static void SerializeField(JsonSerializer& packer, TDeclaring const& ptr, FieldDescriptor const& field)
+	{
+		if(field.nameLength == 0 || !TCurrentField::Evaluate(ptr))
+			return;
+
+		packer.SerializeKey(field.name, field.nameLength);
+		JsonFieldWriter<TCurrentField>::Write(packer, TCurrentField::Get(ptr));
+	}
+
+	static JsonSerializer::SerializedType Serialize(TDeclaring const& ptr)
+	{
+		JsonSerializer packer;
+		Serialize(packer, ptr);
+		return packer.EndPack();
+	}
+
+	static void Serialize(JsonSerializer& packer, TDeclaring const& ptr)
+	{
+		auto& fields = FieldTable<TDeclaring>::fields;
+		size_t idx = 0;
+
+		packer.BeginObject();
+
+		using Expansion = int[];
+		(void)Expansion { 0, (SerializeField<TField>(packer, ptr, fields[idx++]), 0)... };
+
+		packer.EndObject();
+	}
+};
+
+template<typename TDeclaring, typename... TField>
+struct ClassDeserializer<JsonDeserializer, TDeclaring, TypeSerializationInfo<TDeclaring, TField...>>
+{
+	typedef void (*FieldReaderFunc)(JsonDeserializer&, TDeclaring&);
+
+	static TDeclaring Deserialize(JsonDeserializer::SerializedType const& p, bool finalizePackedObject = true)
+	{
+		JsonDeserializer unpacker(p);
+
+		TDeclaring ret;
+		Deserialize(unpacker, ret);
+
+		if(finalizePackedObject)
+			unpacker.Finalize();
+
+		return ret;
+	}
+
+	static TDeclaring Deserialize(JsonDeserializer& unpacker)
+	{
+		TDeclaring ret;
+		Deserialize(unpacker, ret);
+		return ret;
+	}
+
+	static void Deserialize(JsonDeserializer& unpacker, TDeclaring& ret)
+	{
+		static FieldReaderFunc const readers[] = { nullptr, &JsonFieldReader<TDeclaring, TField>::Read... };
+		auto& fields = FieldTable<TDeclaring>::fields;
+		size_t const fieldCount = sizeof...(TField);
+
+		if(!unpacker.BeginObject())
+			return;
+
+		// Keys are usually ordered the same way as the declaration, so the lookup starts at the
+		// field following the previous match
+		size_t hint = 0;
+		char const* key;
+		size_t keyLen;
+
+		while(unpacker.NextKey(key, keyLen))
+		{
+			size_t found = fieldCount;
+
+			for(size_t i = 0; i < fieldCount; i++)
+			{
+				size_t idx = (hint + i) % fieldCount;
+
+				if(fields[idx].nameLength != 0 && fields[idx].NameEquals(key, keyLen))
+				{
+					found = idx;
+					break;
+				}
+			}
+
+			if(found == fieldCount)
+			{
+				unpacker.SkipValue();
+			}
+			else
+			{
+				readers[found + 1](unpacker, ret);
+				hint = found + 1;
+			}
+		}
+	}
+};
+
+}}
+
+template<typename T>
+void TFC::Serialization::JsonSerializer::Serialize(std::vector<T> const& args)
+{
+	auto ser = CreateScope();
+	ser.BeginArray();
+
+	for(auto& obj : args)
+		JsonValueWriter<T>::Write(ser, obj);
+
+	ser.EndArray();
+	Serialize(ser);
+}
+
+template<typename T>
+void TFC::Serialization::JsonDeserializer::Deserialize(std::vector<T>& target)
+{
+	if(!BeginArray())
+		return;
+
+	target.clear();
+
+	while(NextElement())
+	{
+		target.emplace_back();
+		GenericDeserializer<JsonDeserializer, T>::Deserialize(*this, target.back());
+	}
+}
+
+#endif /* TFC_SERIALIZATION_JSONSERIALIZER_H_ */
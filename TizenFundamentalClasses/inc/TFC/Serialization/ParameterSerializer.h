@@ -64,10 +64,27 @@ struct ParameterSerializer<TSerializerClass, TFunctionType, std::tuple<TArgs...>
 		return packer.EndPack();
 	}
 
-	static void Serialize(typename TSerializerClass::SerializedType& packer, TArgs... param)
+	static void Serialize(TSerializerClass& packer, TArgs... param)
 	{
 		SerializerFunctor<TSerializerClass, TArgs...>::Func(packer, param...);
 	}
+
+	/**
+	 * Serialize the parameters stored in a tuple, which is used when the invocation is recorded
+	 * and serialized at later time.
+	 */
+	static void Serialize(TSerializerClass& packer, std::tuple<typename std::decay<TArgs>::type...> const& param)
+	{
+		Serialize(packer, param, typename Core::Metaprogramming::SequenceGenerator<sizeof...(TArgs)>::Type());
+	}
+
+private:
+	template<int... S>
+	static void Serialize(TSerializerClass& packer, std::tuple<typename std::decay<TArgs>::type...> const& param,
+		Core::Metaprogramming::Sequence<S...>)
+	{
+		SerializerFunctor<TSerializerClass, TArgs...>::Func(packer, std::get<S>(param)...);
+	}
 };
 
 template<typename TDeserializerClass,
@@ -91,6 +108,11 @@ struct ParameterDeserializer<TDeserializerClass, TFunctionType, std::tuple<TArgs
 
 		return ParameterDeserializerFunctor<TDeserializerClass, TArgs...>::Func(unpacker);
 	}
+
+	static std::tuple<TArgs...> Deserialize(TDeserializerClass& unpacker)
+	{
+		return ParameterDeserializerFunctor<TDeserializerClass, TArgs...>::Func(unpacker);
+	}
 };
 
 }}
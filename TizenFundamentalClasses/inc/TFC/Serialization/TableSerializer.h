@@ -0,0 +1,286 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Serialization/TableSerializer.h
+ *
+ * Table-driven class serializer which walks FieldTable in a loop instead
+ * of expanding SerializerFunctor recursion for every field
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#ifndef TFC_SERIALIZATION_TABLESERIALIZER_H_
+#define TFC_SERIALIZATION_TABLESERIALIZER_H_
+
+#include "TFC/Serialization/ClassSerializer.h"
+#include "TFC/Serialization/FieldTable.h"
+
+namespace TFC {
+namespace Serialization {
+
+/**
+ * Primitive codec for the fields handled directly by the table. One instance of the codec is
+ * generated for each serializer class, and shared by every class serialized using it.
+ */
+template<typename TSerializerClass>
+struct TableFieldWriter
+{
+	template<typename T, bool = SerializerExist<TSerializerClass, T>::Value>
+	struct Primitive
+	{
+		static void Write(TSerializerClass& ser, void const* addr) { ser.Serialize(*static_cast<T const*>(addr)); }
+	};
+
+	template<typename T>
+	struct Primitive<T, false>
+	{
+		static void Write(TSerializerClass& ser, void const* addr) { throw SerializationException("Field type is not supported by the serializer"); }
+	};
+
+	template<typename TValue>
+	static constexpr bool Supports()
+	{
+		return FieldTypeCodeOf<TValue>::value < FieldTypeCode::Object
+			&& SerializerExist<TSerializerClass, typename FieldStorageType<TValue>::Type>::Value;
+	}
+
+	static void Write(TSerializerClass& ser, FieldTypeCode typeCode, void const* addr)
+	{
+		switch(typeCode)
+		{
+		case FieldTypeCode::Bool: 	Primitive<bool>::Write(ser, addr); break;
+		case FieldTypeCode::Int8: 	Primitive<int8_t>::Write(ser, addr); break;
+		case FieldTypeCode::UInt8: 	Primitive<uint8_t>::Write(ser, addr); break;
+		case FieldTypeCode::Int16: 	Primitive<int16_t>::Write(ser, addr); break;
+		case FieldTypeCode::UInt16: Primitive<uint16_t>::Write(ser, addr); break;
+		case FieldTypeCode::Int32: 	Primitive<int32_t>::Write(ser, addr); break;
+		case FieldTypeCode::UInt32: Primitive<uint32_t>::Write(ser, addr); break;
+		case FieldTypeCode::Int64: 	Primitive<int64_t>::Write(ser, addr); break;
+		case FieldTypeCode::UInt64: Primitive<uint64_t>::Write(ser, addr); break;
+		case FieldTypeCode::Double: Primitive<double>::Write(ser, addr); break;
+		case FieldTypeCode::String: Primitive<std::string>::Write(ser, addr); break;
+		default: throw SerializationException("Field type is not supported by the table serializer");
+		}
+	}
+};
+
+template<typename TDeserializerClass>
+struct TableFieldReader
+{
+	template<typename T, bool = DeserializationAvailable<TDeserializerClass, T>::value>
+	struct Primitive
+	{
+		static void Read(TDeserializerClass& deser, void* addr) { deser.Deserialize(*static_cast<T*>(addr)); }
+	};
+
+	template<typename T>
+	struct Primitive<T, false>
+	{
+		static void Read(TDeserializerClass& deser, void* addr) { throw SerializationException("Field type is not supported by the deserializer"); }
+	};
+
+	template<typename TValue>
+	static constexpr bool Supports()
+	{
+		return FieldTypeCodeOf<TValue>::value < FieldTypeCode::Object
+			&& DeserializationAvailable<TDeserializerClass, typename FieldStorageType<TValue>::Type>::value;
+	}
+
+	static void Read(TDeserializerClass& deser, FieldTypeCode typeCode, void* addr)
+	{
+		switch(typeCode)
+		{
+		case FieldTypeCode::Bool: 	Primitive<bool>::Read(deser, addr); break;
+		case FieldTypeCode::Int8: 	Primitive<int8_t>::Read(deser, addr); break;
+		case FieldTypeCode::UInt8: 	Primitive<uint8_t>::Read(deser, addr); break;
+		case FieldTypeCode::Int16: 	Primitive<int16_t>::Read(deser, addr); break;
+		case FieldTypeCode::UInt16: Primitive<uint16_t>::Read(deser, addr); break;
+		case FieldTypeCode::Int32: 	Primitive<int32_t>::Read(deser, addr); break;
+		case FieldTypeCode::UInt32: Primitive<uint32_t>::Read(deser, addr); break;
+		case FieldTypeCode::Int64: 	Primitive<int64_t>::Read(deser, addr); break;
+		case FieldTypeCode::UInt64: Primitive<uint64_t>::Read(deser, addr); break;
+		case FieldTypeCode::Double: Primitive<double>::Read(deser, addr); break;
+		case FieldTypeCode::String: Primitive<std::string>::Read(deser, addr); break;
+		default: throw SerializationException("Field type is not supported by the table deserializer");
+		}
+	}
+};
+
+template<typename TSerializerClass, typename TDeclaring, typename TSerializationInfo = typename TypeSerializationInfoSelector<TDeclaring>::Type>
+struct TableClassSerializer;
+
+template<typename TDeserializerClass, typename TDeclaring, typename TSerializationInfo = typename TypeSerializationInfoSelector<TDeclaring>::Type>
+struct TableClassDeserializer;
+
+/**
+ * TableClassSerializer is an alternative to ClassSerializer which produces the same serialized
+ * form. Primitive and string fields are written by looping over FieldTable, while the remaining
+ * fields (nested class, container, discriminated union) are written via per-field function
+ * generated from the same templates used by ClassSerializer.
+ *
+ * It is opt-in and GenericSerializer keeps using ClassSerializer. The indirect call per field
+ * makes it slower than the recursive expansion, and the field table is not smaller nor faster to
+ * compile than the code it replaces, so it is only useful where the table itself is needed.
+ */
+template<typename TSerializerClass, typename TDeclaring, typename... TField>
+struct TableClassSerializer<TSerializerClass, TDeclaring, TypeSerializationInfo<TDeclaring, TField...>>
+{
+	typedef void (*FieldWriterFunc)(TSerializerClass&, TDeclaring const&);
+	typedef TableFieldWriter<TSerializerClass> Codec;
+
+	template<typename TCurrentField, typename TValue = typename std::decay<typename TCurrentField::ValueType>::type, typename = void>
+	struct Writer
+	{
+		static void Write(TSerializerClass& packer, TDeclaring const& ptr)
+		{
+			SerializerFunctor<TSerializerClass, typename TCurrentField::ValueType>::Func(packer,
+				SerializerField<typename TCurrentField::ValueType> { TCurrentField::Get(ptr), TCurrentField::Evaluate(ptr) });
+		}
+
+		static constexpr FieldWriterFunc Get() { return &Write; }
+	};
+
+	template<typename TCurrentField, typename TValue>
+	struct Writer<TCurrentField, TValue, typename std::enable_if<FieldTypeCodeOf<TValue>::value == FieldTypeCode::Object>::type>
+	{
+		static void Write(TSerializerClass& packer, TDeclaring const& ptr)
+		{
+			if(!TCurrentField::Evaluate(ptr))
+				return;
+
+			TSerializerClass ip = packer.CreateScope();
+			TableClassSerializer<TSerializerClass, TValue>::Serialize(ip, TCurrentField::Get(ptr));
+			packer.Serialize(ip);
+		}
+
+		static constexpr FieldWriterFunc Get() { return &Write; }
+	};
+
+	template<typename TCurrentField, typename TValue>
+	struct Writer<TCurrentField, TValue, typename std::enable_if<FieldAccessor<TDeclaring, TCurrentField>::addressable && Codec::template Supports<TValue>()>::type>
+	{
+		// Handled by the table
+		static constexpr FieldWriterFunc Get() { return nullptr; }
+	};
+
+	static typename TSerializerClass::SerializedType Serialize(TDeclaring const& ptr)
+	{
+		TSerializerClass packer;
+		Serialize(packer, ptr);
+		return packer.EndPack();
+	}
+
+	static void Serialize(TSerializerClass& packer, TDeclaring const& ptr)
+	{
+		static constexpr FieldWriterFunc writers[] = { nullptr, Writer<TField>::Get()... };
+		auto& fields = FieldTable<TDeclaring>::fields;
+
+		for(size_t i = 0; i < sizeof...(TField); i++)
+		{
+			auto& field = fields[i];
+
+			if(writers[i + 1] != nullptr)
+				writers[i + 1](packer, ptr);
+			else if(field.evaluate == nullptr || field.evaluate(&ptr))
+				Codec::Write(packer, field.typeCode, field.address(&ptr));
+		}
+	}
+};
+
+/**
+ * TableClassDeserializer is the counterpart of TableClassSerializer which reads the serialized
+ * form produced by ClassSerializer. Constant values are checked by their own reader, so mismatch
+ * is reported exactly the same way as ClassDeserializer.
+ */
+template<typename TDeserializerClass, typename TDeclaring, typename... TField>
+struct TableClassDeserializer<TDeserializerClass, TDeclaring, TypeSerializationInfo<TDeclaring, TField...>>
+{
+	typedef void (*FieldReaderFunc)(TDeserializerClass&, TDeclaring&, int);
+	typedef TableFieldReader<TDeserializerClass> Codec;
+
+	template<typename TCurrentField, typename TValue = typename std::decay<typename TCurrentField::ValueType>::type, typename = void>
+	struct Reader
+	{
+		static void Read(TDeserializerClass& unpacker, TDeclaring& ret, int curIdx)
+		{
+			ClassDeserializerSelect<TDeserializerClass, TDeclaring, TCurrentField>::DeserializeAndSet(unpacker, ret, curIdx);
+		}
+
+		static constexpr FieldReaderFunc Get() { return &Read; }
+	};
+
+	template<typename TCurrentField, typename TValue>
+	struct Reader<TCurrentField, TValue, typename std::enable_if<FieldTypeCodeOf<TValue>::value == FieldTypeCode::Object && !FieldIsConstant<TCurrentField>::value>::type>
+	{
+		static void Read(TDeserializerClass& unpacker, TDeclaring& ret, int curIdx)
+		{
+			if(!TCurrentField::Evaluate(ret))
+				return;
+
+			decltype(auto) inner = unpacker.DeserializeScope();
+			TableClassDeserializer<TDeserializerClass, TValue>::Deserialize(inner, const_cast<TValue&>(TCurrentField::Get(ret)));
+		}
+
+		static constexpr FieldReaderFunc Get() { return &Read; }
+	};
+
+	template<typename TCurrentField, typename TValue>
+	struct Reader<TCurrentField, TValue, typename std::enable_if<FieldAccessor<TDeclaring, TCurrentField>::addressable && !FieldIsConstant<TCurrentField>::value && Codec::template Supports<TValue>()>::type>
+	{
+		// Handled by the table
+		static constexpr FieldReaderFunc Get() { return nullptr; }
+	};
+
+	static TDeclaring Deserialize(typename TDeserializerClass::SerializedType p, bool finalizePackedObject = true)
+	{
+		TDeserializerClass unpacker(p);
+
+		TDeclaring ret;
+		Deserialize(unpacker, ret);
+
+		if(finalizePackedObject)
+			unpacker.Finalize();
+
+		return ret;
+	}
+
+	static TDeclaring Deserialize(TDeserializerClass& unpacker)
+	{
+		TDeclaring ret;
+		Deserialize(unpacker, ret);
+		return ret;
+	}
+
+	static void Deserialize(TDeserializerClass& unpacker, TDeclaring& ret)
+	{
+		static constexpr FieldReaderFunc readers[] = { nullptr, Reader<TField>::Get()... };
+		auto& fields = FieldTable<TDeclaring>::fields;
+
+		for(size_t i = 0; i < sizeof...(TField); i++)
+		{
+			auto& field = fields[i];
+
+			if(readers[i + 1] != nullptr)
+				readers[i + 1](unpacker, ret, i);
+			else if(field.evaluate == nullptr || field.evaluate(&ret))
+				Codec::Read(unpacker, field.typeCode, const_cast<void*>(field.address(&ret)));
+		}
+	}
+};
+
+}}
+
+#endif /* TFC_SERIALIZATION_TABLESERIALIZER_H_ */
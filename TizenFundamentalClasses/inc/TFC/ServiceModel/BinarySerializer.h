@@ -26,9 +26,11 @@
 #ifndef TFC_SERVICEMODEL_BINARYSERIALIZER_H_
 #define TFC_SERVICEMODEL_BINARYSERIALIZER_H_
 
+#include <array>
 #include <string>
 #include <vector>
 #include <sstream>
+#include <type_traits>
 
 #include "TFC/Core/Introspect.h"
 #include "TFC/Core/Reflection.h"
@@ -40,6 +42,22 @@
 namespace TFC {
 namespace ServiceModel {
 
+/**
+ * Element type which binary form is its memory representation, so a sequence of it can be copied
+ * as a single block. Boolean is excluded as std::vector<bool> is not stored contiguously. Plain
+ * structs without serialization info are copied as is, so both sides must share the same layout.
+ */
+template<typename T>
+struct BinaryBlockCopyable : std::integral_constant<bool,
+	!std::is_same<T, bool>::value &&
+	(std::is_arithmetic<T>::value || std::is_enum<T>::value ||
+	 (std::is_class<T>::value && std::is_pod<T>::value &&
+	  !Serialization::TypeSerializationInfoSelector<T>::available &&
+	  !Serialization::DiscriminatedUnionTypeInfoSelector<T>::isDiscriminatedUnion))>
+{
+
+};
+
 class BinarySerializer
 {
 public:
@@ -64,8 +82,39 @@ public:
 
 	template<typename T>
 	void Serialize(std::vector<T> const& args)
+	{
+		SerializeSequence(args, BinaryBlockCopyable<T>());
+	}
+
+	template<typename T, size_t N>
+	void Serialize(std::array<T, N> const& args)
+	{
+		SerializeSequence(args, BinaryBlockCopyable<T>());
+	}
+
+	/**
+	 * Write raw bytes to the buffer as is.
+	 */
+	void SerializeBlock(void const* data, size_t size);
+
+	~BinarySerializer();
+
+private:
+	bool doDestruction;
+	SerializedType* buffer;
+
+	template<typename TContainer>
+	void SerializeSequence(TContainer const& args, std::true_type)
+	{
+		Serialize((uint32_t)args.size());
+		SerializeBlock(args.data(), args.size() * sizeof(typename TContainer::value_type));
+	}
+
+	template<typename TContainer>
+	void SerializeSequence(TContainer const& args, std::false_type)
 	{
 		using namespace TFC::Serialization;
+		typedef typename TContainer::value_type T;
 		auto ser = CreateScope();
 
 		if (args.empty())
@@ -83,13 +132,6 @@ public:
 		}
 		Serialize(ser);
 	}
-
-	~BinarySerializer();
-
-private:
-	bool doDestruction;
-	SerializedType* buffer;
-
 };
 
 struct BinaryDeserializer
@@ -155,6 +197,40 @@ public:
 
 	template<typename T>
 	void Deserialize(std::vector<T>& target)
+	{
+		DeserializeSequence(target, BinaryBlockCopyable<T>());
+	}
+
+	template<typename T, size_t N>
+	void Deserialize(std::array<T, N>& target)
+	{
+		DeserializeSequence(target, BinaryBlockCopyable<T>());
+	}
+
+	/**
+	 * Read raw bytes from the buffer. Throws SerializationException if the buffer does not have
+	 * enough data.
+	 */
+	void DeserializeBlock(void* data, size_t size);
+
+	void Finalize();
+
+private:
+	template<typename T>
+	void DeserializeSequence(std::vector<T>& target, std::true_type)
+	{
+		uint32_t size = 0;
+		Deserialize(size);
+
+		TFCAssert<Serialization::SerializationException>(size <= (bufferRef.size() - currentPos) / sizeof(T),
+			"Array size exceeds the remaining buffer");
+
+		target.resize(size);
+		DeserializeBlock(target.data(), size * sizeof(T));
+	}
+
+	template<typename T>
+	void DeserializeSequence(std::vector<T>& target, std::false_type)
 	{
 		target.clear();
 
@@ -171,7 +247,29 @@ public:
 		}
 	}
 
-	void Finalize();
+	template<typename T, size_t N>
+	void DeserializeSequence(std::array<T, N>& target, std::true_type)
+	{
+		uint32_t size = 0;
+		Deserialize(size);
+
+		TFCAssert<Serialization::SerializationException>(size == N, "Array size does not match");
+		DeserializeBlock(target.data(), N * sizeof(T));
+	}
+
+	template<typename T, size_t N>
+	void DeserializeSequence(std::array<T, N>& target, std::false_type)
+	{
+		uint32_t size = 0;
+		Deserialize(size);
+
+		TFCAssert<Serialization::SerializationException>(size == N, "Array size does not match");
+
+		auto& scope = DeserializeScope();
+
+		for(auto& obj : target)
+			TFC::Serialization::GenericDeserializer<BinaryDeserializer, T>::Deserialize(scope, obj);
+	}
 };
 
 template<typename T>
@@ -32,10 +32,15 @@
 
 #include "TFC/Serialization/ObjectSerializer.h"
 #include "TFC/Serialization/ParameterSerializer.h"
+#include "TFC/ServiceModel/Includes.h"
 
 #include <dlog.h>
+#include <exception>
+#include <functional>
+#include <memory>
 #include <string>
 #include <typeinfo>
+#include <vector>
 
 namespace TFC {
 namespace ServiceModel {
@@ -68,6 +73,100 @@ struct EventEmissionInfo
 	T eventArg;
 };
 
+/**
+ * Result of asynchronous remote invocation which is passed to the completion. Get() returns the
+ * value returned by the remote method, or rethrows the exception if the invocation failed.
+ */
+template<typename T>
+struct InvokeResult
+{
+	std::exception_ptr error;
+	T value;
+
+	T& Get()
+	{
+		if(error)
+			std::rethrow_exception(error);
+
+		return value;
+	}
+};
+
+template<>
+struct InvokeResult<void>
+{
+	std::exception_ptr error;
+
+	void Get()
+	{
+		if(error)
+			std::rethrow_exception(error);
+	}
+};
+
+template<typename TDeserializerClass, typename T>
+struct InvokeResultReader
+{
+	static void Read(InvokeResult<T>& result, typename TDeserializerClass::SerializedType p)
+	{
+		result.value = Serialization::ObjectDeserializer<TDeserializerClass, T>::Deserialize(p);
+	}
+
+	static void Read(InvokeResult<T>& result, TDeserializerClass& unpacker)
+	{
+		result.value = std::get<0>(Serialization::ParameterDeserializerFunctor<TDeserializerClass, T>::Func(unpacker));
+	}
+};
+
+template<typename TDeserializerClass>
+struct InvokeResultReader<TDeserializerClass, void>
+{
+	static void Read(InvokeResult<void>&, typename TDeserializerClass::SerializedType p)
+	{
+		Serialization::ObjectDeserializer<TDeserializerClass, void>::Deserialize(p);
+	}
+
+	static void Read(InvokeResult<void>&, TDeserializerClass&)
+	{
+
+	}
+};
+
+/**
+ * Reconstruct the exception thrown by the remote method from its type name and message, using
+ * the type information registered via reflection. Returns InvocationException if the type is not
+ * known in this side.
+ */
+inline std::exception_ptr CreateRemoteException(std::string const& typeName, std::string const& message)
+{
+	try
+	{
+		try
+		{
+			auto& info = Core::FindTypeByName(typeName);
+
+			try
+			{
+				info.Throw(message);
+			}
+			catch(Core::FunctionNotFoundException const& ex)
+			{
+				info.Throw();
+			}
+		}
+		catch(Core::ReflectionException const& ex)
+		{
+			throw Core::InvocationException(message);
+		}
+	}
+	catch(...)
+	{
+		return std::current_exception();
+	}
+
+	return std::exception_ptr();
+}
+
 template<typename TEndpoint, typename T>
 class ClientEndpoint : public T
 {
@@ -97,6 +196,39 @@ private:
 		return ReturnTypeDeserializer::Deserialize(endpoint.RemoteCall(typeDescription.GetFunctionNameByPointer(ptr), serialized));
 	}
 
+	template<typename TMemPtr, typename... TArgs>
+	void InvokeAsyncInternal(TMemPtr ptr,
+		std::function<void(InvokeResult<typename TFC::Core::Introspect::MemberFunction<TMemPtr>::ReturnType>&)> completion,
+		TArgs... args)
+	{
+		typedef typename TFC::Core::Introspect::MemberFunction<TMemPtr>::ReturnType ReturnType;
+		typedef Serialization::ParameterSerializer<typename Channel::Serializer, TMemPtr> Serializer;
+
+		auto& typeDescription = Core::TypeInfo<T>::typeDescription;
+
+		auto serialized = Serializer::Serialize(args...);
+		endpoint.RemoteCallAsync(typeDescription.GetFunctionNameByPointer(ptr), serialized,
+			[completion] (typename Channel::SerializedType response, std::exception_ptr error)
+			{
+				InvokeResult<ReturnType> result;
+				result.error = error;
+
+				if(!error)
+				{
+					try
+					{
+						InvokeResultReader<typename Channel::Deserializer, ReturnType>::Read(result, response);
+					}
+					catch(...)
+					{
+						result.error = std::current_exception();
+					}
+				}
+
+				completion(result);
+			});
+	}
+
 	void EventReceived(typename Channel::Client* sender, EventEmissionInfo<typename Channel::SerializedType> const& info)
 	{
 		auto data = eventMap.find(info.eventName);
@@ -123,6 +255,161 @@ protected:
 		return InvokeInternal<TMemPtr>(ptr, param...);
 	}
 
+	/**
+	 * Invoke the remote method without blocking the caller. The completion receives InvokeResult
+	 * once the reply arrives, so many invocations can be in flight at the same time.
+	 */
+	template<typename TMemPtr, typename... TArgs>
+	void InvokeAsync(TMemPtr ptr,
+		std::function<void(InvokeResult<typename TFC::Core::Introspect::MemberFunction<TMemPtr>::ReturnType>&)> completion,
+		TArgs... param)
+	{
+		InvokeAsyncInternal<TMemPtr>(ptr, std::move(completion), param...);
+	}
+
+	/**
+	 * Invocations recorded to be sent to the remote object in a single remote call, which reduces
+	 * the round trip of clients making many small calls in a row. Each recorded invocation gets
+	 * InvokeResult which is filled when the batch is executed, so a failure of one invocation does
+	 * not affect the others. The references returned by Add remain valid until the batch is
+	 * destroyed.
+	 */
+	class InvocationBatch
+	{
+	public:
+		template<typename TMemPtr, typename... TArgs>
+		auto Add(TMemPtr ptr, TArgs... param)
+			-> InvokeResult<typename TFC::Core::Introspect::MemberFunction<TMemPtr>::ReturnType>&
+		{
+			auto& typeDescription = Core::TypeInfo<T>::typeDescription;
+
+			auto entry = new BatchEntry<TMemPtr>(typeDescription.GetFunctionNameByPointer(ptr), param...);
+			entries.push_back(std::unique_ptr<BatchEntryBase>(entry));
+			return entry->result;
+		}
+
+		/**
+		 * Send all recorded invocations which have not been executed. Throws if the remote call itself
+		 * fails, while the exception of each invocation is stored in its InvokeResult.
+		 */
+		void Execute()
+		{
+			if(executedCount == entries.size())
+				return;
+
+			typename Channel::Serializer packer;
+			auto request = packer.CreateScope();
+			request.Serialize((uint32_t)(entries.size() - executedCount));
+
+			for(size_t i = executedCount; i < entries.size(); i++)
+			{
+				auto& entry = entries[i];
+				request.Serialize(std::string(entry->functionName));
+
+				auto scope = request.CreateScope();
+				entry->SerializeParameter(scope);
+				request.Serialize(scope);
+			}
+
+			packer.Serialize(request);
+
+			auto response = owner.endpoint.RemoteCall(batchFunctionName, packer.EndPack());
+			typename Channel::Deserializer unpacker(response);
+
+			for(; executedCount < entries.size(); executedCount++)
+			{
+				auto& entry = entries[executedCount];
+
+				bool success = false;
+				unpacker.Deserialize(success);
+
+				if(success)
+				{
+					decltype(auto) scope = unpacker.DeserializeScope();
+
+					try
+					{
+						entry->DeserializeResult(scope);
+					}
+					catch(...)
+					{
+						entry->SetError(std::current_exception());
+					}
+
+					scope.Finalize();
+				}
+				else
+				{
+					std::string typeName;
+					std::string message;
+					unpacker.Deserialize(typeName);
+					unpacker.Deserialize(message);
+					entry->SetError(CreateRemoteException(typeName, message));
+				}
+			}
+
+			unpacker.Finalize();
+		}
+
+		size_t GetCount() const { return entries.size(); }
+
+	private:
+		struct BatchEntryBase
+		{
+			char const* functionName;
+
+			BatchEntryBase(char const* functionName) : functionName(functionName) { }
+
+			virtual void SerializeParameter(typename Channel::Serializer& packer) = 0;
+			virtual void DeserializeResult(typename Channel::Deserializer& unpacker) = 0;
+			virtual void SetError(std::exception_ptr error) = 0;
+			virtual ~BatchEntryBase() { }
+		};
+
+		template<typename TMemPtr>
+		struct BatchEntry : BatchEntryBase
+		{
+			typedef typename TFC::Core::Introspect::MemberFunction<TMemPtr>::ReturnType ReturnType;
+
+			typename TFC::Core::Introspect::MemberFunction<TMemPtr>::ArgsTupleDecay param;
+			InvokeResult<ReturnType> result;
+
+			template<typename... TArgs>
+			BatchEntry(char const* functionName, TArgs... args) :
+				BatchEntryBase(functionName), param(args...)
+			{
+			}
+
+			virtual void SerializeParameter(typename Channel::Serializer& packer) override
+			{
+				Serialization::ParameterSerializer<typename Channel::Serializer, TMemPtr>::Serialize(packer, param);
+			}
+
+			virtual void DeserializeResult(typename Channel::Deserializer& unpacker) override
+			{
+				InvokeResultReader<typename Channel::Deserializer, ReturnType>::Read(result, unpacker);
+			}
+
+			virtual void SetError(std::exception_ptr error) override
+			{
+				result.error = error;
+			}
+		};
+
+		ClientEndpoint& owner;
+		std::vector<std::unique_ptr<BatchEntryBase>> entries;
+		size_t executedCount;
+
+		InvocationBatch(ClientEndpoint& owner) : owner(owner), executedCount(0) { }
+
+		friend class ClientEndpoint<TEndpoint, T>;
+	};
+
+	InvocationBatch CreateBatch()
+	{
+		return InvocationBatch(*this);
+	}
+
 	ClientEndpoint(char const* objectPath) :
 		endpoint(TEndpoint::configuration, objectPath, Core::GetInterfaceName(InterfacePrefixInspector<TEndpoint>::value, typeid(T)).c_str())
 	{
@@ -140,6 +427,23 @@ protected:
 			&(this->*eventPtr),
 			ClientEndpoint<TEndpoint, T>::RaiseFunction<TArg>
 		}));
+
+		// Server only delivers the events which are subscribed by the client
+		endpoint.SubscribeEvent(eventName);
+	}
+
+	/**
+	 * Stop receiving the event registered by RegisterEvent, so the server no longer sends it. Call
+	 * it when the last handler of the event is removed.
+	 */
+	template<typename TArg>
+	void UnregisterEvent(TFC::Core::EventObject<T*, TArg> T::* eventPtr)
+	{
+		auto& typeInfo = Core::TypeInfo<T>::typeDescription;
+		char const* eventName = typeInfo.GetEventNameByPointer(eventPtr);
+
+		if(eventMap.erase(eventName) != 0)
+			endpoint.UnsubscribeEvent(eventName);
 	}
 
 public:
@@ -38,12 +38,18 @@
 #include "TFC/ServiceModel/ClientEndpoint.h"
 #include "TFC/ServiceModel/ServerEndpoint.h"
 
+#include <array>
 #include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace TFC
@@ -60,6 +66,12 @@ class GDBusServer;
 class GDBusConfiguration;
 class GDBusInterfaceDefinition;
 
+template<typename T, typename = void>
+struct GDBusTypeCode;
+
+template<typename T, typename = void>
+struct GVariantFixedArray;
+
 struct GDBusChannel
 {
 	typedef GVariantSerializer Serializer;
@@ -81,6 +93,44 @@ public:
 	}
 };
 
+/**
+ * Read-only byte buffer which is passed to the remote side as unix file descriptor of a shared
+ * memory file, instead of being copied into the message. Use it in place of std::vector<uint8_t>
+ * for payloads in the order of megabytes. The content is written once when the buffer is created
+ * and cannot be changed afterwards, so copies of the buffer and the remote side share the same
+ * memory. The connection must support passing file descriptors, i.e. unix socket transport.
+ * Signals cannot carry file descriptors, so a buffer in an event argument is sent inline.
+ */
+class LIBAPI SharedBuffer
+{
+public:
+	SharedBuffer();
+	SharedBuffer(void const* data, size_t size);
+	SharedBuffer(std::vector<uint8_t> const& data);
+
+	uint8_t const* GetData() const;
+	size_t GetSize() const;
+	std::vector<uint8_t> ToVector() const;
+
+private:
+	struct Mapping;
+	std::shared_ptr<Mapping> mapping;
+
+	/**
+	 * Map the content of the shared memory file received from the remote side. The descriptor is
+	 * duplicated, so the buffer can be passed on without copying.
+	 */
+	static SharedBuffer Map(int fd);
+
+	/**
+	 * Create buffer in the heap, for the content received inline.
+	 */
+	static SharedBuffer Copy(void const* data, size_t size);
+
+	friend struct GVariantSerializer;
+	friend struct GVariantDeserializer;
+};
+
 struct GVariantSerializer
 {
 	GVariantBuilder builder;
@@ -98,38 +148,61 @@ struct GVariantSerializer
 	void Serialize(std::vector<uint8_t> const& args);
 	void Serialize(std::vector<int32_t> const& args);
 	void Serialize(std::vector<int64_t> const& args);
+	void Serialize(SharedBuffer const& args);
 
 	GVariantSerializer CreateScope();
 	void Serialize(GVariantSerializer& p);
 
 	template<typename T>
 	void Serialize(std::vector<T> const& args)
+	{
+		SerializeSequence(args, GVariantFixedArray<T>());
+	}
+
+	template<typename T, size_t N>
+	void Serialize(std::array<T, N> const& args)
+	{
+		SerializeSequence(args, GVariantFixedArray<T>());
+	}
+
+	/**
+	 * Add array of fixed-size basic type by copying the elements as a single block.
+	 */
+	void SerializeFixedArray(char const* elementType, void const* data, size_t count, size_t elementSize);
+
+	SerializedType EndPack();
+
+private:
+	template<typename TContainer>
+	void SerializeSequence(TContainer const& args, std::true_type)
+	{
+		typedef typename TContainer::value_type T;
+		SerializeFixedArray(GVariantFixedArray<T>::typeCode, args.data(), args.size(), sizeof(T));
+	}
+
+	template<typename TContainer>
+	void SerializeSequence(TContainer const& args, std::false_type)
 	{
 		using namespace TFC::Serialization;
+		typedef typename TContainer::value_type T;
 
-		SerializedType tmp = nullptr;
+		std::vector<SerializedType> elements;
+		elements.reserve(args.size());
 
-		if (args.empty())
-		{
-			tmp = g_variant_new_array(G_VARIANT_TYPE_INT64, nullptr, 0);
-		}
-		else
-		{
-			GVariantBuilder arrayBuilder;
-			g_variant_builder_init(&arrayBuilder, ((const GVariantType *) "av"));
-
-			for (auto& obj : args)
-			{
-				auto wrap = g_variant_new_variant(GenericSerializer<GVariantSerializer, T>::Serialize(obj));
-				g_variant_builder_add_value(&arrayBuilder, wrap);
-			}
-			tmp = g_variant_builder_end(&arrayBuilder);
-		}
+		for (auto& obj : args)
+			elements.push_back(GenericSerializer<GVariantSerializer, T>::Serialize(obj));
 
-		g_variant_builder_add_value(&builder, tmp);
+		bool composite = TypeSerializationInfoSelector<T>::available;
+		SerializeElementArray(elements, composite ? nullptr : GDBusTypeCode<T>::value);
 	}
 
-	SerializedType EndPack();
+	/**
+	 * Add array of the packed elements, typed after the elements so no element is boxed in a
+	 * variant. Element of non-composite type is unpacked to its single value, matching the array
+	 * signature of the function argument. Elements of different types, i.e. class with predicated
+	 * fields, fall back to array of variants.
+	 */
+	void SerializeElementArray(std::vector<SerializedType>& elements, char const* valueType);
 };
 
 struct GVariantDeserializer
@@ -182,23 +255,18 @@ struct GVariantDeserializer
 	void Deserialize(std::vector<uint8_t>& target);
 	void Deserialize(std::vector<int32_t>& target);
 	void Deserialize(std::vector<int64_t>& target);
+	void Deserialize(SharedBuffer& target);
 
 	template<typename T>
 	void Deserialize(std::vector<T>& target)
 	{
-		target.clear();
-		auto arrVariant = g_variant_iter_next_value(&iter);
-		auto arrIter = g_variant_iter_new(arrVariant);
-		while (auto value = g_variant_iter_next_value(arrIter))
-		{
-			typedef TFC::Serialization::GenericDeserializer<GVariantDeserializer, T> Deserializer;
-			auto inner = g_variant_get_variant(value);
-			GVariantDeserializer ser(inner);
-			target.push_back(Deserializer::Deserialize(ser));
-			g_variant_unref(inner);
-			g_variant_unref(value);
-		}
-		g_variant_iter_free(arrIter);
+		DeserializeSequence(target, GVariantFixedArray<T>());
+	}
+
+	template<typename T, size_t N>
+	void Deserialize(std::array<T, N>& target)
+	{
+		DeserializeSequence(target, GVariantFixedArray<T>());
 	}
 
 	void Deserialize(SerializedType& composite);
@@ -214,6 +282,71 @@ private:
 	gsize currentChild;
 
 	GVariantAutoPtr NextField();
+
+	/**
+	 * Retrieve next field as array of fixed-size basic type. The returned pointer is only valid as
+	 * long as the returned GVariant is alive.
+	 */
+	GVariantAutoPtr NextFixedArray(char const* elementType, size_t elementSize, void const*& data, size_t& count);
+
+	/**
+	 * Take the packed element out of the variant box of a non-uniform array. Consumes the passed
+	 * reference and returns a new one.
+	 */
+	static SerializedType UnboxElement(SerializedType element);
+
+	template<typename T>
+	void DeserializeSequence(std::vector<T>& target, std::true_type)
+	{
+		void const* data = nullptr;
+		size_t count = 0;
+		auto holder = NextFixedArray(GVariantFixedArray<T>::typeCode, sizeof(T), data, count);
+
+		auto ptr = static_cast<T const*>(data);
+		target.assign(ptr, ptr + count);
+	}
+
+	template<typename T>
+	void DeserializeSequence(std::vector<T>& target, std::false_type)
+	{
+		target.clear();
+		auto arrVariant = NextField();
+		auto arrIter = g_variant_iter_new(arrVariant.get());
+		target.reserve(g_variant_n_children(arrVariant.get()));
+
+		while (auto value = g_variant_iter_next_value(arrIter))
+		{
+			typedef TFC::Serialization::GenericDeserializer<GVariantDeserializer, T> Deserializer;
+			auto inner = UnboxElement(value);
+			GVariantDeserializer ser(inner);
+			target.push_back(Deserializer::Deserialize(ser));
+			g_variant_unref(inner);
+		}
+		g_variant_iter_free(arrIter);
+	}
+
+	template<typename T, size_t N>
+	void DeserializeSequence(std::array<T, N>& target, std::true_type)
+	{
+		void const* data = nullptr;
+		size_t count = 0;
+		auto holder = NextFixedArray(GVariantFixedArray<T>::typeCode, sizeof(T), data, count);
+
+		TFCAssert<Serialization::SerializationException>(count == N, "Array size does not match");
+
+		auto ptr = static_cast<T const*>(data);
+		std::copy(ptr, ptr + N, target.begin());
+	}
+
+	template<typename T, size_t N>
+	void DeserializeSequence(std::array<T, N>& target, std::false_type)
+	{
+		std::vector<T> tmp;
+		DeserializeSequence(tmp, std::false_type());
+
+		TFCAssert<Serialization::SerializationException>(tmp.size() == N, "Array size does not match");
+		std::move(tmp.begin(), tmp.end(), target.begin());
+	}
 };
 
 template<typename T>
@@ -248,25 +381,8 @@ struct GVariantDeserializer::DeserializerSelector<std::vector<T>,
 	{
 		using namespace TFC::Serialization;
 
-		auto innerVar = deser.NextField();
-		TFCAssert<Serialization::SerializationException>(g_variant_get_type(innerVar.get()) == G_VARIANT_TYPE_ARRAY,
-				"The specified field is not an array type");
-
 		std::vector<T> ret;
-
-		auto iter = g_variant_iter_new(innerVar.get());
-
-		for (auto current = g_variant_iter_next_value(iter); current != nullptr;
-				current = g_variant_iter_next_value(iter))
-		{
-			auto inner = g_variant_get_variant(current);
-			ret.push_back(GenericDeserializer<GVariantDeserializer, T>::Deserialize(inner));
-			g_variant_unref(inner);
-			g_variant_unref(current);
-		}
-
-		g_variant_iter_free(iter);
-
+		deser.DeserializeSequence(ret, std::false_type());
 		return ret;
 	}
 };
@@ -280,25 +396,97 @@ struct GDBusConfiguration
 	char const* busPath;
 };
 
+/**
+ * Process-wide pool of the connections used by GDBusClient. The clients of the same peer address
+ * share one authenticated connection, and the clients of the same object on message bus share one
+ * proxy, instead of establishing their own. A pooled connection found closed is dropped and
+ * established again, so a client can reconnect lazily after its peer went away.
+ */
+class GDBusConnectionPool
+{
+public:
+	/**
+	 * Get the connection to the specified peer address. Returns a new reference, or null and
+	 * sets the error if the connection cannot be established.
+	 */
+	static GDBusConnection* AcquireConnection(std::string const& address, GError** error);
+
+	/**
+	 * Get the proxy of the specified object on message bus. Returns a new reference, or null and
+	 * sets the error if the proxy cannot be created.
+	 */
+	static GDBusProxy* AcquireProxy(GDBusConfiguration const& config, char const* objectPath,
+			char const* interfaceName, GError** error);
+
+	/**
+	 * Drop every pooled connection and proxy. Clients which are still alive keep their own
+	 * reference.
+	 */
+	static void Clear();
+};
+
 class GDBusClient: public TFC::EventEmitterClass<GDBusClient>
 {
 private:
 	void* handle;
 	std::string objectPath;
 	std::string interfaceName;
+	std::string address;
 	GBusType busType;
+	guint signalSubscriptionId;
+	std::vector<std::string> subscribedEvents;
+
+	// Guards the handle, which is replaced when reconnecting, and the subscribed events
+	std::mutex connectionLock;
 
 	void ReceiveEvent(char const* eventName, GVariant* eventArg);
-public:
 
+	/**
+	 * Replace the connection if the peer closed it, and restore the event subscriptions on the
+	 * new connection. Returns a new reference of the handle to call on, which stays valid even if
+	 * another thread replaces the handle afterwards. Only the peer-to-peer connection is checked,
+	 * the proxy on message bus is returned as is.
+	 */
+	gpointer EnsureConnected();
+	void UnregisterEvent();
+	void SendSubscribe(gpointer handle, char const* eventName);
+	void SendUnsubscribe(char const* eventName);
+
+	static GVariant* FinishRemoteCall(GVariant* ptr, GError* err);
+	static void RemoteCallAsyncCallback(GObject* source, GAsyncResult* res, gpointer user_data);
+public:
+	/**
+	 * Completion of asynchronous remote call. On success, result contains the returned value and
+	 * error is null. Otherwise, result is null and error contains the exception of the failure.
+	 */
+	typedef std::function<void(GVariant* result, std::exception_ptr error)> RemoteCallCompletion;
 
 	GDBusClient(GDBusConfiguration const& config, char const* objectPath, char const* interfaceName);
 	GVariant* RemoteCall(char const* methodName, GVariant* parameter);
+
+	/**
+	 * Call the remote method without waiting for the reply, so multiple calls can be in flight on
+	 * the same connection. The completion is invoked from the thread-default main context of the
+	 * calling thread once the reply arrives.
+	 */
+	void RemoteCallAsync(char const* methodName, GVariant* parameter, RemoteCallCompletion completion);
 	void RegisterEvent();
-	bool IsClosed()
-	{
-		return busType != G_BUS_TYPE_NONE || g_dbus_connection_is_closed((GDBusConnection*) handle);
-	}
+
+	/**
+	 * Ask the server to deliver the specified event to this client. The server only emits event
+	 * signals to the clients which subscribed to the event.
+	 */
+	void SubscribeEvent(char const* eventName);
+
+	/**
+	 * Ask the server to stop delivering the specified event to this client. The request is sent
+	 * without waiting for the reply. The server keeps one subscription for the clients sharing a
+	 * pooled connection, so it is only sent when the last of them unsubscribes. The events still
+	 * subscribed are unsubscribed when the client is destroyed.
+	 */
+	void UnsubscribeEvent(char const* eventName);
+
+	bool IsClosed();
 
 	static void GDBusProxyReceiveSignal(GDBusProxy* proxy, gchar* sender_name, gchar* signal_name, GVariant* parameters,
 			gpointer user_data);
@@ -329,9 +517,80 @@ public:
 	};
 
 private:
+	struct ObjectStrand;
+	struct ObjectRegistration;
+
+	/**
+	 * Routing entry of a server object, resolved once when the server is initialized. Each of its
+	 * interface entry is passed as user data of the registered vtable, so incoming calls are routed
+	 * directly to the interface of the object without parsing the object path.
+	 */
+	struct InterfaceRegistration
+	{
+		GDBusServer* server;
+		IServerObject<GDBusChannel>::InterfaceEntry* iface;
+		ObjectStrand* strand;
+		ObjectRegistration* owner;
+	};
+
+	struct PendingCall
+	{
+		InterfaceRegistration* registration;
+		GDBusMethodInvocation* invocation;
+	};
+
+	/**
+	 * Queue of calls targeting a single server object when the worker pool is enabled with per-object
+	 * strand. At most one worker drains the queue at a time, so the calls to the object are executed
+	 * sequentially in their arrival order while calls to other objects run in parallel.
+	 */
+	struct ObjectStrand
+	{
+		std::mutex lock;
+		std::deque<PendingCall> queue;
+		bool scheduled;
+	};
+
+	/**
+	 * Client subscribed to an event. On message bus every client shares the same connection, so
+	 * the client is identified by its unique bus name which is used as the signal destination.
+	 */
+	struct EventSubscriber
+	{
+		GDBusConnection* connection;
+		std::string destination;
+	};
+
+	/**
+	 * Subscribers and coalescing state of an event of a server object. When coalescing is enabled,
+	 * the first event is emitted immediately and opens the window. The events raised during the
+	 * window only replace pendingArgument, which is emitted when the window ends.
+	 */
+	struct EventState
+	{
+		GDBusServer* server;
+		ObjectRegistration* owner;
+		std::string eventName;
+		char const* interfaceName;
+		std::vector<EventSubscriber> subscribers;
+		unsigned int coalescingWindow;
+		GVariant* pendingArgument;
+		guint timerId;
+	};
+
+	struct ObjectRegistration
+	{
+		IServerObject<GDBusChannel>* object;
+		std::string objectPath;
+		std::vector<InterfaceRegistration> interfaces;
+		std::unique_ptr<ObjectStrand> strand;
+		std::unordered_map<std::string, EventState> events;
+	};
 
 	static void OnConnectionClosedCallback(GDBusConnection* connection, gboolean remote_peer_vanished, GError* error,
 			gpointer user_data);
+	static void OnNameOwnerChangedCallback(GDBusConnection* connection, const gchar* sender_name, const gchar* object_path,
+			const gchar* interface_name, const gchar* signal_name, GVariant* parameters, gpointer user_data);
 	static void OnBusAcquiredCallback(GDBusConnection *connection, const gchar* name, gpointer user_data);
 	static void OnNameAcquiredCallback(GDBusConnection *connection, const gchar* name, gpointer user_data);
 	static void OnNameLostCallback(GDBusConnection *connection, const gchar* name, gpointer user_data);
@@ -344,26 +603,71 @@ private:
 	void OnNameAcquired(GDBusConnection *connection, const gchar* name);
 	void OnNameLost(GDBusConnection *connection, const gchar* name);
 
-	void OnMethodCall(GDBusConnection *connection, const gchar *sender, const gchar *object_path,
-			const gchar *interface_name, const gchar *method_name, GVariant *parameters,
+	void OnMethodCall(InterfaceRegistration* registration, GDBusConnection *connection, const gchar *sender,
+			const gchar *object_path, const gchar *interface_name, const gchar *method_name, GVariant *parameters,
 			GDBusMethodInvocation *invocation);
 
+	static void OnWorkerCallback(gpointer data, gpointer user_data);
+
+	void ExecuteCall(InterfaceRegistration* registration, GDBusMethodInvocation *invocation);
+	void ExecuteWork(gpointer data);
+
 	static constexpr GDBusInterfaceVTable defaultVtable
 	{ OnMethodCallCallback, nullptr, nullptr };
 
 	void EventCaptureHandler(IServerObject<GDBusChannel>* source,
 			IServerObject<GDBusChannel>::EventEmissionInfo const& eventInfo);
 
+	static gboolean OnCoalescingTimeoutCallback(gpointer user_data);
+
+	void Subscribe(InterfaceRegistration* registration, GDBusConnection* connection, const gchar* sender,
+			GVariant* parameters, GDBusMethodInvocation* invocation);
+	EventState& GetEventState(ObjectRegistration& registration, std::string const& eventName);
+
+	/**
+	 * Drop the subscriptions of the connection, or of the destination on the connection if
+	 * destination is not null. Must be called with eventLock held.
+	 */
+	void RemoveSubscribers(GDBusConnection* connection, char const* destination);
+	void EmitEvent(EventState& state, GVariant* argument);
+
+	void RegisterObjectPath(IServerObject<GDBusChannel>* obj);
+	std::string GetObjectPath(std::string const& objectName) const;
+
 	std::map<std::string, std::unique_ptr<IServerObject<GDBusChannel>>>objectList;
+	std::unordered_map<std::string, ObjectRegistration> objectPathMap;
 	std::vector<GDBusConnection*> connectionList;
+	std::unordered_map<std::string, unsigned int> coalescingWindowMap;
+	std::mutex eventLock;
 	std::string rootPath;
 
 	guint busId;
+	GDBusConnection* busConnection;
+	guint nameOwnerSubscriptionId;
 	::GDBusServer* server;
+	GThreadPool* workerPool;
+	bool perObjectStrand;
 	Configuration config;
 public:
 	GDBusServer(Configuration const& config);
 	~GDBusServer();
+
+	/**
+	 * Execute incoming method calls in a pool of worker threads instead of the GDBus dispatching
+	 * thread, so a slow method does not block the other clients. The reply is sent from the worker
+	 * thread once the method returns. If perObjectStrand is true, calls to the same server object
+	 * are never executed concurrently, so server objects without internal locking remain safe.
+	 * Must be called before Initialize.
+	 */
+	void EnableWorkerPool(unsigned int threadCount, bool perObjectStrand = true);
+
+	/**
+	 * Limit the emission rate of the specified event of every server object. Within the window,
+	 * only the latest event argument is kept and emitted when the window ends. Passing zero window
+	 * disables the coalescing. Must be called before the event is raised.
+	 */
+	void SetEventCoalescing(std::string const& eventName, unsigned int windowInMilliseconds);
+
 	void Initialize();
 	void AddServerObject(IServerObject<GDBusChannel>* obj);
 	void AddServerObject(std::unique_ptr<IServerObject<GDBusChannel>> obj);
@@ -387,6 +691,29 @@ public:
 	template<typename TDeclaring, typename TArgs>
 	void RegisterEvent(TFC::Core::EventObject<TDeclaring*, TArgs> TDeclaring::* eventPtr);
 
+	/**
+	 * Register the function which receives several invocations packed in a single tuple. It must
+	 * be registered after all other functions.
+	 */
+	void RegisterBatchFunction(char const* funcName);
+
+	/**
+	 * Register the function which subscribes or unsubscribes an event. It is handled by
+	 * GDBusServer itself, so it must be registered after the batch function.
+	 */
+	void RegisterSubscriptionFunction(char const* funcName);
+
+	bool IsSubscriptionFunction(GDBusMethodInfo const* methodInfo) const
+	{
+		return methodInfo != nullptr && methodInfo == this->subscriptionMethodInfo;
+	}
+
+	/**
+	 * Get the index of the method in this interface, which is the order the function is
+	 * registered. Returns -1 if the method info does not belong to this interface.
+	 */
+	int GetFunctionIndex(GDBusMethodInfo const* methodInfo) const;
+
 	~GDBusInterfaceDefinition();
 
 private:
@@ -394,7 +721,9 @@ private:
 	std::string interfaceNameStd;
 
 	std::vector<GDBusMethodInfo*> methodInfoList;
+	std::unordered_map<GDBusMethodInfo const*, int> methodIndexMap;
 	std::vector<GDBusSignalInfo*> signalInfoList;
+	GDBusMethodInfo* subscriptionMethodInfo;
 
 	void RegisterFunction(std::string const& funcName, std::vector<std::string> const& args,
 			std::string const& retType);
@@ -415,7 +744,7 @@ struct GDBusSignatureBuilder;
 template<typename ... TArgs>
 struct GDBusSignatureFiller;
 
-template<typename T, typename TVoid = void>
+template<typename T, typename TVoid>
 struct GDBusTypeCode
 {
 	static constexpr char const* value = "r";
@@ -452,6 +781,27 @@ GDBus_TypeCode_Define(double, "d");
 GDBus_TypeCode_Define(std::string, "s");
 GDBus_TypeCode_Define(void, "");
 
+GDBus_TypeCode_Define(std::vector<uint8_t>, "ay");
+
+// Shared buffer is either handle of shared memory file or inline byte array
+GDBus_TypeCode_Define(SharedBuffer, "v");
+
+/**
+ * Element type which can be transferred using g_variant_new_fixed_array, which are numeric types
+ * having the same size as its GVariant basic type. Boolean is excluded as gboolean is wider than
+ * bool.
+ */
+template<typename T, typename TVoid>
+struct GVariantFixedArray : std::integral_constant<bool,
+	!std::is_same<T, bool>::value && (std::is_arithmetic<T>::value || std::is_enum<T>::value) &&
+	GDBusTypeCode<T>::value[0] != '\0' && GDBusTypeCode<T>::value[1] == '\0' &&
+	(GDBusTypeCode<T>::value[0] == 'y' || GDBusTypeCode<T>::value[0] == 'n' || GDBusTypeCode<T>::value[0] == 'q' ||
+	 GDBusTypeCode<T>::value[0] == 'i' || GDBusTypeCode<T>::value[0] == 'u' || GDBusTypeCode<T>::value[0] == 'x' ||
+	 GDBusTypeCode<T>::value[0] == 't' || GDBusTypeCode<T>::value[0] == 'd')>
+{
+	static constexpr char const* typeCode = GDBusTypeCode<T>::value;
+};
+
 template<typename ... TArgs>
 struct GDBusSignatureBuilder<std::tuple<TArgs...>>
 {
@@ -525,6 +875,12 @@ struct GDBusSignatureFiller<std::vector<TVectorType>, TArgs...>
 	}
 };
 
+template<typename TArrayType, size_t N, typename... TArgs>
+struct GDBusSignatureFiller<std::array<TArrayType, N>, TArgs...> : GDBusSignatureFiller<std::vector<TArrayType>, TArgs...>
+{
+
+};
+
 template<typename TCurrent, typename... TArgs>
 struct GDBusSignatureFiller<TCurrent const&, TArgs...> : GDBusSignatureFiller<TCurrent, TArgs...>
 {
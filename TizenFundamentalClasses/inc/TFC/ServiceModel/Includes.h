@@ -33,6 +33,18 @@ namespace ServiceModel {
 
 TFC_ExceptionDeclare	(EndpointException, RuntimeException);
 
+/**
+ * Name of the function generated in every server object interface, which executes the invocations
+ * recorded by ClientEndpoint batch in a single remote call.
+ */
+constexpr char const* batchFunctionName = "_TFCBatch";
+
+/**
+ * Name of the function generated in every server object interface, which is called by the client
+ * to subscribe or unsubscribe an event.
+ */
+constexpr char const* subscriptionFunctionName = "_TFCSubscribe";
+
 }}
 
 
@@ -28,14 +28,20 @@
 #include "TFC/Core/Introspect.h"
 #include "TFC/Core/Invocation.h"
 #include "TFC/Core/Reflection.h"
+#include "TFC/Infrastructures/ScheduledTask.h"
 
 #include "TFC/Serialization/ObjectSerializer.h"
 #include "TFC/Serialization/ParameterSerializer.h"
+#include "TFC/ServiceModel/Includes.h"
 
+#include <chrono>
+#include <list>
 #include <map>
+#include <mutex>
 #include <unordered_map>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace TFC {
 namespace ServiceModel {
@@ -53,6 +59,15 @@ public:
 	struct ServerObjectInvoker
 	{
 		virtual SerializedType Invoke(std::string const&, SerializedType) = 0;
+
+		/**
+		 * Invoke the function by its index in the interface definition, which is the order the
+		 * function is registered. Channels resolve the index once, so the call does not involve
+		 * any string lookup.
+		 */
+		virtual SerializedType Invoke(size_t functionIndex, SerializedType) = 0;
+
+		virtual ~ServerObjectInvoker() { }
 	};
 
 	struct InterfaceEntry
@@ -95,6 +110,18 @@ public:
 
 	virtual ~IServerObject() { }
 
+	std::vector<InterfaceEntry*> GetInterfaceEntryList()
+	{
+		std::vector<InterfaceEntry*> ifaceRet;
+
+		for(auto& obj : ifaceVtable)
+		{
+			ifaceRet.push_back(&(obj.second));
+		}
+
+		return ifaceRet;
+	}
+
 	std::vector<InterfaceDefinition*> GetInterfaceList()
 	{
 		std::vector<InterfaceDefinition*> ifaceRet;
@@ -139,6 +166,7 @@ private:
 	{
 		PointerToMemberFunctionType targetFunc;
 		typename Channel::SerializedType (*delegateFunc)(T* instance, PointerToMemberFunctionType targetFunc, typename Channel::SerializedType p);
+		void (*batchFunc)(T* instance, PointerToMemberFunctionType targetFunc, Deserializer& p, Serializer& response);
 	};
 
 	struct EventRegistration
@@ -157,6 +185,7 @@ private:
 
 	static typename Channel::InterfaceDefinition definition;
 	static std::unordered_map<std::string, FunctionDelegate> functionMap;
+	static std::vector<FunctionDelegate> functionList;
 	static std::unordered_map<std::string, EventRegistration> eventMap;
 	static bool initialized;
 
@@ -171,10 +200,70 @@ private:
 	public:
 		virtual typename Channel::SerializedType Invoke(std::string const& funcName, typename Channel::SerializedType params) override
 		{
-			auto& funcDefinition = functionMap[funcName];
+			if(funcName == batchFunctionName)
+				return InvokeBatch(params);
+
+			auto iter = functionMap.find(funcName);
+
+			if(iter == functionMap.end())
+				throw TFCException("Requested function is not found");
+
+			auto& funcDefinition = iter->second;
 			return funcDefinition.delegateFunc(thiz, funcDefinition.targetFunc, params);
 		}
 
+		virtual typename Channel::SerializedType Invoke(size_t functionIndex, typename Channel::SerializedType params) override
+		{
+			// Batch function is registered after all functions of the interface
+			if(functionIndex == functionList.size())
+				return InvokeBatch(params);
+
+			if(functionIndex >= functionList.size())
+				throw TFCException("Requested function is not found");
+
+			auto& funcDefinition = functionList[functionIndex];
+			return funcDefinition.delegateFunc(thiz, funcDefinition.targetFunc, params);
+		}
+
+		/**
+		 * Execute the invocations packed by the client batch. The request contains the number of
+		 * invocations followed by the function name and parameter scope of each invocation. The
+		 * response contains the result of each invocation in the same order, so an exception thrown
+		 * by one invocation does not prevent the other invocations to be executed.
+		 */
+		typename Channel::SerializedType InvokeBatch(typename Channel::SerializedType params)
+		{
+			Deserializer unpacker(params);
+			decltype(auto) request = unpacker.DeserializeScope();
+
+			uint32_t count = 0;
+			request.Deserialize(count);
+
+			Serializer packer;
+			auto response = packer.CreateScope();
+
+			for(uint32_t i = 0; i < count; i++)
+			{
+				std::string funcName;
+				request.Deserialize(funcName);
+
+				auto iter = functionMap.find(funcName);
+
+				// Parameter of unknown function cannot be skipped, so the whole batch is rejected
+				if(iter == functionMap.end())
+					throw TFCException("Requested function is not found");
+
+				decltype(auto) scope = request.DeserializeScope();
+				auto& funcDefinition = iter->second;
+				funcDefinition.batchFunc(thiz, funcDefinition.targetFunc, scope, response);
+				scope.Finalize();
+			}
+
+			request.Finalize();
+			packer.Serialize(response);
+			return packer.EndPack();
+		}
+
 		friend class ServerObject<TEndpoint, T>;
 	};
 
@@ -182,14 +271,7 @@ protected:
 	ServerObject()
 	{
 		auto ifaceName = Core::GetInterfaceName(TEndpoint::interfacePrefix, typeid(T));
-		if(!initialized)
-		{
-			definition.SetInterfaceName(ifaceName);
-			InitializeInterface();
-			initialized = true;
-		}
-
-		IServerObject<typename TEndpoint::Channel>::RegisterInterface(ifaceName, { new ServerObjectInvoker(this), definition });
+		IServerObject<typename TEndpoint::Channel>::RegisterInterface(ifaceName, { new ServerObjectInvoker(this), GetDefinition() });
 
 		for(auto& eventReg : eventMap)
 		{
@@ -211,6 +293,29 @@ protected:
 			typedef Serialization::ObjectSerializer<Serializer, typename Core::Introspect::MemberFunction<TFuncPtr>::ReturnType> Serializer;
 			return Serializer::Serialize(var);
 		}
+
+		static void BatchFunc(T* instance, PointerToMemberFunctionType targetFunc, Deserializer& p, Serializer& response)
+		{
+			typedef typename Core::Introspect::MemberFunction<TFuncPtr>::ReturnType ReturnType;
+			auto targetFuncCasted = reinterpret_cast<TFuncPtr>(targetFunc);
+			typedef Core::DelayedInvoker<TFuncPtr> Invoker;
+
+			// Parameters which fail to deserialize are reported as the error of this entry
+			try
+			{
+				auto params = Serialization::ParameterDeserializer<Deserializer, TFuncPtr>::Deserialize(p);
+				auto var = Invoker::Invoke(instance, targetFuncCasted, params);
+
+				response.Serialize(true);
+				auto scope = response.CreateScope();
+				Serialization::SerializerFunctor<Serializer, ReturnType>::Func(scope, var);
+				response.Serialize(scope);
+			}
+			catch(std::exception& ex)
+			{
+				SerializeBatchError(response, ex);
+			}
+		}
 	};
 
 	template<typename TFuncPtr>
@@ -228,8 +333,35 @@ protected:
 			typedef Serialization::ObjectSerializer<Serializer, typename Core::Introspect::MemberFunction<TFuncPtr>::ReturnType> Serializer;
 			return Serializer::Serialize();
 		}
+
+		static void BatchFunc(T* instance, PointerToMemberFunctionType targetFunc, Deserializer& p, Serializer& response)
+		{
+			auto targetFuncCasted = reinterpret_cast<TFuncPtr>(targetFunc);
+			typedef Core::DelayedInvoker<TFuncPtr> Invoker;
+
+			try
+			{
+				auto params = Serialization::ParameterDeserializer<Deserializer, TFuncPtr>::Deserialize(p);
+				Invoker::Invoke(instance, targetFuncCasted, params);
+
+				response.Serialize(true);
+				auto scope = response.CreateScope();
+				response.Serialize(scope);
+			}
+			catch(std::exception& ex)
+			{
+				SerializeBatchError(response, ex);
+			}
+		}
 	};
 
+	static void SerializeBatchError(Serializer& response, std::exception const& ex)
+	{
+		response.Serialize(false);
+		response.Serialize(std::string(typeid(ex).name()));
+		response.Serialize(std::string(ex.what()));
+	}
+
 	template<typename>
 	friend struct EventHandlerClosure;
 
@@ -273,15 +405,16 @@ protected:
 	{
 		auto& typeDescription = Core::TypeInfo<T>::typeDescription;
 
-		functionMap.emplace(
-			std::make_pair<std::string, FunctionDelegate>(
-				typeDescription.GetFunctionNameByPointer(ptr),
-				{
-					reinterpret_cast<PointerToMemberFunctionType>(ptr),
-					InvokerSelector<TFuncPtr>::Func
-				}
-		));
+		FunctionDelegate delegate {
+			reinterpret_cast<PointerToMemberFunctionType>(ptr),
+			InvokerSelector<TFuncPtr>::Func,
+			InvokerSelector<TFuncPtr>::BatchFunc
+		};
+
+		functionMap.emplace(typeDescription.GetFunctionNameByPointer(ptr), delegate);
 
+		// Index in functionList follows the order in the interface definition
+		functionList.push_back(delegate);
 		definition.RegisterFunction(ptr);
 	}
 
@@ -309,6 +442,24 @@ protected:
 
 
 public:
+	/**
+	 * Get the interface definition of T, which is initialized on the first access, so it can be
+	 * obtained before any server object of T is constructed.
+	 */
+	static typename Channel::InterfaceDefinition& GetDefinition()
+	{
+		if(!initialized)
+		{
+			definition.SetInterfaceName(Core::GetInterfaceName(TEndpoint::interfacePrefix, typeid(T)));
+			InitializeInterface();
+			definition.RegisterBatchFunction(batchFunctionName);
+			definition.RegisterSubscriptionFunction(subscriptionFunctionName);
+			initialized = true;
+		}
+
+		return definition;
+	}
+
 	virtual ~ServerObject() { }
 };
 
@@ -321,6 +472,9 @@ typename ServerObject<TEndpoint, T>::Channel::InterfaceDefinition ServerObject<T
 template<typename TEndpoint, typename T>
 std::unordered_map<std::string, typename ServerObject<TEndpoint, T>::FunctionDelegate> ServerObject<TEndpoint, T>::functionMap;
 
+template<typename TEndpoint, typename T>
+std::vector<typename ServerObject<TEndpoint, T>::FunctionDelegate> ServerObject<TEndpoint, T>::functionList;
+
 template<typename TEndpoint, typename T>
 std::unordered_map<std::string, typename ServerObject<TEndpoint, T>::EventRegistration> ServerObject<TEndpoint, T>::eventMap;
 
@@ -330,7 +484,7 @@ class IServerObjectManager
 public:
 	typedef typename TEndpoint::Channel Channel;
 	typedef typename Channel::InterfaceDefinition InterfaceDefinition;
-	typedef typename TEndpoint::SerializedType SerializedType;
+	typedef typename Channel::SerializedType SerializedType;
 
 	virtual InterfaceDefinition const& GetInterfaceDefinition() = 0;
 	virtual SerializedType Invoke(int id, std::string const& function, SerializedType param) = 0;
@@ -338,24 +492,200 @@ public:
 	virtual ~IServerObjectManager() { }
 };
 
+/**
+ * Manager of server objects of interface T which are created on demand for each client id, so a
+ * service can keep a separate state for each of its clients. The least recently used object is
+ * destroyed when the number of objects reaches the limit, and the objects which are idle longer
+ * than the time to live are destroyed periodically. The periodic eviction uses ScheduledTask, so
+ * the manager must be constructed and destroyed on the main loop thread.
+ */
 template<typename TEndpoint, typename T>
 class ServerObjectManager : public IServerObjectManager<TEndpoint>
 {
 public:
 	typedef typename TEndpoint::Channel Channel;
 	typedef typename Channel::InterfaceDefinition InterfaceDefinition;
-	typedef typename TEndpoint::SerializedType SerializedType;
+	typedef typename Channel::SerializedType SerializedType;
+	typedef std::function<ServerObject<TEndpoint, T>*(int id)> ObjectFactory;
+
+	/**
+	 * Construct the manager. The factory creates the server object for a client id, whose ownership
+	 * is transferred to the manager. Idle objects are not evicted if the time to live is zero.
+	 */
+	ServerObjectManager(ObjectFactory factory, size_t maxObjects,
+		std::chrono::milliseconds idleTimeToLive = std::chrono::milliseconds::zero()) :
+		factory(std::move(factory)), maxObjects(maxObjects), idleTimeToLive(idleTimeToLive),
+		evictionTask(*this)
+	{
+		TFCAssert<ArgumentException>(this->factory != nullptr, "Server object factory cannot be empty");
+		TFCAssert<ArgumentException>(maxObjects > 0, "Maximum number of server objects must be positive");
 
-protected:
+		if(idleTimeToLive > std::chrono::milliseconds::zero())
+			evictionTask.SchedulePeriodic(std::chrono::system_clock::now() + idleTimeToLive, idleTimeToLive);
+	}
+
+	virtual InterfaceDefinition const& GetInterfaceDefinition() override
+	{
+		return ServerObject<TEndpoint, T>::GetDefinition();
+	}
+
+	virtual SerializedType Invoke(int id, std::string const& function, SerializedType param) override
+	{
+		// The copy keeps the object alive if it is evicted while the function is executing
+		auto info = Acquire(id);
+		return info.entry->invoker->Invoke(function, param);
+	}
+
+	/**
+	 * Destroy the objects which are not accessed within the time to live. It is called by the
+	 * periodic eviction, but can also be called directly. Does nothing if the time to live is zero.
+	 */
+	void EvictIdle()
+	{
+		if(idleTimeToLive <= std::chrono::milliseconds::zero())
+			return;
+
+		std::vector<std::shared_ptr<ServerObject<TEndpoint, T>>> evicted;
+		std::lock_guard<std::mutex> guard(objectLock);
+
+		auto deadline = Clock::now() - idleTimeToLive;
+
+		// The list is ordered by the access time, so the scan stops at the first live object
+		while(!recentList.empty())
+		{
+			auto iter = objectDictionary.find(recentList.back());
+			if(iter->second.lastAccessed > deadline)
+				break;
+
+			evicted.push_back(std::move(iter->second.instance));
+			objectDictionary.erase(iter);
+			recentList.pop_back();
+		}
+	}
+
+	/**
+	 * Destroy the object of the specified client id, if any.
+	 */
+	void Remove(int id)
+	{
+		std::shared_ptr<ServerObject<TEndpoint, T>> evicted;
+		std::lock_guard<std::mutex> guard(objectLock);
+
+		auto iter = objectDictionary.find(id);
+		if(iter != objectDictionary.end())
+			evicted = Evict(iter);
+	}
+
+	bool Contains(int id)
+	{
+		std::lock_guard<std::mutex> guard(objectLock);
+		return objectDictionary.find(id) != objectDictionary.end();
+	}
+
+	size_t GetObjectCount()
+	{
+		std::lock_guard<std::mutex> guard(objectLock);
+		return objectDictionary.size();
+	}
 
 private:
+	typedef std::chrono::steady_clock Clock;
+
 	struct ManagedObjectInfo
 	{
-		ServerObject<TEndpoint, T>* instance;
-		long long lastAccessed;
+		std::shared_ptr<ServerObject<TEndpoint, T>> instance;
+		typename IServerObject<Channel>::InterfaceEntry* entry;
+		Clock::time_point lastAccessed;
+		std::list<int>::iterator position;
 	};
 
-	std::map<int, ManagedObjectInfo> objectDictionary;
+	class EvictionTask : public Infrastructures::ScheduledTask
+	{
+	private:
+		ServerObjectManager& owner;
+	public:
+		EvictionTask(ServerObjectManager& owner) : owner(owner) { }
+	protected:
+		virtual void Run() override { owner.EvictIdle(); }
+	};
+
+	typedef typename std::unordered_map<int, ManagedObjectInfo>::iterator ObjectIterator;
+
+	ManagedObjectInfo Acquire(int id)
+	{
+		// Declared before the locks, so the evicted objects are destroyed after the lock is released
+		std::vector<std::shared_ptr<ServerObject<TEndpoint, T>>> evicted;
+
+		{
+			std::lock_guard<std::mutex> guard(objectLock);
+
+			auto iter = objectDictionary.find(id);
+			if(iter != objectDictionary.end())
+				return Touch(iter->second);
+		}
+
+		// Factory runs without the lock, so it does not block the calls of the other clients
+		std::shared_ptr<ServerObject<TEndpoint, T>> instance(factory(id));
+		TFCAssert<TFCException>(instance != nullptr, "Server object factory returns null");
+
+		typename IServerObject<Channel>::InterfaceEntry* entry = nullptr;
+		for(auto candidate : instance->GetInterfaceEntryList())
+		{
+			if(&candidate->definition == &ServerObject<TEndpoint, T>::GetDefinition())
+				entry = candidate;
+		}
+
+		// Checked before the object is managed, so Invoke never finds an object without the entry
+		TFCAssert<TFCException>(entry != nullptr, "Server object created by the factory does not implement the interface");
+
+		std::lock_guard<std::mutex> guard(objectLock);
+
+		// Another call of the same client may have created its object meanwhile, which is kept so
+		// the client has only one object
+		auto iter = objectDictionary.find(id);
+		if(iter != objectDictionary.end())
+		{
+			evicted.push_back(std::move(instance));
+			return Touch(iter->second);
+		}
+
+		while(objectDictionary.size() >= maxObjects)
+			evicted.push_back(Evict(objectDictionary.find(recentList.back())));
+
+		recentList.push_front(id);
+
+		ManagedObjectInfo info { std::move(instance), entry, Clock::now(), recentList.begin() };
+		objectDictionary.emplace(id, info);
+		return info;
+	}
+
+	ManagedObjectInfo& Touch(ManagedObjectInfo& info)
+	{
+		info.lastAccessed = Clock::now();
+		recentList.splice(recentList.begin(), recentList, info.position);
+		return info;
+	}
+
+	std::shared_ptr<ServerObject<TEndpoint, T>> Evict(ObjectIterator iter)
+	{
+		auto instance = std::move(iter->second.instance);
+		recentList.erase(iter->second.position);
+		objectDictionary.erase(iter);
+		return instance;
+	}
+
+	ObjectFactory factory;
+	size_t maxObjects;
+	std::chrono::milliseconds idleTimeToLive;
+
+	std::mutex objectLock;
+	std::unordered_map<int, ManagedObjectInfo> objectDictionary;
+
+	// Most recently used client id is at the front
+	std::list<int> recentList;
+
+	// Declared last, so the timer is cancelled before the objects are destroyed
+	EvictionTask evictionTask;
 };
 
 }}
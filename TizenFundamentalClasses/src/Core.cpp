@@ -186,14 +186,14 @@ TFC::ManagedClass::SafePointer::SafePointer(const SafePointer& that)
 	this->handle = that.handle;
 	this->handle->IncrementReference();
 
-	dlog_print(DLOG_DEBUG, LOG_TAG, "Safe pointer copied: %d, handle: %d", (int)this, (int)this->handle);
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Safe pointer copied: %p, handle: %p", (void*)this, (void*)this->handle);
 }
 
 LIBAPI
 TFC::ManagedClass::SafePointer::SafePointer(SharedHandle* handle) : handle(handle) {
 	handle->IncrementReference();
 
-	dlog_print(DLOG_DEBUG, LOG_TAG, "Safe pointer created: %d, handle: %d", (int)this, (int)this->handle);
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Safe pointer created: %p, handle: %p", (void*)this, (void*)this->handle);
 }
 
 LIBAPI
@@ -201,12 +201,12 @@ TFC::ManagedClass::SafePointer::SafePointer(SafePointer&& that) {
 	this->handle = that.handle;
 	that.handle = nullptr;
 
-	dlog_print(DLOG_DEBUG, LOG_TAG, "Safe pointer moved: %d, handle: %d", (int)this, (int)this->handle);
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Safe pointer moved: %p, handle: %p", (void*)this, (void*)this->handle);
 }
 
 LIBAPI
 TFC::ManagedClass::SafePointer::~SafePointer() {
-	dlog_print(DLOG_DEBUG, LOG_TAG, "Safe pointer deleted: %d, handle: %d", (int)this, (int)this->handle);
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Safe pointer deleted: %p, handle: %p", (void*)this, (void*)this->handle);
 
 	if(this->handle != nullptr && this->handle->DecrementReference())
 		delete this->handle;
@@ -231,27 +231,27 @@ TFC::ManagedClass::SafePointer TFC::ManagedClass::GetSafePointer()
 }
 
 TFC::ManagedClass::SharedHandle::SharedHandle() : referenceCount(1), isDestructed(false) {
-	dlog_print(DLOG_DEBUG, LOG_TAG, "Shared handle created. Handle: %d", (int)this);
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Shared handle created. Handle: %p", (void*)this);
 }
 
 void TFC::ManagedClass::SharedHandle::IncrementReference() {
 	++this->referenceCount;
-	dlog_print(DLOG_DEBUG, LOG_TAG, "Increment reference. Handle: %d, ref: %d", (int)this, this->referenceCount);
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Increment reference. Handle: %p, ref: %d", (void*)this, this->referenceCount);
 }
 
 bool TFC::ManagedClass::SharedHandle::DecrementReference() {
-	dlog_print(DLOG_DEBUG, LOG_TAG, "Decrement reference. Handle: %d, ref: %d", (int)this, this->referenceCount - 1);
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Decrement reference. Handle: %p, ref: %d", (void*)this, this->referenceCount - 1);
 	return --this->referenceCount == 0;
 }
 
 bool TFC::ManagedClass::SharedHandle::NotifyDestruction() {
 	this->isDestructed = true;
-	dlog_print(DLOG_DEBUG, LOG_TAG, "The owner object is destroyed. Handle: %d", (int)this);
+	dlog_print(DLOG_DEBUG, LOG_TAG, "The owner object is destroyed. Handle: %p", (void*)this);
 	return --this->referenceCount == 0;
 }
 
 TFC::ManagedClass::SharedHandle::~SharedHandle() {
-	dlog_print(DLOG_DEBUG, LOG_TAG, "The shared handle is destroyed. Handle: %d", (int)this);
+	dlog_print(DLOG_DEBUG, LOG_TAG, "The shared handle is destroyed. Handle: %p", (void*)this);
 }
 
 bool TFC::ManagedClass::SharedHandle::IsDestructed() {
@@ -0,0 +1,151 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Net/ConnectionPool.cpp
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#include "TFC/Net/ConnectionPool.h"
+
+#include <dlog.h>
+
+using namespace TFC::Net;
+
+namespace TFC {
+namespace Net {
+
+void ConnectionPool_Lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr)
+{
+	reinterpret_cast<ConnectionPool*>(userptr)->shareLock[data].lock();
+}
+
+void ConnectionPool_Unlock(CURL* handle, curl_lock_data data, void* userptr)
+{
+	reinterpret_cast<ConnectionPool*>(userptr)->shareLock[data].unlock();
+}
+
+}
+}
+
+LIBAPI TFC::Net::ConnectionPool::ConnectionPool(size_t maxIdleHandles) :
+	maxIdleHandles(maxIdleHandles)
+{
+	// Share handle is not initialized implicitly like the easy handle
+	curl_global_init(CURL_GLOBAL_DEFAULT);
+
+	share = curl_share_init();
+
+	if(share)
+	{
+		curl_share_setopt(share, CURLSHOPT_LOCKFUNC, ConnectionPool_Lock);
+		curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, ConnectionPool_Unlock);
+		curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+		curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+		curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+		// Older libcurl keeps the connection cache in each easy handle, which is still reused
+		// as the handles are pooled
+		curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+	}
+	else
+	{
+		dlog_print(DLOG_ERROR, LOG_TAG, "Failed to create curl share handle");
+	}
+}
+
+LIBAPI TFC::Net::ConnectionPool::~ConnectionPool()
+{
+	for(auto handle : idleHandles)
+		curl_easy_cleanup(handle);
+
+	if(share)
+		curl_share_cleanup(share);
+}
+
+LIBAPI ConnectionPool& TFC::Net::ConnectionPool::GetDefault()
+{
+	static ConnectionPool defaultPool;
+	return defaultPool;
+}
+
+LIBAPI ConnectionPool::Handle TFC::Net::ConnectionPool::Acquire()
+{
+	CURL* handle = nullptr;
+
+	{
+		std::lock_guard<std::mutex> guard(poolLock);
+		if(!idleHandles.empty())
+		{
+			handle = idleHandles.back();
+			idleHandles.pop_back();
+		}
+	}
+
+	if(!handle)
+		handle = curl_easy_init();
+
+	// Reset handle loses the share option, so it is set on every acquisition
+	Share(handle);
+
+	return { this, handle };
+}
+
+LIBAPI void TFC::Net::ConnectionPool::Share(CURL* handle)
+{
+	if(handle && share)
+		curl_easy_setopt(handle, CURLOPT_SHARE, share);
+}
+
+LIBAPI size_t TFC::Net::ConnectionPool::GetIdleHandleCount()
+{
+	std::lock_guard<std::mutex> guard(poolLock);
+	return idleHandles.size();
+}
+
+void TFC::Net::ConnectionPool::Release(CURL* handle)
+{
+	curl_easy_reset(handle);
+
+	{
+		std::lock_guard<std::mutex> guard(poolLock);
+		if(idleHandles.size() < maxIdleHandles)
+		{
+			idleHandles.push_back(handle);
+			return;
+		}
+	}
+
+	curl_easy_cleanup(handle);
+}
+
+LIBAPI TFC::Net::ConnectionPool::Handle::Handle(ConnectionPool* pool, CURL* handle) :
+	pool(pool), handle(handle)
+{
+}
+
+LIBAPI TFC::Net::ConnectionPool::Handle::Handle(Handle&& other) :
+	pool(other.pool), handle(other.handle)
+{
+	other.handle = nullptr;
+}
+
+LIBAPI TFC::Net::ConnectionPool::Handle::~Handle()
+{
+	if(handle)
+		pool->Release(handle);
+}
@@ -22,6 +22,7 @@
  */
 
 #include "TFC/Net/ImageCache.h"
+#include "TFC/Net/ConnectionPool.h"
 
 #define __STDBOOL_H // Remove STDBOOL
 #include <app.h>
@@ -159,7 +160,7 @@ std::string LIBAPI TFC::Net::ImageCache::LoadImage(const std::string& url)
 		return retFile;
 	}
 
-	auto curlHandle = curl_easy_init();
+	auto curlHandle = ConnectionPool::GetDefault().Acquire();
 
 	if (curlHandle) {
 		// Include timestamp in the filename to prevent duplicates
@@ -206,10 +207,6 @@ std::string LIBAPI TFC::Net::ImageCache::LoadImage(const std::string& url)
 				sqlite3_finalize(statement);
 			}
 		}
-		/* always cleanup */
-		curl_easy_cleanup(curlHandle);
-
-
 		return filePath;
 	}
 	else
@@ -51,22 +51,6 @@ std::string GenerateTimestamp()
 	return std::to_string(duration);
 }
 
-std::string PercentEncode(std::string const& base)
-{
-	std::stringstream st;
-	size_t len = base.length();
-	auto str = base.c_str();
-
-	for(int i = 0; i < len; i++)
-	{
-		if(isalnum(str[i]) || str[i] == '-' || str[i] == '.' || str[i] == '_' || str[i] == '~')
-			st << str[i];
-		else
-			st << "%" << std::hex << std::uppercase << ((int)str[i]);
-	}
-	return st.str();
-}
-
 LIBAPI TFC::Net::AuthHeader::AuthHeader(
 		std::string const& consumerKey,
 		std::string const& consumerSecret,
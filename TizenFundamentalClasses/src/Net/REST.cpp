@@ -25,13 +25,26 @@
 #include <exception>
 
 #include "TFC/Net/REST.h"
+#include "TFC/Net/ConnectionPool.h"
+#include "TFC/Net/RESTEngine.h"
+#include "TFC/Net/RequestPolicy.h"
+#include "TFC/Net/ResponseCache.h"
+#include "TFC/Net/RESTStatistics.h"
 #include "TFC/Net/Util.h"
 
-#define REGEX_URLPARAM R"REGEX((\{([A-Za-z0-9_]+)\}))REGEX"
-#include <regex>
-
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <istream>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
+#include <strings.h>
+#include <thread>
 #include <vector>
 #include <dlog.h>
 
@@ -59,24 +72,21 @@ void RESTServiceTemplateBase::RegisterParameter(ParameterType paramType, char co
 
 std::string RESTServiceTemplateBase::PreparePostData(const std::unordered_map<std::string, IServiceParameter*>& postDataParam)
 {
-	std::stringstream postDataStream;
+	std::string postData;
 
-	bool first = true;
 	for(auto& val : postDataParam)
 	{
 		if(!val.second->isSet)
 			continue;
 
-		if(!first)
-			postDataStream << "&";
-		first = false;
+		if(!postData.empty())
+			postData += '&';
 
-		postDataStream << val.first << "=" << val.second->GetEncodedValue();
+		postData += val.first;
+		postData += '=';
+		postData += val.second->GetEncodedValue();
 	}
 
-	std::string postData = postDataStream.str();
-
-
 	return postData;
 }
 
@@ -120,18 +130,7 @@ LIBAPI std::string TFC::Net::GenericServiceParameter<std::string>::GetRawValue()
 template<>
 LIBAPI std::string TFC::Net::GenericServiceParameter<std::string>::GetEncodedValue()
 {
-	std::stringstream st;
-	size_t len = this->value.length();
-	auto str = this->value.c_str();
-
-	for(int i = 0; i < len; i++)
-	{
-		if(isalnum(str[i]))
-			st << str[i];
-		else
-			st << "%" << std::hex << ((int)str[i]);
-	}
-	return st.str();
+	return PercentEncode(this->value);
 }
 
 
@@ -195,113 +194,118 @@ struct curl_slist* TFC::Net::RESTServiceTemplateBase::PrepareHeader()
 TFC::Net::RESTServiceTemplateBase::RESTServiceTemplateBase(std::string url, HTTPMode httpMode) :
 	UserAgent("TFC-framework-tizen/1.0"),
 	Url(url),
+	StreamResponse(false),
+	AcceptCompressedResponse(true),
+	CompressRequestThreshold(0),
+	PreferHTTP2(true),
+	Cache(nullptr),
+	Policy(&RequestPolicy::GetDefault()),
+	Statistics(nullptr),
 	httpMode(httpMode),
 	working(false)
 {
+	ParseUrlTemplate();
 }
 
-std::string TFC::Net::RESTServiceTemplateBase::PrepareUrl()
+void TFC::Net::RESTServiceTemplateBase::ParseUrlTemplate()
 {
-	// Construct query string
-	std::stringstream urlBuffer;
-
-	// Resolve parameter on URL using regex
-	std::regex urlRegex(REGEX_URLPARAM);
+	urlTemplate = Url;
+	urlTokens.clear();
 
-	std::string& text = this->Url;
+	// Parameter is a name of letters, digits, and underscores enclosed in braces, as {name}
+	auto isNameChar = [] (char c) {
+		return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+	};
 
-	std::sregex_iterator words_begin(text.begin(), text.end(), urlRegex);
-	auto words_end = std::sregex_iterator();
+	size_t literalStart = 0;
+	size_t position = 0;
 
-	auto lastToken = text.cbegin();
-
-	for (std::sregex_iterator i = words_begin; i != words_end; ++i) {
-		std::smatch match = *i;
-
-		// Flush to buffer
-		auto tokenEnd = match[1].first;
-		auto strCurr = std::string(lastToken, tokenEnd);
-		lastToken = match[1].second;
-
-		urlBuffer << strCurr;
+	while((position = urlTemplate.find('{', position)) != std::string::npos)
+	{
+		size_t nameEnd = position + 1;
+		while(nameEnd < urlTemplate.size() && isNameChar(urlTemplate[nameEnd]))
+			nameEnd++;
 
-		auto param = urlParam.find(match[2].str());
-		if(param == urlParam.end())
+		// Brace which does not enclose a name is a part of the literal
+		if(nameEnd == position + 1 || nameEnd == urlTemplate.size() || urlTemplate[nameEnd] != '}')
 		{
-			dlog_print(DLOG_ERROR, "Parameter not found: %s", match[2].str().c_str());
-			throw std::runtime_error("Parameter not found");
+			position++;
+			continue;
 		}
 
-		auto paramInstance = param->second;
-		if(!paramInstance->isSet)
-		{
-			dlog_print(DLOG_ERROR, "Parameter not set: %s", param->first.c_str());
-			throw std::runtime_error("Parameter not set");
-		}
-		urlBuffer << paramInstance->GetEncodedValue();
+		if(position > literalStart)
+			urlTokens.push_back({ literalStart, position - literalStart, false, nullptr });
+
+		urlTokens.push_back({ position + 1, nameEnd - position - 1, true, nullptr });
+
+		position = literalStart = nameEnd + 1;
 	}
 
-	// Flush remaining url to buffer
-	urlBuffer << std::string(lastToken, text.cend());
+	if(literalStart < urlTemplate.size())
+		urlTokens.push_back({ literalStart, urlTemplate.size() - literalStart, false, nullptr });
+}
 
-	std::string ret = urlBuffer.str();
-	OnAfterUrlReady(ret);
-	return ret;
+std::string TFC::Net::RESTServiceTemplateBase::PrepareUrl()
+{
+	if(urlTemplate != Url)
+		ParseUrlTemplate();
 
-	/*
+	std::string url;
+	url.reserve(urlTemplate.size() + 64);
 
-	if (queryStringParam.size())
+	for(auto& token : urlTokens)
 	{
-		urlBuffer << "?";
-		bool first = true;
-		for (auto queryString : queryStringParam)
+		if(!token.isParameter)
 		{
-			dlog_print(DLOG_DEBUG, LOG_TAG, "Param: %s", queryString.first);
-
-			if (!queryString.second->isSet)
-				continue;
-
-			if (first)
-				first = false;
-			else
-				urlBuffer << "&";
-
-			auto val = queryString.second->GetEncodedValue();
+			url.append(urlTemplate, token.offset, token.length);
+			continue;
+		}
 
+		if(!token.parameter)
+		{
+			auto param = urlParam.find(urlTemplate.substr(token.offset, token.length));
+			if(param == urlParam.end())
+			{
+				dlog_print(DLOG_ERROR, LOG_TAG, "Parameter not found: %s", urlTemplate.substr(token.offset, token.length).c_str());
+				throw std::runtime_error("Parameter not found");
+			}
+
+			token.parameter = param->second;
+		}
 
-			urlBuffer << queryString.first << "=" << val;
+		if(!token.parameter->isSet)
+		{
+			dlog_print(DLOG_ERROR, LOG_TAG, "Parameter not set: %s", urlTemplate.substr(token.offset, token.length).c_str());
+			throw std::runtime_error("Parameter not set");
 		}
+
+		url += token.parameter->GetEncodedValue();
 	}
-	*/
 
+	OnAfterUrlReady(url);
+	return url;
 }
 
 std::string TFC::Net::RESTServiceTemplateBase::PrepareQueryString()
 {
-	std::stringstream queryBuf;
+	std::string query;
 
-	if (queryStringParam.size())
+	for (auto& queryString : queryStringParam)
 	{
-		bool first = true;
-		for (auto queryString : queryStringParam)
-		{
-			dlog_print(DLOG_DEBUG, LOG_TAG, "Param: %s", queryString.first);
+		dlog_print(DLOG_DEBUG, LOG_TAG, "Param: %s", queryString.first);
 
-			if (!queryString.second->isSet)
-				continue;
-
-			if (first)
-				first = false;
-			else
-				queryBuf << "&";
+		if (!queryString.second->isSet)
+			continue;
 
-			auto val = queryString.second->GetEncodedValue();
+		if (!query.empty())
+			query += '&';
 
-			queryBuf << queryString.first << "=" << val;
-		}
+		query += queryString.first;
+		query += '=';
+		query += queryString.second->GetEncodedValue();
 	}
 
-	return queryBuf.str();
+	return query;
 }
 
 class VectorWrapper: public std::streambuf
@@ -316,124 +320,793 @@ public:
 	}
 };
 
-size_t RESTServiceTemplateBase_WriteCallback(char *data, size_t size, size_t nmemb, void* d)
+size_t TFC::Net::RESTServiceTemplateBase_WriteCallback(char *data, size_t size, size_t nmemb, void* d)
 {
-	auto str = reinterpret_cast<std::vector<char>*>(d);
+	auto state = reinterpret_cast<RESTServiceTemplateBase::TransferState*>(d);
+	size_t realsize = nmemb * size;
 
+	if(state->service->StreamResponse)
+	{
+		long httpCode = 0;
+		curl_easy_getinfo(state->handle, CURLINFO_RESPONSE_CODE, &httpCode);
+
+		state->responseStarted = true;
+
+		// Returning less than the chunk size aborts the transfer
+		return state->service->OnResponseChunk(httpCode, data, realsize) ? realsize : 0;
+	}
+
+#if LIBCURL_VERSION_NUM >= 0x073700
+	// Allocate the whole body at once if the server tells its length
+	if(state->buffer.empty())
+	{
+		curl_off_t contentLength = -1;
+		curl_easy_getinfo(state->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &contentLength);
+
+		if(contentLength > 0)
+			state->buffer.reserve(contentLength);
+	}
+#endif
+
+	state->buffer.append(data, realsize);
+	return realsize;
+}
+
+size_t TFC::Net::RESTServiceTemplateBase_HeaderCallback(char *data, size_t size, size_t nmemb, void* d)
+{
+	auto state = reinterpret_cast<RESTServiceTemplateBase::TransferState*>(d);
 	size_t realsize = nmemb * size;
-	str->insert(str->end(), data, data + realsize);
+
+	// Status line starts the headers of another response, such as after a redirection
+	if(realsize >= 5 && strncmp(data, "HTTP/", 5) == 0)
+	{
+		state->eTag.clear();
+		state->lastModified.clear();
+		state->cacheControl.clear();
+		state->expires.clear();
+		return realsize;
+	}
+
+	std::string line(data, realsize);
+	auto separator = line.find(':');
+	if(separator == std::string::npos)
+		return realsize;
+
+	auto valueStart = line.find_first_not_of(" \t", separator + 1);
+	auto valueEnd = line.find_last_not_of(" \t\r\n");
+
+	std::string value;
+	if(valueStart != std::string::npos && valueEnd >= valueStart)
+		value = line.substr(valueStart, valueEnd - valueStart + 1);
+
+	line.resize(separator);
+
+	if(strcasecmp(line.c_str(), "ETag") == 0)
+		state->eTag = std::move(value);
+	else if(strcasecmp(line.c_str(), "Last-Modified") == 0)
+		state->lastModified = std::move(value);
+	else if(strcasecmp(line.c_str(), "Cache-Control") == 0)
+		state->cacheControl = std::move(value);
+	else if(strcasecmp(line.c_str(), "Expires") == 0)
+		state->expires = std::move(value);
 
 	return realsize;
 }
 
-RESTResultBase TFC::Net::RESTServiceTemplateBase::PerformCall()
+TFC::Net::RESTServiceTemplateBase::TransferState::TransferState() :
+	service(nullptr),
+	handle(nullptr),
+	headerList(nullptr),
+	cacheHit(false),
+	responseCode(0),
+	attempt(1),
+	responseStarted(false)
+{
+}
+
+TFC::Net::RESTServiceTemplateBase::TransferState::~TransferState()
+{
+	curl_slist_free_all(headerList);
+}
+
+void TFC::Net::RESTServiceTemplateBase::TransferState::ResetResponse()
+{
+	buffer.clear();
+	eTag.clear();
+	lastModified.clear();
+	cacheControl.clear();
+	expires.clear();
+	responseCode = 0;
+}
+
+void TFC::Net::RESTServiceTemplateBase::TransferState::AdoptResponse(TransferState& hedge)
+{
+	buffer = std::move(hedge.buffer);
+	eTag = std::move(hedge.eTag);
+	lastModified = std::move(hedge.lastModified);
+	cacheControl = std::move(hedge.cacheControl);
+	expires = std::move(hedge.expires);
+	responseCode = hedge.responseCode;
+
+	// Attempts are counted by this request
+	metrics = hedge.metrics;
+	metrics.attempts = attempt;
+}
+
+void TFC::Net::RESTServiceTemplateBase::TransferState::ReadTransferInfo(CURL* completedHandle)
+{
+	curl_easy_getinfo(completedHandle, CURLINFO_RESPONSE_CODE, &responseCode);
+
+	auto readTime = [completedHandle] (CURLINFO info) {
+		double seconds = 0;
+		curl_easy_getinfo(completedHandle, info, &seconds);
+		return std::chrono::microseconds((int64_t)(seconds * 1000000));
+	};
+
+	metrics.nameLookupTime = readTime(CURLINFO_NAMELOOKUP_TIME);
+	metrics.connectTime = readTime(CURLINFO_CONNECT_TIME);
+	metrics.appConnectTime = readTime(CURLINFO_APPCONNECT_TIME);
+	metrics.startTransferTime = readTime(CURLINFO_STARTTRANSFER_TIME);
+	metrics.totalTime = readTime(CURLINFO_TOTAL_TIME);
+
+#if LIBCURL_VERSION_NUM >= 0x073700
+	curl_off_t bytes = 0;
+	curl_easy_getinfo(completedHandle, CURLINFO_SIZE_UPLOAD_T, &bytes);
+	metrics.bytesUploaded = (uint64_t)bytes;
+
+	bytes = 0;
+	curl_easy_getinfo(completedHandle, CURLINFO_SIZE_DOWNLOAD_T, &bytes);
+	metrics.bytesDownloaded = (uint64_t)bytes;
+#else
+	double bytes = 0;
+	curl_easy_getinfo(completedHandle, CURLINFO_SIZE_UPLOAD, &bytes);
+	metrics.bytesUploaded = (uint64_t)bytes;
+
+	bytes = 0;
+	curl_easy_getinfo(completedHandle, CURLINFO_SIZE_DOWNLOAD, &bytes);
+	metrics.bytesDownloaded = (uint64_t)bytes;
+#endif
+
+	// No new connection is made if a pooled connection is reused
+	long connects = 0;
+	curl_easy_getinfo(completedHandle, CURLINFO_NUM_CONNECTS, &connects);
+	metrics.connectionReused = connects == 0;
+	metrics.attempts = attempt;
+}
+
+namespace {
+
+/*
+ * Response of a request with credentials may be private to the user, so it is never cached.
+ */
+bool HasCredentials(struct curl_slist const* headerList)
+{
+	for(auto header = headerList; header != nullptr; header = header->next)
+	{
+		if(strncasecmp(header->data, "Authorization:", 14) == 0 ||
+		   strncasecmp(header->data, "Proxy-Authorization:", 20) == 0 ||
+		   strncasecmp(header->data, "Cookie:", 7) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+}
+
+bool TFC::Net::RESTServiceTemplateBase::PrepareTransfer(CURL* curlHandle, TransferState& state, bool multiplexed)
 {
 	OnBeforePrepareRequest();
 
 	this->working = true;
-	auto curlHandle = curl_easy_init();
 
-	RESTResultBase returnObj;
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Prepare URL");
+
+	// Construct query string
+	std::string url = PrepareUrl();
+	std::string query = PrepareQueryString();
+
+	FinalUrl = url;
+
+	if(query.length())
+	{
+		FinalUrl += "?";
+		FinalUrl += query;
+	}
+
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Final url: %s", FinalUrl.c_str());
+
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Prepare Header");
+
+	// Construct header list
+	state.headerList = PrepareHeader();
+
+	if(Cache && httpMode == HTTPMode::Get && !StreamResponse && !HasCredentials(state.headerList))
+	{
+		PrepareCache(state);
+
+		// Fresh response is served without transferring the request
+		if(state.cacheHit)
+			return false;
 
-	if (curlHandle)
+		curl_easy_setopt(curlHandle, CURLOPT_HEADERDATA, (void* ) &state);
+		curl_easy_setopt(curlHandle, CURLOPT_HEADERFUNCTION, RESTServiceTemplateBase_HeaderCallback);
+	}
+
+	// Streamed response cannot be shared, as it is delivered to the chunk handler of one service
+	if(httpMode == HTTPMode::Get && !StreamResponse)
 	{
-		dlog_print(DLOG_DEBUG, LOG_TAG, "Prepare Header");
+		state.sharedKey = "GET ";
+		state.sharedKey += state.cacheKey.empty() ? GetRequestIdentity(state) : state.cacheKey;
+	}
 
-		// TODO make it an option so it can be configured
-		curl_easy_setopt(curlHandle, CURLOPT_SSL_VERIFYPEER, 0);
-		curl_easy_setopt(curlHandle, CURLOPT_SSL_VERIFYHOST, 0);
+	// TODO make it an option so it can be configured
+	curl_easy_setopt(curlHandle, CURLOPT_SSL_VERIFYPEER, 0);
+	curl_easy_setopt(curlHandle, CURLOPT_SSL_VERIFYHOST, 0);
 
-		// Construct header list
-		struct curl_slist* headerList = PrepareHeader();
-		curl_easy_setopt(curlHandle, CURLOPT_HTTPHEADER, headerList);
+	// Probe idle connections kept in the pool, so a dropped connection is not reused
+	curl_easy_setopt(curlHandle, CURLOPT_TCP_KEEPALIVE, 1L);
 
-		// Write function
-		std::vector<char> buffer;
+	Policy->ApplyTimeouts(curlHandle);
 
-		curl_easy_setopt(curlHandle, CURLOPT_WRITEDATA, (void* ) &buffer);
-		curl_easy_setopt(curlHandle, CURLOPT_WRITEFUNCTION, RESTServiceTemplateBase_WriteCallback);
+	// Empty string accepts every encoding which libcurl can decode
+	if(AcceptCompressedResponse)
+		curl_easy_setopt(curlHandle, CURLOPT_ACCEPT_ENCODING, "");
 
-		dlog_print(DLOG_DEBUG, LOG_TAG, "Prepare URL");
+#if LIBCURL_VERSION_NUM >= 0x072f00
+	// Multiplexed connection is only used by the thread of its multi handle
+	if(PreferHTTP2 && multiplexed)
+	{
+		curl_easy_setopt(curlHandle, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+
+		// Wait for the HTTP/2 connection in progress instead of opening another connection
+		if(FinalUrl.compare(0, 8, "https://") == 0)
+			curl_easy_setopt(curlHandle, CURLOPT_PIPEWAIT, 1L);
+	}
+#endif
 
-		// Construct query string
-		std::string url = PrepareUrl();
-		std::string query = PrepareQueryString();
+	// Write function
+	state.service = this;
+	state.handle = curlHandle;
+	curl_easy_setopt(curlHandle, CURLOPT_WRITEDATA, (void* ) &state);
+	curl_easy_setopt(curlHandle, CURLOPT_WRITEFUNCTION, RESTServiceTemplateBase_WriteCallback);
 
-		FinalUrl = url;
+	curl_easy_setopt(curlHandle, CURLOPT_URL, FinalUrl.c_str());
 
-		if(query.length())
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Prepare Post Data");
+
+	// Prepare post data, which is kept in the state as curl does not copy it
+	switch (httpMode)
+	{
+	case HTTPMode::Get:
+		break;
+	case HTTPMode::Post:
+		curl_easy_setopt(curlHandle, CURLOPT_POST, 1L);
+		goto HTTP_PreparePostData;
+	case HTTPMode::Put:
+		curl_easy_setopt(curlHandle, CURLOPT_CUSTOMREQUEST, "PUT");
+
+		HTTP_PreparePostData: state.postData = PreparePostData(postDataParam);
+		OnAfterPOSTDataReady(state.postData);
+
+		if(CompressRequestThreshold && state.postData.size() >= CompressRequestThreshold)
 		{
-			FinalUrl += "?";
-			FinalUrl += query;
+			std::string compressed;
+
+			// Data which does not shrink is sent as is
+			if(GzipCompress(compressed, state.postData.data(), state.postData.size())
+				&& compressed.size() < state.postData.size())
+			{
+				dlog_print(DLOG_DEBUG, LOG_TAG, "Post data compressed from %zu to %zu", state.postData.size(), compressed.size());
+				state.postData = std::move(compressed);
+				state.headerList = curl_slist_append(state.headerList, "Content-Encoding: gzip");
+			}
 		}
 
-		dlog_print(DLOG_DEBUG, LOG_TAG, "Final url: %s", FinalUrl.c_str());
+		curl_easy_setopt(curlHandle, CURLOPT_POSTFIELDSIZE, state.postData.size());
+		curl_easy_setopt(curlHandle, CURLOPT_POSTFIELDS, state.postData.c_str());
+		break;
+	case HTTPMode::Delete:
+		curl_easy_setopt(curlHandle, CURLOPT_CUSTOMREQUEST, "DELETE");
+		break;
+	case HTTPMode::Unknown:
+		break;
+	}
+
+	// Header list is complete after the post data is prepared
+	curl_easy_setopt(curlHandle, CURLOPT_HTTPHEADER, state.headerList);
+
+	// USer Agent
+	curl_easy_setopt(curlHandle, CURLOPT_USERAGENT, UserAgent.c_str());
+	return true;
+}
+
+std::string TFC::Net::RESTServiceTemplateBase::GetRequestIdentity(TransferState const& state)
+{
+	// Identity is only kept in memory, so it contains the full headers instead of their hash,
+	// which may collide between requests with different credentials
+	std::string identity = FinalUrl;
+	for(auto header = state.headerList; header != nullptr; header = header->next)
+	{
+		identity += '\n';
+		identity += header->data;
+	}
 
-		curl_easy_setopt(curlHandle, CURLOPT_URL, FinalUrl.c_str());
+	return identity;
+}
 
-		dlog_print(DLOG_DEBUG, LOG_TAG, "Prepare Post Data");
+void TFC::Net::RESTServiceTemplateBase::PrepareCache(TransferState& state)
+{
+	state.cacheKey = GetRequestIdentity(state);
+	state.cachedResponse = Cache->Lookup(state.cacheKey);
 
-		// Prepare post data
-		std::string postData;
-		switch (httpMode)
+	if(!state.cachedResponse)
+		return;
+
+	if(std::chrono::system_clock::now() < state.cachedResponse->expiresAt)
+	{
+		state.cacheHit = true;
+		Cache->hitCount++;
+		return;
+	}
+
+	// Stale response is validated to the server
+	if(!state.cachedResponse->eTag.empty())
+		state.headerList = curl_slist_append(state.headerList, ("If-None-Match: " + state.cachedResponse->eTag).c_str());
+
+	if(!state.cachedResponse->lastModified.empty())
+		state.headerList = curl_slist_append(state.headerList, ("If-Modified-Since: " + state.cachedResponse->lastModified).c_str());
+}
+
+std::string const& TFC::Net::RESTServiceTemplateBase::UpdateCache(int& httpCode, TransferState& state)
+{
+	auto now = std::chrono::system_clock::now();
+	auto expiresAt = now;
+	bool noStore = false, noCache = false, hasLifetime = false;
+
+	// Cache-Control directives are separated by comma, and max-age takes precedence over Expires
+	std::stringstream directives(state.cacheControl);
+	std::string directive;
+	while(std::getline(directives, directive, ','))
+	{
+		auto start = directive.find_first_not_of(' ');
+		if(start == std::string::npos)
+			continue;
+
+		directive = directive.substr(start);
+
+		if(strncasecmp(directive.c_str(), "no-store", 8) == 0)
+			noStore = true;
+		else if(strncasecmp(directive.c_str(), "no-cache", 8) == 0)
+			noCache = true;
+		else if(strncasecmp(directive.c_str(), "max-age=", 8) == 0)
 		{
-		case HTTPMode::Get:
-			break;
-		case HTTPMode::Post:
-			curl_easy_setopt(curlHandle, CURLOPT_POST, 1L);
-			goto HTTP_PreparePostData;
-		case HTTPMode::Put:
-			curl_easy_setopt(curlHandle, CURLOPT_CUSTOMREQUEST, "PUT");
-
-			HTTP_PreparePostData: postData = PreparePostData(postDataParam);
-			OnAfterPOSTDataReady(postData);
-			curl_easy_setopt(curlHandle, CURLOPT_POSTFIELDSIZE, postData.size());
-			curl_easy_setopt(curlHandle, CURLOPT_POSTFIELDS, postData.c_str());
-			break;
-		case HTTPMode::Delete:
-			curl_easy_setopt(curlHandle, CURLOPT_CUSTOMREQUEST, "DELETE");
-			break;
-		case HTTPMode::Unknown:
-			break;
+			expiresAt = now + std::chrono::seconds(std::strtol(directive.c_str() + 8, nullptr, 10));
+			hasLifetime = true;
 		}
+	}
+
+	if(!hasLifetime && !state.expires.empty())
+	{
+		auto expires = curl_getdate(state.expires.c_str(), nullptr);
+		if(expires != -1)
+			expiresAt = std::chrono::system_clock::from_time_t(expires);
+	}
+
+	// Response has to be validated on every use
+	if(noCache)
+		expiresAt = now;
+
+	if(httpCode == 304 && state.cachedResponse)
+	{
+		Cache->revalidationCount++;
+
+		state.cachedResponse = Cache->Refresh(state.cacheKey, *state.cachedResponse, expiresAt);
+
+		httpCode = state.cachedResponse->httpCode;
+		return state.cachedResponse->body;
+	}
+
+	Cache->missCount++;
+
+	// Response without validators can only be reused while it is fresh
+	bool reusable = !state.eTag.empty() || !state.lastModified.empty() || expiresAt > now;
+
+	if(httpCode != 200 || noStore || !reusable)
+		return state.buffer;
+
+	state.cachedResponse = Cache->Store(state.cacheKey,
+		{ httpCode, std::move(state.buffer), state.eTag, state.lastModified, expiresAt });
+	return state.cachedResponse->body;
+}
+
+RESTResultBase TFC::Net::RESTServiceTemplateBase::CompleteTransfer(CURLcode res, TransferState& state)
+{
+	int httpCode = 0;
+	auto& body = ResolveResponse(res, httpCode, state);
+	return ProcessResponse(res, httpCode, body, state.metrics);
+}
+
+std::string const& TFC::Net::RESTServiceTemplateBase::ResolveResponse(CURLcode& res, int& httpCode, TransferState& state)
+{
+	if(state.cacheHit)
+	{
+		res = CURLE_OK;
+		httpCode = state.cachedResponse->httpCode;
+		state.metrics.cached = true;
+		state.metrics.attempts = 0;
+		RecordStatistics(res, httpCode, state);
+		return state.cachedResponse->body;
+	}
+
+	RecordStatistics(res, state.responseCode, state);
 
-		// USer Agent
-		curl_easy_setopt(curlHandle, CURLOPT_USERAGENT, UserAgent.c_str());
+	if(res != CURLE_OK)
+		return state.buffer;
 
-		dlog_print(DLOG_DEBUG, LOG_TAG, "Before Sending");
+	httpCode = state.responseCode;
 
-		CURLcode res = curl_easy_perform(curlHandle);
-		dlog_print(DLOG_DEBUG, LOG_TAG, "After Sending");
+	if(!state.cacheKey.empty())
+		return UpdateCache(httpCode, state);
 
-		if (res != CURLE_OK)
+	// Buffered body is passed as is, and it is empty if the response is streamed
+	return state.buffer;
+}
+
+void TFC::Net::RESTServiceTemplateBase::RecordStatistics(CURLcode res, int httpCode, TransferState const& state)
+{
+	if(!Statistics)
+		return;
+
+	static char const* const methodNames[] = { "UNKNOWN", "GET", "POST", "PUT", "DELETE" };
+
+	std::string endpoint = methodNames[(int)httpMode];
+	endpoint += ' ';
+	endpoint += Url;
+
+	Statistics->Record(endpoint, res == CURLE_OK && httpCode < 400, state.metrics);
+}
+
+RESTResultBase TFC::Net::RESTServiceTemplateBase::ProcessResponse(CURLcode res, int httpCode, std::string const& body,
+	TransferMetrics const& metrics)
+{
+	RESTResultBase returnObj;
+	returnObj.metrics = metrics;
+
+	if (res != CURLE_OK)
+	{
+		auto err = curl_easy_strerror(res);
+		returnObj.resultType = ResultType::LocalError;
+		returnObj.errorMessage = err;
+		returnObj.responseObj = OnProcessErrorIntl(returnObj.httpCode, returnObj.errorCode, returnObj.errorMessage);
+	}
+	else
+	{
+		returnObj.httpCode = httpCode;
+
+		dlog_print(DLOG_DEBUG, LOG_TAG, "Response size: %zu", body.size());
+
+		returnObj.responseObj = OnProcessResponseIntl(returnObj.httpCode, body, returnObj.errorCode,
+			returnObj.errorMessage);
+
+		if(returnObj.errorCode)
+			returnObj.resultType = ResultType::ServerError;
+
+	}
+
+	this->working = false;
+	return returnObj;
+}
+
+namespace {
+
+/*
+ * Transfer performed by PerformCall, which is shared with the other threads calling the same request
+ * while it is in progress.
+ */
+struct SharedTransfer
+{
+	std::mutex lock;
+	std::condition_variable completedSignal;
+	bool completed;
+
+	CURLcode res;
+	int httpCode;
+	std::string body;
+	TransferMetrics metrics;
+
+	SharedTransfer() : completed(false), res(CURLE_OK), httpCode(0) { }
+};
+
+std::mutex sharedTransferLock;
+std::unordered_map<std::string, std::shared_ptr<SharedTransfer>> sharedTransfers;
+
+/*
+ * Registration of the transfer performed by this thread. If the transfer leaves by an exception,
+ * the registration is removed and the waiting threads complete with an error, so they are never
+ * left waiting and the next identical request performs its own transfer.
+ */
+class SharedTransferRegistration
+{
+public:
+	SharedTransferRegistration(std::string const& key, std::shared_ptr<SharedTransfer> transfer) :
+		key(key), transfer(std::move(transfer)), completed(false)
+	{
+	}
+
+	void Complete(CURLcode res, int httpCode, std::string const& body, TransferMetrics const& metrics)
+	{
 		{
-			auto err = curl_easy_strerror(res);
-			returnObj.resultType = ResultType::LocalError;
-			returnObj.errorMessage = err;
-			returnObj.responseObj = OnProcessErrorIntl(returnObj.httpCode, returnObj.errorCode, returnObj.errorMessage);
+			std::lock_guard<std::mutex> guard(sharedTransferLock);
+			sharedTransfers.erase(key);
 		}
-		else
+
 		{
-			std::string response(buffer.data(), buffer.size());
-			dlog_print(DLOG_DEBUG, LOG_TAG, "data: %s", response.c_str());
-			curl_easy_getinfo(curlHandle, CURLINFO_RESPONSE_CODE, &returnObj.httpCode);
+			std::lock_guard<std::mutex> guard(transfer->lock);
+			transfer->res = res;
+			transfer->httpCode = httpCode;
+			transfer->metrics = metrics;
+
+			// No other thread can join after the transfer is removed, so the body is copied only if waited
+			if(transfer.use_count() > 1)
+				transfer->body = body;
+
+			transfer->completed = true;
+		}
+
+		completed = true;
+		transfer->completedSignal.notify_all();
+	}
 
-			returnObj.responseObj = OnProcessResponseIntl(returnObj.httpCode, response, returnObj.errorCode,
-				returnObj.errorMessage);
+	~SharedTransferRegistration()
+	{
+		if(!completed)
+			Complete(CURLE_ABORTED_BY_CALLBACK, 0, std::string(), TransferMetrics());
+	}
+
+private:
+	std::string const& key;
+	std::shared_ptr<SharedTransfer> transfer;
+	bool completed;
+};
+
+}
 
-			if(returnObj.errorCode)
-				returnObj.resultType = ResultType::ServerError;
+RESTResultBase TFC::Net::RESTServiceTemplateBase::PerformSharedCall(CURL* curlHandle, TransferState& state)
+{
+	std::shared_ptr<SharedTransfer> transfer;
+	bool performer = false;
 
+	{
+		std::lock_guard<std::mutex> guard(sharedTransferLock);
+
+		auto& entry = sharedTransfers[state.sharedKey];
+		if(!entry)
+		{
+			entry = std::make_shared<SharedTransfer>();
+			performer = true;
 		}
+
+		transfer = entry;
 	}
-	else
+
+	if(!performer)
+	{
+		dlog_print(DLOG_DEBUG, LOG_TAG, "Waiting for identical request in progress");
+
+		CURLcode res;
+		int httpCode;
+		std::string body;
+		TransferMetrics metrics;
+
+		{
+			std::unique_lock<std::mutex> guard(transfer->lock);
+			transfer->completedSignal.wait(guard, [&transfer] { return transfer->completed; });
+
+			res = transfer->res;
+			httpCode = transfer->httpCode;
+			body = transfer->body;
+			metrics = transfer->metrics;
+		}
+
+		// Processed outside the lock, so the waiting threads process their response in parallel
+		return ProcessResponse(res, httpCode, body, metrics);
+	}
+
+	SharedTransferRegistration registration(state.sharedKey, transfer);
+	transfer.reset();
+
+	CURLcode res = PerformTransfer(curlHandle, state);
+
+	int httpCode = 0;
+	auto& body = ResolveResponse(res, httpCode, state);
+
+	registration.Complete(res, httpCode, body, state.metrics);
+	return ProcessResponse(res, httpCode, body, state.metrics);
+}
+
+RESTResultBase TFC::Net::RESTServiceTemplateBase::PerformCall()
+{
+	auto curlHandle = ConnectionPool::GetDefault().Acquire();
+
+	if (!curlHandle)
 	{
+		RESTResultBase returnObj;
 		returnObj.resultType = ResultType::LocalError;
 		returnObj.errorMessage = "Unknown error";
+		return returnObj;
 	}
 
-	this->working = false;
-	return returnObj;
+	TransferState state;
+	if(!PrepareTransfer(curlHandle, state, false))
+		return CompleteTransfer(CURLE_OK, state);
+
+	if(!state.sharedKey.empty())
+		return PerformSharedCall(curlHandle, state);
+
+	CURLcode res = PerformTransfer(curlHandle, state);
+	return CompleteTransfer(res, state);
+}
+
+CURLcode TFC::Net::RESTServiceTemplateBase::PerformTransfer(CURL* curlHandle, TransferState& state)
+{
+	for(;; state.attempt++)
+	{
+		dlog_print(DLOG_DEBUG, LOG_TAG, "Before Sending, attempt %d", state.attempt);
+
+		state.attemptStart = std::chrono::steady_clock::now();
+
+		CURLcode res;
+		std::chrono::milliseconds hedgeDelay;
+
+		if(ShouldHedge(hedgeDelay))
+		{
+			res = PerformHedgedTransfer(curlHandle, state, hedgeDelay);
+		}
+		else
+		{
+			res = curl_easy_perform(curlHandle);
+			state.ReadTransferInfo(curlHandle);
+		}
+
+		dlog_print(DLOG_DEBUG, LOG_TAG, "After Sending, result %d, HTTP code %ld", res, state.responseCode);
+
+		if(res == CURLE_OK)
+			Policy->RecordLatency(std::chrono::steady_clock::now() - state.attemptStart);
+
+		if(!ShouldRetry(res, state))
+			return res;
+
+		auto backoff = Policy->GetBackoff(state.attempt);
+		dlog_print(DLOG_WARN, LOG_TAG, "Retrying %s in %lld ms", FinalUrl.c_str(), (long long)backoff.count());
+
+		Policy->retryCount++;
+		state.ResetResponse();
+		std::this_thread::sleep_for(backoff);
+	}
+}
+
+CURLcode TFC::Net::RESTServiceTemplateBase::PerformHedgedTransfer(CURL* curlHandle, TransferState& state,
+	std::chrono::milliseconds delay)
+{
+	// Both requests are transferred by a multi handle owned by this call
+	CURLM* multi = curl_multi_init();
+	curl_multi_add_handle(multi, curlHandle);
+
+	auto hedgeTime = state.attemptStart + delay;
+	TransferState hedge;
+	CURL* hedgeHandle = nullptr;
+
+	CURLcode res = CURLE_OK;
+	int runningTransfers = 1;
+	bool completed = false;
+
+	while(!completed)
+	{
+		int running;
+		curl_multi_perform(multi, &running);
+
+		int pending;
+		CURLMsg* message;
+
+		while(!completed && (message = curl_multi_info_read(multi, &pending)) != nullptr)
+		{
+			if(message->msg != CURLMSG_DONE)
+				continue;
+
+			CURL* easy = message->easy_handle;
+			res = message->data.result;
+			runningTransfers--;
+
+			// Failed request waits for the other request, which may still succeed
+			if(res != CURLE_OK && runningTransfers > 0)
+				continue;
+
+			auto& completedState = easy == curlHandle ? state : hedge;
+			completedState.ReadTransferInfo(easy);
+
+			if(easy == hedgeHandle)
+			{
+				if(res == CURLE_OK)
+					Policy->hedgeWinCount++;
+
+				state.AdoptResponse(hedge);
+			}
+
+			completed = true;
+		}
+
+		if(completed)
+			break;
+
+		int timeout = 1000;
+
+		if(!hedgeHandle)
+		{
+			auto untilHedge = std::chrono::duration_cast<std::chrono::milliseconds>(hedgeTime - std::chrono::steady_clock::now());
+
+			if(untilHedge.count() <= 0)
+			{
+				dlog_print(DLOG_DEBUG, LOG_TAG, "Hedging %s", FinalUrl.c_str());
+
+				hedgeHandle = StartHedge(ConnectionPool::GetDefault(), curlHandle, state, hedge);
+				curl_multi_add_handle(multi, hedgeHandle);
+				runningTransfers++;
+				continue;
+			}
+
+			timeout = std::min<int>(timeout, untilHedge.count());
+		}
+
+		curl_multi_wait(multi, nullptr, 0, timeout, nullptr);
+	}
+
+	curl_multi_remove_handle(multi, curlHandle);
+
+	if(hedgeHandle)
+	{
+		curl_multi_remove_handle(multi, hedgeHandle);
+		curl_easy_cleanup(hedgeHandle);
+	}
+
+	curl_multi_cleanup(multi);
+	return res;
+}
+
+CURL* TFC::Net::RESTServiceTemplateBase::StartHedge(ConnectionPool& pool, CURL* curlHandle, TransferState& state, TransferState& hedge)
+{
+	// Duplicate keeps the options of the request, but not the share handle, so the hedge joins
+	// the caches of the pool explicitly
+	CURL* hedgeHandle = curl_easy_duphandle(curlHandle);
+	pool.Share(hedgeHandle);
+
+	hedge.service = this;
+	hedge.handle = hedgeHandle;
+	curl_easy_setopt(hedgeHandle, CURLOPT_WRITEDATA, (void* ) &hedge);
+
+	if(!state.cacheKey.empty())
+		curl_easy_setopt(hedgeHandle, CURLOPT_HEADERDATA, (void* ) &hedge);
+
+	Policy->hedgeCount++;
+	return hedgeHandle;
+}
+
+bool TFC::Net::RESTServiceTemplateBase::ShouldHedge(std::chrono::milliseconds& delay)
+{
+	// Streamed response would be delivered twice
+	return httpMode == HTTPMode::Get && !StreamResponse && Policy->GetHedgeDelay(delay);
+}
+
+bool TFC::Net::RESTServiceTemplateBase::ShouldRetry(CURLcode res, TransferState const& state)
+{
+	if(state.attempt > Policy->MaxRetries || state.responseStarted)
+		return false;
+
+	// POST is not idempotent, so it may be applied twice if it is retried
+	if(httpMode != HTTPMode::Get && httpMode != HTTPMode::Put && httpMode != HTTPMode::Delete)
+		return false;
+
+	return Policy->IsRetryable(res, state.responseCode);
 }
 
 std::string* TFC::Net::SimpleRESTServiceBase::OnProcessResponse(int httpCode, const std::string& responseStr, int& errorCode, std::string& errorMessage)
@@ -451,6 +1124,25 @@ RESTResultBase TFC::Net::RESTServiceTemplateBase::CallInternal()
 	return PerformCall();
 }
 
+void TFC::Net::RESTServiceTemplateBase::CallAsyncInternal(std::function<void(RESTResultBase&&)> onComplete)
+{
+	RESTEngine::GetDefault().Submit(*this, std::move(onComplete));
+}
+
+TFC::Net::TransferMetrics::TransferMetrics() :
+	nameLookupTime(0),
+	connectTime(0),
+	appConnectTime(0),
+	startTransferTime(0),
+	totalTime(0),
+	bytesUploaded(0),
+	bytesDownloaded(0),
+	attempts(0),
+	connectionReused(false),
+	cached(false)
+{
+}
+
 TFC::Net::RESTResultBase::RESTResultBase() :
 	resultType(ResultType::OK),
 	responseObj(nullptr),
@@ -0,0 +1,462 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Net/RESTEngine.cpp
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#include "TFC/Net/RESTEngine.h"
+#include "TFC/Net/RequestPolicy.h"
+
+#include <dlog.h>
+
+using namespace TFC::Net;
+
+struct TFC::Net::RESTEngine::Waiter
+{
+	RESTServiceTemplateBase& service;
+	CompletionHandler onComplete;
+};
+
+struct TFC::Net::RESTEngine::Completion
+{
+	CompletionHandler onComplete;
+	RESTResultBase result;
+};
+
+struct TFC::Net::RESTEngine::Transfer
+{
+	RESTEngine& engine;
+	RESTServiceTemplateBase& service;
+	ConnectionPool::Handle handle;
+	RESTServiceTemplateBase::TransferState state;
+	CompletionHandler onComplete;
+
+	// Identical requests submitted while this transfer is in progress
+	std::vector<Waiter> waiters;
+
+	// Duplicate request sent when the response is late, which owns its handle
+	std::unique_ptr<RESTServiceTemplateBase::TransferState> hedge;
+
+	// Timer which either sends the duplicate request, or retries the request after the backoff
+	Ecore_Timer* timer;
+	bool retryPending;
+	int runningHandles;
+
+	Transfer(RESTEngine& engine, RESTServiceTemplateBase& service, ConnectionPool::Handle handle,
+		CompletionHandler onComplete) :
+		engine(engine), service(service), handle(std::move(handle)), onComplete(std::move(onComplete)),
+		timer(nullptr), retryPending(false), runningHandles(0)
+	{
+	}
+
+	~Transfer()
+	{
+		if(timer)
+			ecore_timer_del(timer);
+
+		if(hedge)
+			curl_easy_cleanup(hedge->handle);
+	}
+};
+
+namespace TFC {
+namespace Net {
+
+int RESTEngine_SocketCallback(CURL* easy, curl_socket_t socket, int what, void* userp, void* socketp)
+{
+	static_cast<RESTEngine*>(userp)->WatchSocket(socket, what, static_cast<Ecore_Fd_Handler*>(socketp));
+	return 0;
+}
+
+int RESTEngine_TimerCallback(CURLM* multi, long timeoutMs, void* userp)
+{
+	static_cast<RESTEngine*>(userp)->ScheduleTimeout(timeoutMs);
+	return 0;
+}
+
+Eina_Bool RESTEngine_FdHandlerCallback(void* data, Ecore_Fd_Handler* handler)
+{
+	static_cast<RESTEngine*>(data)->OnSocketReady(handler);
+	return ECORE_CALLBACK_RENEW;
+}
+
+Eina_Bool RESTEngine_TimeoutCallback(void* data)
+{
+	static_cast<RESTEngine*>(data)->OnTimeout();
+	return ECORE_CALLBACK_CANCEL;
+}
+
+void RESTEngine_CompletionJob(void* data)
+{
+	std::unique_ptr<RESTEngine::Completion> completion(static_cast<RESTEngine::Completion*>(data));
+	completion->onComplete(std::move(completion->result));
+}
+
+Eina_Bool RESTEngine_TransferTimerCallback(void* data)
+{
+	auto transfer = static_cast<RESTEngine::Transfer*>(data);
+	transfer->engine.OnTransferTimer(*transfer);
+	return ECORE_CALLBACK_CANCEL;
+}
+
+}
+}
+
+LIBAPI TFC::Net::RESTEngine::RESTEngine(ConnectionPool& pool) :
+	pool(pool),
+	multi(curl_multi_init()),
+	timer(nullptr)
+{
+	curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, RESTEngine_SocketCallback);
+	curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this);
+	curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, RESTEngine_TimerCallback);
+	curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this);
+
+#if LIBCURL_VERSION_NUM >= 0x072b00
+	// Transfers to the same HTTP/2 server share one connection
+	curl_multi_setopt(multi, CURLMOPT_PIPELINING, (long)CURLPIPE_MULTIPLEX);
+#endif
+}
+
+LIBAPI TFC::Net::RESTEngine::~RESTEngine()
+{
+	for(auto& transfer : transfers)
+	{
+		curl_multi_remove_handle(multi, transfer.first);
+		transfer.second->service.working = false;
+
+		if(transfer.second->hedge)
+			curl_multi_remove_handle(multi, transfer.second->hedge->handle);
+
+		for(auto& waiter : transfer.second->waiters)
+			waiter.service.working = false;
+	}
+
+	transfers.clear();
+	sharedTransfers.clear();
+	hedges.clear();
+	curl_multi_cleanup(multi);
+
+	if(timer)
+		ecore_timer_del(timer);
+}
+
+LIBAPI RESTEngine& TFC::Net::RESTEngine::GetDefault()
+{
+	// Never destroyed, as the main loop is already shut down when the static objects are destroyed.
+	// The engine has its own pool, so its HTTP/2 connections are not shared with the threads which
+	// perform requests with Call()
+	static RESTEngine* defaultEngine = new RESTEngine(*new ConnectionPool());
+	return *defaultEngine;
+}
+
+LIBAPI void TFC::Net::RESTEngine::Submit(RESTServiceTemplateBase& service, CompletionHandler onComplete)
+{
+	std::unique_ptr<Transfer> transfer(new Transfer(*this, service, pool.Acquire(), std::move(onComplete)));
+
+	CURL* easy = transfer->handle;
+
+	if(!easy)
+	{
+		RESTResultBase result;
+		result.resultType = ResultType::LocalError;
+		result.errorMessage = "Unknown error";
+		CompleteLater(std::move(transfer->onComplete), std::move(result));
+		return;
+	}
+
+	if(!service.PrepareTransfer(easy, transfer->state, true))
+	{
+		// Response is served from the cache
+		auto result = service.CompleteTransfer(CURLE_OK, transfer->state);
+		auto onComplete = std::move(transfer->onComplete);
+		transfer.reset();
+		CompleteLater(std::move(onComplete), std::move(result));
+		return;
+	}
+
+	auto& sharedKey = transfer->state.sharedKey;
+	if(!sharedKey.empty())
+	{
+		auto shared = sharedTransfers.find(sharedKey);
+		if(shared != sharedTransfers.end())
+		{
+			// Handle of this transfer is returned to the pool, as it is not used
+			dlog_print(DLOG_DEBUG, LOG_TAG, "Waiting for identical request in progress");
+			shared->second->waiters.push_back({ service, std::move(transfer->onComplete) });
+			return;
+		}
+
+		sharedTransfers.emplace(sharedKey, transfer.get());
+	}
+
+	auto& started = *transfer;
+	transfers.emplace(easy, std::move(transfer));
+	StartAttempt(started);
+}
+
+void TFC::Net::RESTEngine::CompleteLater(CompletionHandler onComplete, RESTResultBase&& result)
+{
+	// Completion function is never called before Submit returns, like the completion of a transfer
+	ecore_job_add(RESTEngine_CompletionJob, new Completion { std::move(onComplete), std::move(result) });
+}
+
+void TFC::Net::RESTEngine::StartAttempt(Transfer& transfer)
+{
+	transfer.state.attemptStart = std::chrono::steady_clock::now();
+	transfer.runningHandles = 1;
+
+	// Adding the handle schedules an immediate timeout, which starts the transfer on the main loop
+	curl_multi_add_handle(multi, transfer.handle);
+
+	std::chrono::milliseconds hedgeDelay;
+	if(transfer.service.ShouldHedge(hedgeDelay))
+		transfer.timer = ecore_timer_add(hedgeDelay.count() / 1000.0, RESTEngine_TransferTimerCallback, &transfer);
+}
+
+void TFC::Net::RESTEngine::OnTransferTimer(Transfer& transfer)
+{
+	// The expired timer is deleted by returning from its callback
+	transfer.timer = nullptr;
+
+	if(transfer.retryPending)
+	{
+		transfer.retryPending = false;
+		StartAttempt(transfer);
+		return;
+	}
+
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Hedging %s", transfer.service.FinalUrl.c_str());
+
+	transfer.hedge.reset(new RESTServiceTemplateBase::TransferState());
+	CURL* hedgeHandle = transfer.service.StartHedge(pool, transfer.handle, transfer.state, *transfer.hedge);
+
+	hedges.emplace(hedgeHandle, &transfer);
+	transfer.runningHandles++;
+	curl_multi_add_handle(multi, hedgeHandle);
+}
+
+void TFC::Net::RESTEngine::DiscardHedge(Transfer& transfer)
+{
+	if(!transfer.hedge)
+		return;
+
+	// Removing a handle which is already removed does nothing
+	curl_multi_remove_handle(multi, transfer.hedge->handle);
+	hedges.erase(transfer.hedge->handle);
+
+	curl_easy_cleanup(transfer.hedge->handle);
+	transfer.hedge.reset();
+}
+
+void TFC::Net::RESTEngine::WatchSocket(curl_socket_t socket, int what, Ecore_Fd_Handler* handler)
+{
+	if(what == CURL_POLL_REMOVE)
+	{
+		if(handler)
+			ecore_main_fd_handler_del(handler);
+		return;
+	}
+
+	int flags = ECORE_FD_ERROR;
+
+	if(what & CURL_POLL_IN)
+		flags |= ECORE_FD_READ;
+
+	if(what & CURL_POLL_OUT)
+		flags |= ECORE_FD_WRITE;
+
+	if(handler)
+	{
+		ecore_main_fd_handler_active_set(handler, static_cast<Ecore_Fd_Handler_Flags>(flags));
+	}
+	else
+	{
+		handler = ecore_main_fd_handler_add(socket, static_cast<Ecore_Fd_Handler_Flags>(flags),
+			RESTEngine_FdHandlerCallback, this, nullptr, nullptr);
+		curl_multi_assign(multi, socket, handler);
+	}
+}
+
+void TFC::Net::RESTEngine::ScheduleTimeout(long timeoutMs)
+{
+	if(timer)
+	{
+		ecore_timer_del(timer);
+		timer = nullptr;
+	}
+
+	// Negative timeout means there is no timeout to wait for
+	if(timeoutMs >= 0)
+		timer = ecore_timer_add(timeoutMs / 1000.0, RESTEngine_TimeoutCallback, this);
+}
+
+void TFC::Net::RESTEngine::OnSocketReady(Ecore_Fd_Handler* handler)
+{
+	int action = 0;
+
+	if(ecore_main_fd_handler_active_get(handler, ECORE_FD_READ))
+		action |= CURL_CSELECT_IN;
+
+	if(ecore_main_fd_handler_active_get(handler, ECORE_FD_WRITE))
+		action |= CURL_CSELECT_OUT;
+
+	if(ecore_main_fd_handler_active_get(handler, ECORE_FD_ERROR))
+		action |= CURL_CSELECT_ERR;
+
+	int running;
+	curl_multi_socket_action(multi, ecore_main_fd_handler_fd_get(handler), action, &running);
+	ProcessCompletedTransfers();
+}
+
+void TFC::Net::RESTEngine::OnTimeout()
+{
+	// The expired timer is deleted by returning from its callback, and curl may schedule another one
+	timer = nullptr;
+
+	int running;
+	curl_multi_socket_action(multi, CURL_SOCKET_TIMEOUT, 0, &running);
+	ProcessCompletedTransfers();
+}
+
+void TFC::Net::RESTEngine::ProcessCompletedTransfers()
+{
+	int pending;
+	CURLMsg* message;
+
+	while((message = curl_multi_info_read(multi, &pending)) != nullptr)
+	{
+		if(message->msg != CURLMSG_DONE)
+			continue;
+
+		// Message is invalid after the handle is removed
+		CURL* easy = message->easy_handle;
+		CURLcode res = message->data.result;
+
+		curl_multi_remove_handle(multi, easy);
+
+		Transfer* completed;
+		bool isHedge = false;
+
+		auto iter = transfers.find(easy);
+		if(iter != transfers.end())
+		{
+			completed = iter->second.get();
+		}
+		else
+		{
+			auto hedge = hedges.find(easy);
+			if(hedge == hedges.end())
+				continue;
+
+			completed = hedge->second;
+			isHedge = true;
+		}
+
+		// Failed request waits for the other request, which may still succeed
+		if(--completed->runningHandles > 0 && res != CURLE_OK)
+			continue;
+
+		auto& state = completed->state;
+		auto& service = completed->service;
+		auto& policy = *service.Policy;
+
+		if(isHedge)
+		{
+			completed->hedge->ReadTransferInfo(easy);
+			state.AdoptResponse(*completed->hedge);
+
+			if(res == CURLE_OK)
+				policy.hedgeWinCount++;
+		}
+		else
+		{
+			state.ReadTransferInfo(easy);
+		}
+
+		// The other request is aborted
+		curl_multi_remove_handle(multi, completed->handle);
+		DiscardHedge(*completed);
+
+		if(completed->timer)
+		{
+			ecore_timer_del(completed->timer);
+			completed->timer = nullptr;
+		}
+
+		if(res == CURLE_OK)
+			policy.RecordLatency(std::chrono::steady_clock::now() - state.attemptStart);
+
+		if(service.ShouldRetry(res, state))
+		{
+			auto backoff = policy.GetBackoff(state.attempt);
+			dlog_print(DLOG_WARN, LOG_TAG, "Retrying %s in %lld ms", service.FinalUrl.c_str(), (long long)backoff.count());
+
+			policy.retryCount++;
+			state.ResetResponse();
+			state.attempt++;
+
+			completed->retryPending = true;
+			completed->timer = ecore_timer_add(backoff.count() / 1000.0, RESTEngine_TransferTimerCallback, completed);
+			continue;
+		}
+
+		auto owner = transfers.find(completed->handle.Get());
+		std::unique_ptr<Transfer> transfer = std::move(owner->second);
+		transfers.erase(owner);
+
+		if(!transfer->state.sharedKey.empty())
+			sharedTransfers.erase(transfer->state.sharedKey);
+
+		int httpCode = 0;
+		auto& body = transfer->service.ResolveResponse(res, httpCode, transfer->state);
+
+		// Exception must not leave the callback of the main loop, as the other waiters would never
+		// complete, so it becomes the error of the service which throws it
+		auto process = [&] (RESTServiceTemplateBase& target) {
+			try
+			{
+				return target.ProcessResponse(res, httpCode, body, transfer->state.metrics);
+			}
+			catch(std::exception const& ex)
+			{
+				dlog_print(DLOG_ERROR, LOG_TAG, "Processing response of %s failed: %s", target.FinalUrl.c_str(), ex.what());
+
+				RESTResultBase result;
+				result.resultType = ResultType::LocalError;
+				result.errorMessage = ex.what();
+				return result;
+			}
+		};
+
+		// Every waiter processes the shared body into its own response object
+		std::vector<std::pair<RESTResultBase, CompletionHandler>> completions;
+		completions.emplace_back(process(transfer->service), std::move(transfer->onComplete));
+
+		for(auto& waiter : transfer->waiters)
+			completions.emplace_back(process(waiter.service), std::move(waiter.onComplete));
+
+		// Return the handle to the pool first, so the completion can reuse it for another request
+		transfer.reset();
+
+		dlog_print(DLOG_DEBUG, LOG_TAG, "REST transfer completed, %d transfers left", (int)transfers.size());
+
+		for(auto& completion : completions)
+			completion.second(std::move(completion.first));
+	}
+}
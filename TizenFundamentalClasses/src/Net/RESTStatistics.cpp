@@ -0,0 +1,199 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Net/RESTStatistics.cpp
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#include "TFC/Net/RESTStatistics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <dlog.h>
+
+using namespace TFC::Net;
+
+namespace {
+
+RESTStatistics::Percentiles GetPercentiles(std::vector<int64_t>& samples)
+{
+	RESTStatistics::Percentiles percentiles;
+	percentiles.p50 = std::chrono::microseconds(GetPercentile(samples, 0.5));
+	percentiles.p90 = std::chrono::microseconds(GetPercentile(samples, 0.9));
+	percentiles.p99 = std::chrono::microseconds(GetPercentile(samples, 0.99));
+	percentiles.max = std::chrono::microseconds(GetPercentile(samples, 1));
+	return percentiles;
+}
+
+void AppendPercentiles(std::string& output, char const* name, RESTStatistics::Percentiles const& percentiles)
+{
+	char line[128];
+	snprintf(line, sizeof(line), "; %s p50 %.2f p90 %.2f p99 %.2f max %.2f ms", name,
+		percentiles.p50.count() / 1000.0, percentiles.p90.count() / 1000.0,
+		percentiles.p99.count() / 1000.0, percentiles.max.count() / 1000.0);
+	output += line;
+}
+
+}
+
+LIBAPI TFC::Net::RESTStatistics::RESTStatistics(size_t windowSize) :
+	windowSize(std::max<size_t>(1, windowSize))
+{
+}
+
+LIBAPI RESTStatistics& TFC::Net::RESTStatistics::GetDefault()
+{
+	static RESTStatistics defaultStatistics;
+	return defaultStatistics;
+}
+
+LIBAPI void TFC::Net::RESTStatistics::Record(std::string const& endpoint, bool success, TransferMetrics const& metrics)
+{
+	std::lock_guard<std::mutex> guard(statisticsLock);
+
+	auto& state = endpoints.emplace(endpoint, EndpointState(windowSize)).first->second;
+
+	state.requests++;
+
+	if(!success)
+		state.failures++;
+
+	// Cached response has no transfer to measure
+	if(metrics.cached)
+	{
+		state.cached++;
+		return;
+	}
+
+	if(metrics.connectionReused)
+		state.reusedConnections++;
+
+	state.bytesUploaded += metrics.bytesUploaded;
+	state.bytesDownloaded += metrics.bytesDownloaded;
+
+	Sample sample { metrics.nameLookupTime.count(), metrics.connectTime.count(), metrics.appConnectTime.count(),
+		metrics.startTransferTime.count(), metrics.totalTime.count() };
+
+	state.samples.Add(sample);
+}
+
+LIBAPI RESTStatistics::Endpoint TFC::Net::RESTStatistics::GetStatistics(std::string const& endpoint) const
+{
+	EndpointState state(windowSize);
+
+	{
+		std::lock_guard<std::mutex> guard(statisticsLock);
+
+		auto iter = endpoints.find(endpoint);
+		if(iter != endpoints.end())
+			state = iter->second;
+	}
+
+	return Summarize(state);
+}
+
+LIBAPI std::map<std::string, RESTStatistics::Endpoint> TFC::Net::RESTStatistics::GetStatistics() const
+{
+	std::map<std::string, EndpointState> snapshot;
+
+	{
+		std::lock_guard<std::mutex> guard(statisticsLock);
+		snapshot = endpoints;
+	}
+
+	// Percentiles are computed outside the lock, so recording is not blocked by sorting
+	std::map<std::string, Endpoint> statistics;
+	for(auto& endpoint : snapshot)
+		statistics.emplace(endpoint.first, Summarize(endpoint.second));
+
+	return statistics;
+}
+
+LIBAPI std::string TFC::Net::RESTStatistics::Dump() const
+{
+	std::string output;
+
+	for(auto& endpoint : GetStatistics())
+	{
+		auto& statistics = endpoint.second;
+
+		char counters[192];
+		snprintf(counters, sizeof(counters), ": %llu requests, %llu failed, %llu cached, %llu reused, %llu bytes up, %llu bytes down",
+			(unsigned long long)statistics.requests, (unsigned long long)statistics.failures,
+			(unsigned long long)statistics.cached, (unsigned long long)statistics.reusedConnections,
+			(unsigned long long)statistics.bytesUploaded, (unsigned long long)statistics.bytesDownloaded);
+
+		output += endpoint.first;
+		output += counters;
+		AppendPercentiles(output, "total", statistics.totalTime);
+		AppendPercentiles(output, "first byte", statistics.startTransferTime);
+		AppendPercentiles(output, "lookup", statistics.nameLookupTime);
+		AppendPercentiles(output, "connect", statistics.connectTime);
+		AppendPercentiles(output, "TLS", statistics.appConnectTime);
+		output += '\n';
+	}
+
+	return output;
+}
+
+LIBAPI void TFC::Net::RESTStatistics::DumpToLog() const
+{
+	auto dump = Dump();
+
+	// Each endpoint is logged separately, as the log truncates long messages
+	size_t start = 0, end;
+	while((end = dump.find('\n', start)) != std::string::npos)
+	{
+		dlog_print(DLOG_INFO, LOG_TAG, "%.*s", (int)(end - start), dump.c_str() + start);
+		start = end + 1;
+	}
+}
+
+LIBAPI void TFC::Net::RESTStatistics::Reset()
+{
+	std::lock_guard<std::mutex> guard(statisticsLock);
+	endpoints.clear();
+}
+
+RESTStatistics::Endpoint TFC::Net::RESTStatistics::Summarize(EndpointState const& state) const
+{
+	Endpoint statistics;
+	statistics.requests = state.requests;
+	statistics.failures = state.failures;
+	statistics.cached = state.cached;
+	statistics.reusedConnections = state.reusedConnections;
+	statistics.bytesUploaded = state.bytesUploaded;
+	statistics.bytesDownloaded = state.bytesDownloaded;
+
+	std::vector<int64_t> samples;
+	samples.reserve(state.samples.GetSize());
+
+	auto summarize = [&samples, &state] (int64_t Sample::* field) {
+		samples.clear();
+		for(auto& sample : state.samples.GetSamples())
+			samples.push_back(sample.*field);
+
+		return GetPercentiles(samples);
+	};
+
+	statistics.nameLookupTime = summarize(&Sample::nameLookupTime);
+	statistics.connectTime = summarize(&Sample::connectTime);
+	statistics.appConnectTime = summarize(&Sample::appConnectTime);
+	statistics.startTransferTime = summarize(&Sample::startTransferTime);
+	statistics.totalTime = summarize(&Sample::totalTime);
+	return statistics;
+}
@@ -0,0 +1,162 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Net/RequestPolicy.cpp
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#include "TFC/Net/RequestPolicy.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace TFC::Net;
+
+namespace {
+
+// Number of recent transfers whose latency is kept
+size_t const latencyWindow = 256;
+
+}
+
+LIBAPI TFC::Net::RequestPolicy::RequestPolicy() :
+	ConnectTimeout(std::chrono::seconds(30)),
+	TotalTimeout(0),
+	StallTimeout(std::chrono::seconds(60)),
+	MaxRetries(0),
+	BaseBackoff(200),
+	MaxBackoff(std::chrono::seconds(5)),
+	HedgePercentile(0),
+	MinHedgeDelay(50),
+	MinHedgeSamples(20),
+	latencySamples(latencyWindow),
+	transferCount(0),
+	retryCount(0),
+	hedgeCount(0),
+	hedgeWinCount(0)
+{
+}
+
+LIBAPI TFC::Net::RequestPolicy::~RequestPolicy()
+{
+}
+
+LIBAPI RequestPolicy& TFC::Net::RequestPolicy::GetDefault()
+{
+	static RequestPolicy defaultPolicy;
+	return defaultPolicy;
+}
+
+LIBAPI RequestPolicy::Statistics TFC::Net::RequestPolicy::GetStatistics() const
+{
+	Statistics statistics {};
+	statistics.transfers = transferCount.load();
+	statistics.retries = retryCount.load();
+	statistics.hedges = hedgeCount.load();
+	statistics.hedgeWins = hedgeWinCount.load();
+
+	std::vector<int64_t> samples;
+	{
+		std::lock_guard<std::mutex> guard(latencyLock);
+		samples = latencySamples.GetSamples();
+	}
+
+	statistics.p50 = std::chrono::microseconds(GetPercentile(samples, 0.5));
+	statistics.p90 = std::chrono::microseconds(GetPercentile(samples, 0.9));
+	statistics.p99 = std::chrono::microseconds(GetPercentile(samples, 0.99));
+	statistics.max = std::chrono::microseconds(GetPercentile(samples, 1));
+	return statistics;
+}
+
+LIBAPI bool TFC::Net::RequestPolicy::IsRetryable(CURLcode res, long httpCode) const
+{
+	switch(res)
+	{
+	case CURLE_OK:
+		return httpCode == 502 || httpCode == 503 || httpCode == 504;
+	case CURLE_COULDNT_RESOLVE_HOST:
+	case CURLE_COULDNT_CONNECT:
+	case CURLE_PARTIAL_FILE:
+	case CURLE_OPERATION_TIMEDOUT:
+	case CURLE_GOT_NOTHING:
+	case CURLE_SEND_ERROR:
+	case CURLE_RECV_ERROR:
+		return true;
+	default:
+		return false;
+	}
+}
+
+LIBAPI std::chrono::milliseconds TFC::Net::RequestPolicy::GetBackoff(int attempt) const
+{
+	thread_local std::minstd_rand random(std::random_device{}());
+
+	auto backoff = BaseBackoff;
+	for(int i = 1; i < attempt && backoff < MaxBackoff; i++)
+		backoff *= 2;
+
+	backoff = std::min(backoff, MaxBackoff);
+
+	// Full jitter spreads the retries of the clients which fail at the same time
+	std::uniform_int_distribution<int64_t> jitter(0, backoff.count());
+	return std::chrono::milliseconds(jitter(random));
+}
+
+LIBAPI bool TFC::Net::RequestPolicy::GetHedgeDelay(std::chrono::milliseconds& delay) const
+{
+	if(HedgePercentile <= 0)
+		return false;
+
+	std::vector<int64_t> samples;
+	{
+		std::lock_guard<std::mutex> guard(latencyLock);
+		if(latencySamples.GetSize() < MinHedgeSamples)
+			return false;
+
+		samples = latencySamples.GetSamples();
+	}
+
+	auto percentile = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::microseconds(GetPercentile(samples, HedgePercentile)));
+	delay = std::max(percentile, MinHedgeDelay);
+	return true;
+}
+
+LIBAPI void TFC::Net::RequestPolicy::ApplyTimeouts(CURL* curlHandle) const
+{
+	// Timeouts cannot use signals, as the transfers run on multiple threads
+	curl_easy_setopt(curlHandle, CURLOPT_NOSIGNAL, 1L);
+	curl_easy_setopt(curlHandle, CURLOPT_CONNECTTIMEOUT_MS, (long)ConnectTimeout.count());
+	curl_easy_setopt(curlHandle, CURLOPT_TIMEOUT_MS, (long)TotalTimeout.count());
+
+	if(StallTimeout.count() > 0)
+	{
+		// Stall is detected as less than 1 byte per second, checked every second
+		curl_easy_setopt(curlHandle, CURLOPT_LOW_SPEED_LIMIT, 1L);
+		curl_easy_setopt(curlHandle, CURLOPT_LOW_SPEED_TIME,
+			std::max(1L, (long)std::chrono::duration_cast<std::chrono::seconds>(StallTimeout).count()));
+	}
+}
+
+LIBAPI void TFC::Net::RequestPolicy::RecordLatency(std::chrono::steady_clock::duration latency)
+{
+	auto sample = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+
+	transferCount++;
+
+	std::lock_guard<std::mutex> guard(latencyLock);
+	latencySamples.Add(sample);
+}
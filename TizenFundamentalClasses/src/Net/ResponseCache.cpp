@@ -0,0 +1,406 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Net/ResponseCache.cpp
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#include "TFC/Net/ResponseCache.h"
+
+#include <app.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <functional>
+#include <ostream>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <dlog.h>
+
+using namespace TFC::Net;
+
+namespace {
+
+struct StoredFile
+{
+	std::string path;
+	size_t size;
+	struct timespec writeTime;
+};
+
+std::vector<StoredFile> GetStoredFiles(std::string const& storagePath)
+{
+	std::vector<StoredFile> files;
+	std::unique_ptr<DIR, int(*)(DIR*)> dir(opendir(storagePath.c_str()), closedir);
+
+	if(!dir)
+		return files;
+
+	static char const extension[] = ".cache";
+	size_t const extensionLength = sizeof(extension) - 1;
+
+	while(auto entry = readdir(dir.get()))
+	{
+		size_t length = strlen(entry->d_name);
+		if(length <= extensionLength || strcmp(entry->d_name + length - extensionLength, extension) != 0)
+			continue;
+
+		std::string path = storagePath + entry->d_name;
+		struct stat st = {};
+
+		if(stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+			files.push_back({ std::move(path), (size_t)st.st_size, st.st_mtim });
+	}
+
+	return files;
+}
+
+}
+
+LIBAPI TFC::Net::ResponseCache::ResponseCache(size_t maxEntries, std::string const& storagePath,
+	size_t maxStorageSize) :
+	maxEntries(maxEntries),
+	storagePath(storagePath),
+	maxStorageSize(maxStorageSize),
+	hitCount(0),
+	revalidationCount(0),
+	missCount(0)
+{
+	if(this->storagePath.empty())
+		return;
+
+	if(this->storagePath.back() != '/')
+		this->storagePath += '/';
+
+	struct stat st = {};
+
+	if(stat(this->storagePath.c_str(), &st) == -1 && mkdir(this->storagePath.c_str(), 0755) == -1)
+	{
+		// Cache still works in memory
+		dlog_print(DLOG_ERROR, LOG_TAG, "Cannot create response cache directory %s", this->storagePath.c_str());
+		this->storagePath.clear();
+	}
+}
+
+LIBAPI ResponseCache& TFC::Net::ResponseCache::GetDefault()
+{
+	static ResponseCache defaultCache(64, [] {
+		auto path = app_get_data_path();
+		std::string storagePath(path ? path : "");
+		free(path);
+		return storagePath.empty() ? storagePath : storagePath + "RESTCache/";
+	}());
+
+	return defaultCache;
+}
+
+LIBAPI std::shared_ptr<CachedResponse const> TFC::Net::ResponseCache::Lookup(std::string const& key)
+{
+	{
+		std::lock_guard<std::mutex> guard(cacheLock);
+
+		auto iter = entries.find(key);
+		if(iter != entries.end())
+		{
+			recentList.splice(recentList.begin(), recentList, iter->second.position);
+			return iter->second.response;
+		}
+	}
+
+	if(storagePath.empty())
+		return nullptr;
+
+	// Response evicted from memory or stored by the previous run of the application
+	auto response = ReadFile(key);
+
+	if(response)
+	{
+		std::lock_guard<std::mutex> guard(cacheLock);
+		Insert(key, response);
+	}
+
+	return response;
+}
+
+LIBAPI std::shared_ptr<CachedResponse const> TFC::Net::ResponseCache::Store(std::string const& key, CachedResponse response)
+{
+	auto stored = std::make_shared<CachedResponse const>(std::move(response));
+
+	{
+		std::lock_guard<std::mutex> guard(cacheLock);
+		Insert(key, stored);
+	}
+
+	if(!storagePath.empty())
+	{
+		WriteFile(key, *stored);
+		TrimStorage(GetFilePath(key));
+	}
+
+	return stored;
+}
+
+LIBAPI void TFC::Net::ResponseCache::Remove(std::string const& key)
+{
+	{
+		std::lock_guard<std::mutex> guard(cacheLock);
+
+		auto iter = entries.find(key);
+		if(iter != entries.end())
+		{
+			recentList.erase(iter->second.position);
+			entries.erase(iter);
+		}
+	}
+
+	if(!storagePath.empty())
+		unlink(GetFilePath(key).c_str());
+}
+
+LIBAPI void TFC::Net::ResponseCache::Clear()
+{
+	{
+		std::lock_guard<std::mutex> guard(cacheLock);
+		entries.clear();
+		recentList.clear();
+	}
+
+	if(!storagePath.empty())
+	{
+		for(auto& file : GetStoredFiles(storagePath))
+			unlink(file.path.c_str());
+	}
+}
+
+LIBAPI ResponseCache::Statistics TFC::Net::ResponseCache::GetStatistics() const
+{
+	return { hitCount.load(), revalidationCount.load(), missCount.load() };
+}
+
+void TFC::Net::ResponseCache::Insert(std::string const& key, std::shared_ptr<CachedResponse const> response)
+{
+	auto iter = entries.find(key);
+	if(iter != entries.end())
+	{
+		iter->second.response = std::move(response);
+		recentList.splice(recentList.begin(), recentList, iter->second.position);
+		return;
+	}
+
+	// Evicted responses stay in the storage
+	while(!recentList.empty() && entries.size() >= maxEntries)
+	{
+		entries.erase(recentList.back());
+		recentList.pop_back();
+	}
+
+	recentList.push_front(key);
+	entries.emplace(key, Entry { std::move(response), recentList.begin() });
+}
+
+std::shared_ptr<CachedResponse const> TFC::Net::ResponseCache::Refresh(std::string const& key,
+	CachedResponse const& response, std::chrono::system_clock::time_point expiresAt)
+{
+	// Response in memory can be used by other requests, so the refreshed one is a copy
+	auto refreshed = std::make_shared<CachedResponse>(response);
+	refreshed->expiresAt = expiresAt;
+
+	{
+		std::lock_guard<std::mutex> guard(cacheLock);
+		Insert(key, refreshed);
+	}
+
+	if(!storagePath.empty())
+		WriteFileExpiry(key, expiresAt);
+
+	return refreshed;
+}
+
+void TFC::Net::ResponseCache::TrimStorage(std::string const& writtenPath)
+{
+	auto files = GetStoredFiles(storagePath);
+
+	size_t totalSize = 0;
+	for(auto& file : files)
+		totalSize += file.size;
+
+	if(totalSize <= maxStorageSize)
+		return;
+
+	std::sort(files.begin(), files.end(), [] (StoredFile const& a, StoredFile const& b) {
+		if(a.writeTime.tv_sec != b.writeTime.tv_sec)
+			return a.writeTime.tv_sec < b.writeTime.tv_sec;
+		return a.writeTime.tv_nsec < b.writeTime.tv_nsec;
+	});
+
+	for(auto& file : files)
+	{
+		if(totalSize <= maxStorageSize)
+			break;
+
+		if(file.path == writtenPath || unlink(file.path.c_str()) != 0)
+			continue;
+
+		totalSize -= file.size;
+	}
+}
+
+std::string TFC::Net::ResponseCache::GetFilePath(std::string const& key) const
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016zx.cache", std::hash<std::string>()(key));
+	return storagePath + name;
+}
+
+namespace {
+
+/*
+ * FNV-1a hash of the key which is stored in the file. It is independent of the hash in the file
+ * name, so keys with the same file name are told apart without storing the key itself.
+ */
+std::string GetKeyHash(std::string const& key)
+{
+	uint64_t hash = 14695981039346656037ULL;
+
+	for(auto c : key)
+	{
+		hash ^= (uint8_t)c;
+		hash *= 1099511628211ULL;
+	}
+
+	char text[20];
+	snprintf(text, sizeof(text), "%016llx", (unsigned long long)hash);
+	return text;
+}
+
+// Expiry is written with fixed width at the start of the file, so it can be replaced in place
+int const expiryWidth = 20;
+
+void WriteExpiry(std::ostream& file, std::chrono::system_clock::time_point expiresAt)
+{
+	char text[expiryWidth + 2];
+	snprintf(text, sizeof(text), "%0*lld\n", expiryWidth,
+		(long long)std::chrono::duration_cast<std::chrono::seconds>(expiresAt.time_since_epoch()).count());
+	file.write(text, expiryWidth + 1);
+}
+
+}
+
+/*
+ * The file contains the expiry time in seconds since epoch, the hash of the key, the HTTP code,
+ * the validators, and the body length, each in its own line, followed by the body.
+ */
+void TFC::Net::ResponseCache::WriteFile(std::string const& key, CachedResponse const& response)
+{
+	auto path = GetFilePath(key);
+	auto temporaryPath = path + ".tmp";
+
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		WriteExpiry(file, response.expiresAt);
+		file << GetKeyHash(key) << '\n'
+			 << response.httpCode << '\n'
+			 << response.eTag << '\n'
+			 << response.lastModified << '\n'
+			 << response.body.size() << '\n';
+		file.write(response.body.data(), response.body.size());
+
+		if(!file)
+		{
+			dlog_print(DLOG_ERROR, LOG_TAG, "Cannot write response cache file %s", temporaryPath.c_str());
+			unlink(temporaryPath.c_str());
+			return;
+		}
+	}
+
+	// Reader never sees a partially written file
+	rename(temporaryPath.c_str(), path.c_str());
+}
+
+void TFC::Net::ResponseCache::WriteFileExpiry(std::string const& key, std::chrono::system_clock::time_point expiresAt)
+{
+	std::fstream file(GetFilePath(key), std::ios::binary | std::ios::in | std::ios::out);
+	if(!file)
+		return;
+
+	std::string expiry, keyHash;
+	std::getline(file, expiry);
+	std::getline(file, keyHash);
+
+	// File is replaced by the response of another key with the same file name
+	if(!file || expiry.size() != (size_t)expiryWidth || keyHash != GetKeyHash(key))
+		return;
+
+	file.seekp(0);
+	WriteExpiry(file, expiresAt);
+}
+
+std::shared_ptr<CachedResponse const> TFC::Net::ResponseCache::ReadFile(std::string const& key)
+{
+	auto path = GetFilePath(key);
+
+	std::ifstream file(path, std::ios::binary);
+	if(!file)
+		return nullptr;
+
+	file.seekg(0, std::ios::end);
+	auto fileSize = (long long)file.tellg();
+	file.seekg(0);
+
+	std::string expiry, keyHash;
+	std::getline(file, expiry);
+	std::getline(file, keyHash);
+
+	// Different key with the same file name, which is a valid entry of that key
+	if(file && expiry.size() == (size_t)expiryWidth && keyHash != GetKeyHash(key))
+		return nullptr;
+
+	auto response = std::make_shared<CachedResponse>();
+	long long bodyLength = -1;
+
+	file >> response->httpCode;
+	file.ignore(1);
+	std::getline(file, response->eTag);
+	std::getline(file, response->lastModified);
+	file >> bodyLength;
+	file.ignore(1);
+
+	// Truncated or corrupted file is a miss, and it is removed so it is not read again
+	if(!file || expiry.size() != (size_t)expiryWidth || bodyLength < 0 || (long long)file.tellg() + bodyLength != fileSize)
+	{
+		dlog_print(DLOG_ERROR, LOG_TAG, "Invalid response cache file %s is removed", path.c_str());
+		unlink(path.c_str());
+		return nullptr;
+	}
+
+	response->body.resize(bodyLength);
+	file.read(&response->body[0], bodyLength);
+
+	if(!file)
+	{
+		unlink(path.c_str());
+		return nullptr;
+	}
+
+	response->expiresAt = std::chrono::system_clock::time_point(std::chrono::seconds(std::atoll(expiry.c_str())));
+	return response;
+}
@@ -25,6 +25,9 @@
 #include <openssl/evp.h>
 #include <openssl/bio.h>
 #include <openssl/buffer.h>
+#include <zlib.h>
+
+#include <algorithm>
 
 std::string TFC::Net::Base64Encode(const uint8_t* buffer, size_t length)
 {
@@ -50,3 +53,113 @@ std::string TFC::Net::Base64Encode(const uint8_t* buffer, size_t length)
 
 	return encoded;
 }
+
+namespace {
+
+/*
+ * Lookup table of the characters which are not encoded, so each byte is classified by one load
+ */
+struct UnreservedCharacters
+{
+	bool table[256];
+
+	UnreservedCharacters() : table()
+	{
+		for(int c = '0'; c <= '9'; c++)
+			table[c] = true;
+
+		for(int c = 'A'; c <= 'Z'; c++)
+			table[c] = true;
+
+		for(int c = 'a'; c <= 'z'; c++)
+			table[c] = true;
+
+		table[(unsigned char)'-'] = true;
+		table[(unsigned char)'.'] = true;
+		table[(unsigned char)'_'] = true;
+		table[(unsigned char)'~'] = true;
+	}
+} const unreservedCharacters;
+
+}
+
+LIBAPI
+void TFC::Net::PercentEncode(std::string& output, char const* data, size_t length)
+{
+	static char const hexDigits[] = "0123456789ABCDEF";
+
+	// Bytes are unsigned, so UTF-8 bytes are not sign extended
+	auto bytes = reinterpret_cast<unsigned char const*>(data);
+	auto& unreserved = unreservedCharacters.table;
+
+	// Output is sized once, then written in place
+	size_t encodedLength = length;
+	for(size_t i = 0; i < length; i++)
+	{
+		if(!unreserved[bytes[i]])
+			encodedLength += 2;
+	}
+
+	auto offset = output.size();
+	output.resize(offset + encodedLength);
+	char* out = &output[offset];
+
+	for(size_t i = 0; i < length; i++)
+	{
+		auto c = bytes[i];
+
+		if(unreserved[c])
+		{
+			*out++ = c;
+		}
+		else
+		{
+			*out++ = '%';
+			*out++ = hexDigits[c >> 4];
+			*out++ = hexDigits[c & 0x0F];
+		}
+	}
+}
+
+LIBAPI
+std::string TFC::Net::PercentEncode(std::string const& value)
+{
+	std::string encoded;
+	PercentEncode(encoded, value.data(), value.size());
+	return encoded;
+}
+
+LIBAPI
+bool TFC::Net::GzipCompress(std::string& output, char const* data, size_t length)
+{
+	z_stream stream {};
+
+	// Window bits above 15 select the gzip wrapper instead of the zlib wrapper
+	if(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		return false;
+
+	// Bound of the compressed size, so the data is compressed in a single call
+	output.resize(deflateBound(&stream, length));
+
+	stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+	stream.avail_in = length;
+	stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+	stream.avail_out = output.size();
+
+	int result = deflate(&stream, Z_FINISH);
+	output.resize(stream.total_out);
+	deflateEnd(&stream);
+
+	return result == Z_STREAM_END;
+}
+
+int64_t TFC::Net::GetPercentile(std::vector<int64_t>& samples, double percentile)
+{
+	if(samples.empty())
+		return 0;
+
+	// Selecting the element is linear, which is cheaper than sorting every sample
+	auto index = std::min(samples.size() - 1, (size_t)(percentile * samples.size()));
+	std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+	return samples[index];
+}
@@ -0,0 +1,807 @@
+/*
+ * Tizen Fundamental Classes - TFC
+ * Copyright (c) 2016-2017 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ *    Serialization/JsonSerializer.cpp
+ *
+ * Created on:  Oct 18, 2026
+ */
+
+#include "TFC/Serialization/JsonSerializer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+using namespace TFC::Serialization;
+
+namespace {
+
+bool IsWhitespace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool IsDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+/*
+ * Find the end of the number at the position, following the JSON grammar, so strtod does not
+ * accept the forms which are not JSON, such as inf, nan, and hexadecimal.
+ *
+ * Returns nullptr if there is no valid number at the position.
+ */
+char const* ScanNumber(char const* cur, char const* end)
+{
+	if(cur < end && *cur == '-')
+		cur++;
+
+	if(cur == end || !IsDigit(*cur))
+		return nullptr;
+
+	// Leading zero cannot be followed by another digit
+	if(*cur == '0')
+		cur++;
+	else
+		while(cur < end && IsDigit(*cur))
+			cur++;
+
+	if(cur < end && *cur == '.')
+	{
+		cur++;
+
+		if(cur == end || !IsDigit(*cur))
+			return nullptr;
+
+		while(cur < end && IsDigit(*cur))
+			cur++;
+	}
+
+	if(cur < end && (*cur == 'e' || *cur == 'E'))
+	{
+		cur++;
+
+		if(cur < end && (*cur == '+' || *cur == '-'))
+			cur++;
+
+		if(cur == end || !IsDigit(*cur))
+			return nullptr;
+
+		while(cur < end && IsDigit(*cur))
+			cur++;
+	}
+
+	return cur;
+}
+
+void AppendUtf8(std::string& target, uint32_t codepoint)
+{
+	if(codepoint < 0x80)
+	{
+		target.push_back((char)codepoint);
+	}
+	else if(codepoint < 0x800)
+	{
+		target.push_back((char)(0xC0 | (codepoint >> 6)));
+		target.push_back((char)(0x80 | (codepoint & 0x3F)));
+	}
+	else if(codepoint < 0x10000)
+	{
+		target.push_back((char)(0xE0 | (codepoint >> 12)));
+		target.push_back((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+		target.push_back((char)(0x80 | (codepoint & 0x3F)));
+	}
+	else
+	{
+		target.push_back((char)(0xF0 | (codepoint >> 18)));
+		target.push_back((char)(0x80 | ((codepoint >> 12) & 0x3F)));
+		target.push_back((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+		target.push_back((char)(0x80 | (codepoint & 0x3F)));
+	}
+}
+
+template<typename T>
+void AssignChecked(T& target, int64_t val, uint64_t uval, bool negative)
+{
+	typedef std::numeric_limits<T> Limits;
+
+	if(negative)
+	{
+		TFC::TFCAssert<JsonParseException>(Limits::is_signed && val >= (int64_t)Limits::min(), "Number is out of range");
+		target = (T)val;
+	}
+	else
+	{
+		TFC::TFCAssert<JsonParseException>(uval <= (uint64_t)Limits::max(), "Number is out of range");
+		target = (T)uval;
+	}
+}
+
+}
+
+LIBAPI
+JsonSerializer::JsonSerializer() :
+	doDestruction(true), needSeparator(false), buffer(new SerializedType)
+{
+}
+
+LIBAPI
+JsonSerializer::JsonSerializer(SerializedType* bufferRef) :
+	doDestruction(false), needSeparator(false), buffer(bufferRef)
+{
+}
+
+LIBAPI
+JsonSerializer::JsonSerializer(JsonSerializer&& that) :
+	doDestruction(that.doDestruction), needSeparator(that.needSeparator), buffer(that.buffer)
+{
+	that.doDestruction = false;
+	that.buffer = nullptr;
+}
+
+LIBAPI
+JsonSerializer::~JsonSerializer()
+{
+	if(buffer && doDestruction)
+		delete buffer;
+}
+
+void JsonSerializer::WriteSeparator()
+{
+	if(needSeparator)
+		buffer->push_back(',');
+
+	needSeparator = true;
+}
+
+LIBAPI
+void JsonSerializer::Serialize(int32_t args)
+{
+	Serialize((int64_t)args);
+}
+
+LIBAPI
+void JsonSerializer::Serialize(uint32_t args)
+{
+	Serialize((uint64_t)args);
+}
+
+LIBAPI
+void JsonSerializer::Serialize(uint8_t args)
+{
+	Serialize((uint64_t)args);
+}
+
+LIBAPI
+void JsonSerializer::Serialize(int64_t args)
+{
+	WriteSeparator();
+
+	char buf[24];
+	int len = snprintf(buf, sizeof(buf), "%lld", (long long)args);
+	buffer->append(buf, len);
+}
+
+LIBAPI
+void JsonSerializer::Serialize(uint64_t args)
+{
+	WriteSeparator();
+
+	char buf[24];
+	int len = snprintf(buf, sizeof(buf), "%llu", (unsigned long long)args);
+	buffer->append(buf, len);
+}
+
+LIBAPI
+void JsonSerializer::Serialize(bool args)
+{
+	WriteSeparator();
+
+	if(args)
+		buffer->append("true", 4);
+	else
+		buffer->append("false", 5);
+}
+
+LIBAPI
+void JsonSerializer::Serialize(double args)
+{
+	WriteSeparator();
+
+	// JSON does not have representation of NaN and infinity
+	if(!std::isfinite(args))
+	{
+		buffer->append("null", 4);
+		return;
+	}
+
+	// Use the shortest precision which can be parsed back to the same value
+	char buf[32];
+	int len = snprintf(buf, sizeof(buf), "%.15g", args);
+
+	if(strtod(buf, nullptr) != args)
+		len = snprintf(buf, sizeof(buf), "%.17g", args);
+
+	buffer->append(buf, len);
+}
+
+LIBAPI
+void JsonSerializer::Serialize(std::string const& args)
+{
+	WriteSeparator();
+
+	static char const hexDigits[] = "0123456789abcdef";
+
+	buffer->reserve(buffer->size() + args.size() + 2);
+	buffer->push_back('"');
+
+	auto runBegin = args.data();
+	auto strEnd = runBegin + args.size();
+
+	for(auto p = runBegin; p < strEnd; p++)
+	{
+		unsigned char c = *p;
+
+		if(c >= 0x20 && c != '"' && c != '\\')
+			continue;
+
+		// Flush the unescaped run before writing escape sequence
+		buffer->append(runBegin, p);
+		runBegin = p + 1;
+
+		buffer->push_back('\\');
+
+		switch(c)
+		{
+		case '"': 	buffer->push_back('"'); break;
+		case '\\': 	buffer->push_back('\\'); break;
+		case '\b': 	buffer->push_back('b'); break;
+		case '\f': 	buffer->push_back('f'); break;
+		case '\n': 	buffer->push_back('n'); break;
+		case '\r': 	buffer->push_back('r'); break;
+		case '\t': 	buffer->push_back('t'); break;
+		default:
+			buffer->append("u00", 3);
+			buffer->push_back(hexDigits[c >> 4]);
+			buffer->push_back(hexDigits[c & 0xF]);
+		}
+	}
+
+	buffer->append(runBegin, strEnd);
+	buffer->push_back('"');
+}
+
+LIBAPI
+JsonSerializer JsonSerializer::CreateScope()
+{
+	// The scope writes to the same buffer, and takes over the pending separator
+	JsonSerializer ret(buffer);
+	ret.needSeparator = needSeparator;
+	needSeparator = true;
+	return ret;
+}
+
+LIBAPI
+void JsonSerializer::Serialize(JsonSerializer&)
+{
+	// Just do nothing as the scope is already written on the buffer
+}
+
+LIBAPI
+void JsonSerializer::BeginObject()
+{
+	WriteSeparator();
+	buffer->push_back('{');
+	needSeparator = false;
+}
+
+LIBAPI
+void JsonSerializer::EndObject()
+{
+	buffer->push_back('}');
+	needSeparator = true;
+}
+
+LIBAPI
+void JsonSerializer::BeginArray()
+{
+	WriteSeparator();
+	buffer->push_back('[');
+	needSeparator = false;
+}
+
+LIBAPI
+void JsonSerializer::EndArray()
+{
+	buffer->push_back(']');
+	needSeparator = true;
+}
+
+LIBAPI
+void JsonSerializer::SerializeKey(std::string const& key)
+{
+	Serialize(key);
+	buffer->push_back(':');
+	needSeparator = false;
+}
+
+LIBAPI
+void JsonSerializer::SerializeKey(char const* key, size_t keyLen)
+{
+	WriteSeparator();
+	buffer->push_back('"');
+	buffer->append(key, keyLen);
+	buffer->append("\":", 2);
+	needSeparator = false;
+}
+
+LIBAPI
+JsonSerializer::SerializedType JsonSerializer::EndPack()
+{
+	return std::move(*buffer);
+}
+
+LIBAPI
+JsonDeserializer::JsonDeserializer(SerializedType const& p) :
+	begin(p.c_str()), cur(p.c_str()), end(p.c_str() + p.size()), first(false)
+{
+}
+
+void JsonDeserializer::Fail(char const* message)
+{
+	std::string msg(message);
+	msg += " (at offset ";
+	msg += std::to_string(cur - begin);
+	msg += ")";
+	throw JsonParseException(std::move(msg));
+}
+
+void JsonDeserializer::SkipWhitespace()
+{
+	while(cur < end && IsWhitespace(*cur))
+		cur++;
+}
+
+char JsonDeserializer::Peek()
+{
+	SkipWhitespace();
+
+	if(cur == end)
+		Fail("Unexpected end of JSON text");
+
+	return *cur;
+}
+
+LIBAPI
+void JsonDeserializer::Expect(char c)
+{
+	if(Peek() != c)
+		Fail("Unexpected character in JSON text");
+
+	cur++;
+}
+
+bool JsonDeserializer::ConsumeNull()
+{
+	if(Peek() != 'n')
+		return false;
+
+	if(end - cur < 4 || strncmp(cur, "null", 4) != 0)
+		Fail("Invalid literal in JSON text");
+
+	cur += 4;
+	first = false;
+	return true;
+}
+
+bool JsonDeserializer::ParseInteger(int64_t& ret, uint64_t& uret, bool& negative)
+{
+	if(ConsumeNull())
+		return false;
+
+	negative = false;
+
+	if(*cur == '-')
+	{
+		negative = true;
+		cur++;
+	}
+
+	if(cur == end || *cur < '0' || *cur > '9')
+		Fail("Invalid number in JSON text");
+
+	char const* digitBegin = cur;
+	uint64_t val = 0;
+
+	while(cur < end && *cur >= '0' && *cur <= '9')
+	{
+		uint64_t next = val * 10 + (*cur - '0');
+
+		if(next / 10 != val)
+			Fail("Number is out of range");
+
+		val = next;
+		cur++;
+	}
+
+	if(cur < end && (*cur == '.' || *cur == 'e' || *cur == 'E'))
+	{
+		// Integer target receiving a number with fraction or exponent, let strtod handle it
+		char const* numberBegin = negative ? digitBegin - 1 : digitBegin;
+		char* parseEnd = nullptr;
+		double dbl = strtod(numberBegin, &parseEnd);
+
+		if(parseEnd != ScanNumber(numberBegin, end))
+			Fail("Invalid number in JSON text");
+
+		cur = parseEnd;
+
+		if(dbl != std::trunc(dbl))
+			Fail("Number is not an integer");
+
+		// Bounds are -2^63 and 2^64, which are exact in double
+		if(dbl < -9223372036854775808.0 || dbl >= 18446744073709551616.0)
+			Fail("Number is out of range");
+
+		negative = dbl < 0;
+
+		if(negative)
+		{
+			ret = (int64_t)dbl;
+			uret = 0;
+		}
+		else
+		{
+			uret = (uint64_t)dbl;
+			ret = (int64_t)uret;
+		}
+
+		return true;
+	}
+
+	if(negative)
+	{
+		if(val > (uint64_t)std::numeric_limits<int64_t>::max() + 1)
+			Fail("Number is out of range");
+
+		ret = (int64_t)(0 - val);
+		uret = 0;
+	}
+	else
+	{
+		ret = (int64_t)val;
+		uret = val;
+	}
+
+	return true;
+}
+
+#define JSON_DefineIntegerDeserialize(TYPE) \
+	LIBAPI \
+	void JsonDeserializer::Deserialize(TYPE& target) \
+	{ \
+		int64_t val; uint64_t uval; bool negative; \
+		if(ParseInteger(val, uval, negative)) \
+			AssignChecked(target, val, uval, negative); \
+	}
+
+JSON_DefineIntegerDeserialize(int8_t);
+JSON_DefineIntegerDeserialize(int16_t);
+JSON_DefineIntegerDeserialize(int32_t);
+JSON_DefineIntegerDeserialize(int64_t);
+JSON_DefineIntegerDeserialize(uint8_t);
+JSON_DefineIntegerDeserialize(uint16_t);
+JSON_DefineIntegerDeserialize(uint32_t);
+JSON_DefineIntegerDeserialize(uint64_t);
+
+#undef JSON_DefineIntegerDeserialize
+
+LIBAPI
+void JsonDeserializer::Deserialize(double& target)
+{
+	if(ConsumeNull())
+		return;
+
+	auto numberEnd = ScanNumber(cur, end);
+
+	if(numberEnd == nullptr)
+		Fail("Invalid number in JSON text");
+
+	// The source string is always null-terminated, so strtod will stop at the end of the text
+	char* parseEnd = nullptr;
+	target = strtod(cur, &parseEnd);
+
+	if(parseEnd != numberEnd)
+		Fail("Invalid number in JSON text");
+
+	cur = parseEnd;
+}
+
+LIBAPI
+void JsonDeserializer::Deserialize(bool& target)
+{
+	if(ConsumeNull())
+		return;
+
+	if(end - cur >= 4 && strncmp(cur, "true", 4) == 0)
+	{
+		target = true;
+		cur += 4;
+	}
+	else if(end - cur >= 5 && strncmp(cur, "false", 5) == 0)
+	{
+		target = false;
+		cur += 5;
+	}
+	else
+	{
+		Fail("Invalid boolean in JSON text");
+	}
+}
+
+LIBAPI
+void JsonDeserializer::Deserialize(std::string& target)
+{
+	if(ConsumeNull())
+		return;
+
+	target.clear();
+	ParseString(target);
+}
+
+void JsonDeserializer::ParseString(std::string& target)
+{
+	if(Peek() != '"')
+		Fail("Expecting string in JSON text");
+
+	auto runBegin = ++cur;
+
+	while(true)
+	{
+		if(cur == end)
+			Fail("Unterminated string in JSON text");
+
+		char c = *cur;
+
+		if(c == '"')
+			break;
+
+		if(c != '\\')
+		{
+			cur++;
+			continue;
+		}
+
+		// Flush the unescaped run before decoding escape sequence
+		target.append(runBegin, cur);
+
+		if(++cur == end)
+			Fail("Unterminated string in JSON text");
+
+		switch(*cur++)
+		{
+		case '"': 	target.push_back('"'); break;
+		case '\\': 	target.push_back('\\'); break;
+		case '/': 	target.push_back('/'); break;
+		case 'b': 	target.push_back('\b'); break;
+		case 'f': 	target.push_back('\f'); break;
+		case 'n': 	target.push_back('\n'); break;
+		case 'r': 	target.push_back('\r'); break;
+		case 't': 	target.push_back('\t'); break;
+		case 'u':
+		{
+			auto readHex = [this] () -> uint32_t
+			{
+				if(end - cur < 4)
+					Fail("Invalid unicode escape in JSON text");
+
+				uint32_t val = 0;
+				for(int i = 0; i < 4; i++)
+				{
+					char h = *cur++;
+					val <<= 4;
+
+					if(h >= '0' && h <= '9') 		val |= h - '0';
+					else if(h >= 'a' && h <= 'f') 	val |= h - 'a' + 10;
+					else if(h >= 'A' && h <= 'F') 	val |= h - 'A' + 10;
+					else Fail("Invalid unicode escape in JSON text");
+				}
+				return val;
+			};
+
+			uint32_t codepoint = readHex();
+
+			// Combine UTF-16 surrogate pair
+			if(codepoint >= 0xD800 && codepoint <= 0xDBFF && end - cur >= 6 && cur[0] == '\\' && cur[1] == 'u')
+			{
+				cur += 2;
+				uint32_t low = readHex();
+
+				if(low >= 0xDC00 && low <= 0xDFFF)
+					codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+				else
+					Fail("Invalid surrogate pair in JSON text");
+			}
+
+			AppendUtf8(target, codepoint);
+			break;
+		}
+		default:
+			Fail("Invalid escape sequence in JSON text");
+		}
+
+		runBegin = cur;
+	}
+
+	target.append(runBegin, cur);
+	cur++;
+	first = false;
+}
+
+void JsonDeserializer::SkipString()
+{
+	// Caller guarantee that the current character is the opening quote
+	cur++;
+
+	while(cur < end && *cur != '"')
+	{
+		if(*cur == '\\')
+			cur++;
+		cur++;
+	}
+
+	if(cur >= end)
+		Fail("Unterminated string in JSON text");
+
+	cur++;
+}
+
+LIBAPI
+bool JsonDeserializer::BeginObject()
+{
+	if(ConsumeNull())
+		return false;
+
+	Expect('{');
+	first = true;
+	return true;
+}
+
+LIBAPI
+bool JsonDeserializer::NextKey(char const*& key, size_t& keyLen)
+{
+	if(Peek() == '}')
+	{
+		cur++;
+		first = false;
+		return false;
+	}
+
+	if(!first)
+		Expect(',');
+
+	if(Peek() != '"')
+		Fail("Expecting key in JSON object");
+
+	// Try to refer to the key directly if it does not contain escape sequence
+	auto keyBegin = cur + 1;
+	auto keyEnd = keyBegin;
+
+	while(keyEnd < end && *keyEnd != '"' && *keyEnd != '\\')
+		keyEnd++;
+
+	if(keyEnd < end && *keyEnd == '"')
+	{
+		key = keyBegin;
+		keyLen = keyEnd - keyBegin;
+		cur = keyEnd + 1;
+	}
+	else
+	{
+		scratch.clear();
+		ParseString(scratch);
+		key = scratch.data();
+		keyLen = scratch.size();
+	}
+
+	Expect(':');
+	first = false;
+	return true;
+}
+
+LIBAPI
+bool JsonDeserializer::BeginArray()
+{
+	if(ConsumeNull())
+		return false;
+
+	Expect('[');
+	first = true;
+	return true;
+}
+
+LIBAPI
+bool JsonDeserializer::NextElement()
+{
+	if(Peek() == ']')
+	{
+		cur++;
+		first = false;
+		return false;
+	}
+
+	if(!first)
+		Expect(',');
+
+	first = false;
+	return true;
+}
+
+LIBAPI
+void JsonDeserializer::SkipValue()
+{
+	int depth = 0;
+
+	do
+	{
+		char c = Peek();
+
+		switch(c)
+		{
+		case '{':
+		case '[':
+			depth++;
+			cur++;
+			break;
+		case '}':
+		case ']':
+			// Closing bracket without the opening one belongs to the enclosing scope
+			if(depth == 0)
+				Fail("Unexpected closing bracket in JSON text");
+			depth--;
+			cur++;
+			break;
+		case ',':
+		case ':':
+			if(depth == 0)
+				Fail("Unexpected separator in JSON text");
+			cur++;
+			break;
+		case '"':
+			SkipString();
+			break;
+		default:
+			// Number and literals, which ends at the next structural character
+			while(cur < end && !IsWhitespace(*cur) && *cur != ',' && *cur != '}' && *cur != ']' && *cur != ':')
+				cur++;
+		}
+	}
+	while(depth > 0);
+
+	first = false;
+}
+
+LIBAPI
+void JsonDeserializer::Finalize()
+{
+	SkipWhitespace();
+
+	if(cur != end)
+		Fail("Unexpected trailing characters in JSON text");
+}
@@ -22,6 +22,8 @@
 
 #include "TFC/ServiceModel/BinarySerializer.h"
 
+#include <cstring>
+
 using namespace TFC::ServiceModel;
 
 LIBAPI
@@ -329,33 +331,36 @@ void TFC::ServiceModel::BinarySerializer::Serialize(unsigned char args)
 LIBAPI
 void TFC::ServiceModel::BinarySerializer::Serialize(const std::vector<uint8_t>& args)
 {
-	if (args.empty())
-	{
-		Serialize((uint32_t)0);
-	}
-	else
-	{
-		Serialize(args.size());
+	Serialize((uint32_t)args.size());
+	SerializeBlock(args.data(), args.size());
+}
 
-		for (auto obj : args)
-		{
-			Serialize(obj);
-		}
-	}
+LIBAPI
+void TFC::ServiceModel::BinarySerializer::SerializeBlock(void const* data, size_t size)
+{
+	auto ptr = static_cast<uint8_t const*>(data);
+	buffer->insert(buffer->end(), ptr, ptr + size);
 }
 
 LIBAPI
 void TFC::ServiceModel::BinaryDeserializer::Deserialize(std::vector<uint8_t>& target)
 {
-	target.clear();
-
 	uint32_t size = 0;
 	Deserialize(size);
 
-	for(int i = 0; i < size; i++)
-	{
-		uint8_t tmp = 0;
-		Deserialize(tmp);
-		target.push_back(tmp);
-	}
+	TFCAssert<Serialization::SerializationException>(size <= bufferRef.size() - currentPos, "Array size exceeds the remaining buffer");
+
+	target.assign(bufferRef.begin() + currentPos, bufferRef.begin() + currentPos + size);
+	currentPos += size;
+}
+
+LIBAPI
+void TFC::ServiceModel::BinaryDeserializer::DeserializeBlock(void* data, size_t size)
+{
+	TFCAssert<Serialization::SerializationException>(size <= bufferRef.size() - currentPos, "Block size exceeds the remaining buffer");
+
+	if(size != 0)
+		std::memcpy(data, bufferRef.data() + currentPos, size);
+
+	currentPos += size;
 }
@@ -25,14 +25,467 @@
 #include "TFC/ServiceModel/GDBusEndpoint.h"
 
 #include <glib-2.0/gio/gio.h>
+#include <gio/gunixfdlist.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
 
 #include <regex>
+#include <sstream>
 #include <string>
 
+// Define TFC_GDBUS_TRACE when building the library to log every incoming call and its result
+#ifdef TFC_GDBUS_TRACE
+#define TFC_GDBusTrace(...) dlog_print(DLOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#else
+#define TFC_GDBusTrace(...)
+#endif
+
 using namespace TFC::ServiceModel;
 
+namespace {
+
+class GVariantDeleter
+{
+public:
+	void operator()(GVariant* ptr)
+	{
+		if(ptr != nullptr)
+			g_variant_unref(ptr);
+	}
+};
+
+typedef std::unique_ptr<GVariant, GVariantDeleter> GVariantAutoPtr;
+
+class GObjectDeleter
+{
+public:
+	void operator()(gpointer ptr)
+	{
+		if(ptr != nullptr)
+			g_object_unref(ptr);
+	}
+};
+
+/*
+ * Handle in a message body built by this process, which is the descriptor of a shared buffer. The
+ * variant keeps the descriptor open until it is attached to the message, either through the
+ * mapping of the buffer or by owning the descriptor received from the remote side.
+ */
+struct LocalHandle
+{
+	gint32 fd;
+	std::shared_ptr<void> owner;
+};
+
+void ReleaseLocalHandle(gpointer data)
+{
+	auto handle = static_cast<LocalHandle*>(data);
+
+	if(handle->owner == nullptr)
+		close(handle->fd);
+
+	delete handle;
+}
+
+GVariant* NewLocalHandle(int fd, std::shared_ptr<void> owner)
+{
+	auto handle = new LocalHandle { fd, std::move(owner) };
+	return g_variant_new_from_data(G_VARIANT_TYPE_HANDLE, &handle->fd, sizeof(gint32), TRUE, ReleaseLocalHandle, handle);
+}
+
+bool MayContainHandle(GVariant* value)
+{
+	auto type = g_variant_get_type_string(value);
+	return strchr(type, 'h') != nullptr || strchr(type, 'v') != nullptr;
+}
+
+bool ContainsHandle(GVariant* value)
+{
+	if(!MayContainHandle(value))
+		return false;
+
+	if(g_variant_is_of_type(value, G_VARIANT_TYPE_HANDLE))
+		return true;
+
+	if(!g_variant_is_container(value))
+		return false;
+
+	auto count = g_variant_n_children(value);
+
+	for(gsize i = 0; i < count; i++)
+	{
+		GVariantAutoPtr child { g_variant_get_child_value(value, i) };
+
+		if(ContainsHandle(child.get()))
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Rebuild the value with every handle replaced by the result of replace(handle, boxed), where
+ * boxed tells whether the handle is the content of a variant so it can be replaced by a value of
+ * another type. Returns a new reference, the parts without handle are shared with the value.
+ */
+template<typename TReplace>
+GVariant* ReplaceHandles(GVariant* value, TReplace const& replace, bool boxed = false)
+{
+	if(!MayContainHandle(value))
+		return g_variant_ref(value);
+
+	if(g_variant_is_of_type(value, G_VARIANT_TYPE_HANDLE))
+		return g_variant_ref_sink(replace(g_variant_get_handle(value), boxed));
+
+	if(!g_variant_is_container(value))
+		return g_variant_ref(value);
+
+	auto valueClass = g_variant_classify(value);
+	auto count = g_variant_n_children(value);
+
+	std::vector<GVariant*> children;
+	children.reserve(count);
+
+	for(gsize i = 0; i < count; i++)
+	{
+		GVariantAutoPtr child { g_variant_get_child_value(value, i) };
+		children.push_back(ReplaceHandles(child.get(), replace, valueClass == G_VARIANT_CLASS_VARIANT));
+	}
+
+	GVariant* result = nullptr;
+
+	switch(valueClass)
+	{
+	case G_VARIANT_CLASS_VARIANT:
+		result = g_variant_new_variant(children[0]);
+		break;
+	case G_VARIANT_CLASS_MAYBE:
+		result = g_variant_new_maybe(g_variant_type_element(g_variant_get_type(value)), count != 0 ? children[0] : nullptr);
+		break;
+	case G_VARIANT_CLASS_ARRAY:
+		result = g_variant_new_array(g_variant_type_element(g_variant_get_type(value)), children.data(), count);
+		break;
+	case G_VARIANT_CLASS_DICT_ENTRY:
+		result = g_variant_new_dict_entry(children[0], children[1]);
+		break;
+	default:
+		result = g_variant_new_tuple(children.data(), count);
+		break;
+	}
+
+	g_variant_ref_sink(result);
+
+	for(auto child : children)
+		g_variant_unref(child);
+
+	return result;
+}
+
+void ThrowGError(GError* err)
+{
+	std::string message(err->message);
+	g_error_free(err);
+	throw GDBusException(std::move(message));
+}
+
+/*
+ * Replace the descriptors of the shared buffers in the message body by their index in the
+ * descriptor list of the message, which is created only if the body contains any. Consumes the
+ * passed body and returns a new reference.
+ */
+GVariant* AttachSharedBuffers(GVariant* body, GUnixFDList*& fdList)
+{
+	fdList = nullptr;
+	g_variant_ref_sink(body);
+
+	if(!ContainsHandle(body))
+		return body;
+
+	GVariantAutoPtr source { body };
+	std::unique_ptr<GUnixFDList, GObjectDeleter> list(g_unix_fd_list_new());
+
+	auto result = ReplaceHandles(body, [&list] (gint32 fd, bool) {
+		GError* err = nullptr;
+		auto index = g_unix_fd_list_append(list.get(), fd, &err);
+
+		if(err != nullptr)
+			ThrowGError(err);
+
+		return g_variant_new_handle(index);
+	});
+
+	fdList = list.release();
+	return result;
+}
+
+/*
+ * Check whether the shared memory cannot be shrunk or written anymore, so it can be mapped without
+ * the risk of SIGBUS when its owner truncates it.
+ */
+bool IsSealed(int fd)
+{
+#ifdef F_GET_SEALS
+	int seals = fcntl(fd, F_GET_SEALS);
+	return seals >= 0 && (seals & (F_SEAL_SHRINK | F_SEAL_WRITE)) == (F_SEAL_SHRINK | F_SEAL_WRITE);
+#else
+	return false;
+#endif
+}
+
+/*
+ * Copy the content of the shared memory which is not sealed. Reading stops at the end of the file,
+ * so a file truncated meanwhile only gives the remaining bytes. Returns the number of bytes read.
+ */
+size_t ReadSharedMemory(int fd, void* target, size_t size)
+{
+	size_t offset = 0;
+
+	while(offset < size)
+	{
+		auto count = pread(fd, static_cast<uint8_t*>(target) + offset, size - offset, offset);
+
+		if(count < 0 && errno == EINTR)
+			continue;
+
+		if(count <= 0)
+			break;
+
+		offset += count;
+	}
+
+	return offset;
+}
+
+/*
+ * Replace the shared buffers in the signal body by their content, as signal does not carry file
+ * descriptor. Consumes the passed body and returns a new reference.
+ */
+GVariant* InlineSharedBuffers(GVariant* body)
+{
+	if(!ContainsHandle(body))
+		return body;
+
+	GVariantAutoPtr source { body };
+
+	return ReplaceHandles(body, [] (gint32 fd, bool boxed) {
+		struct stat info;
+		void* mapped = MAP_FAILED;
+
+		if(!boxed || fstat(fd, &info) != 0 || info.st_size <= 0)
+			return boxed ? g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, nullptr, 0, sizeof(uint8_t)) : g_variant_new_handle(-1);
+
+		if(!IsSealed(fd))
+		{
+			std::vector<uint8_t> content(info.st_size);
+			content.resize(ReadSharedMemory(fd, content.data(), content.size()));
+			return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, content.data(), content.size(), sizeof(uint8_t));
+		}
+
+		mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+		if(mapped == MAP_FAILED)
+			return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, nullptr, 0, sizeof(uint8_t));
+
+		auto value = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, mapped, info.st_size, sizeof(uint8_t));
+		munmap(mapped, info.st_size);
+		return value;
+	});
+}
+
+/*
+ * Replace the indices in the received message body by descriptors of this process, which are
+ * closed along with the returned value. A handle without descriptor in the message becomes -1,
+ * so it is never taken as a descriptor of this process. Returns a new reference.
+ */
+GVariant* ResolveSharedBuffers(GVariant* body, GUnixFDList* fdList)
+{
+	if(body == nullptr)
+		return nullptr;
+
+	if(!ContainsHandle(body))
+		return g_variant_ref(body);
+
+	return ReplaceHandles(body, [fdList] (gint32 index, bool) {
+		if(fdList == nullptr || index < 0 || index >= g_unix_fd_list_get_length(fdList))
+			return g_variant_new_handle(-1);
+
+		GError* err = nullptr;
+		int fd = g_unix_fd_list_get(fdList, index, &err);
+
+		if(err != nullptr)
+			ThrowGError(err);
+
+		return NewLocalHandle(fd, nullptr);
+	});
+}
+
+int CreateSharedMemory()
+{
+	int fd = -1;
+
+#ifdef __NR_memfd_create
+	fd = syscall(__NR_memfd_create, "tfc-rpc", 1 /* MFD_CLOEXEC */ | 2 /* MFD_ALLOW_SEALING */);
+#endif
+
+	if(fd < 0)
+	{
+		// Kernel without memfd, use an unlinked file in shared memory file system
+		char path[] = "/dev/shm/tfc-rpc-XXXXXX";
+		fd = mkstemp(path);
+
+		if(fd >= 0)
+			unlink(path);
+	}
+
+	if(fd < 0)
+		throw GDBusException(std::string("Cannot create shared memory: ") + strerror(errno));
+
+	return fd;
+}
+
+}
+
+struct TFC::ServiceModel::SharedBuffer::Mapping
+{
+	// Descriptor of the shared memory file, or -1 if the content is in the heap
+	int fd;
+	void* address;
+	size_t size;
+
+	~Mapping()
+	{
+		if(fd < 0)
+		{
+			free(address);
+			return;
+		}
+
+		munmap(address, size);
+		close(fd);
+	}
+};
+
+LIBAPI
+TFC::ServiceModel::SharedBuffer::SharedBuffer()
+{
+}
+
+LIBAPI
+TFC::ServiceModel::SharedBuffer::SharedBuffer(void const* data, size_t size)
+{
+	if(size == 0)
+		return;
+
+	int fd = CreateSharedMemory();
+	void* mapped = MAP_FAILED;
+
+	if(ftruncate(fd, size) == 0)
+		mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	if(mapped == MAP_FAILED)
+	{
+		std::string message("Cannot map shared memory: ");
+		message += strerror(errno);
+		close(fd);
+		throw GDBusException(std::move(message));
+	}
+
+	memcpy(mapped, data, size);
+	munmap(mapped, size);
+
+#ifdef F_ADD_SEALS
+	// The remote side maps the same file, so it must not change once shared
+	fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+#endif
+
+	mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+
+	if(mapped == MAP_FAILED)
+	{
+		std::string message("Cannot map shared memory: ");
+		message += strerror(errno);
+		close(fd);
+		throw GDBusException(std::move(message));
+	}
+
+	mapping.reset(new Mapping { fd, mapped, size });
+}
+
+LIBAPI
+TFC::ServiceModel::SharedBuffer::SharedBuffer(std::vector<uint8_t> const& data) :
+	SharedBuffer(data.data(), data.size())
+{
+}
+
+LIBAPI
+uint8_t const* TFC::ServiceModel::SharedBuffer::GetData() const
+{
+	return mapping != nullptr ? static_cast<uint8_t const*>(mapping->address) : nullptr;
+}
+
+LIBAPI
+size_t TFC::ServiceModel::SharedBuffer::GetSize() const
+{
+	return mapping != nullptr ? mapping->size : 0;
+}
+
+LIBAPI
+std::vector<uint8_t> TFC::ServiceModel::SharedBuffer::ToVector() const
+{
+	auto data = GetData();
+	return std::vector<uint8_t>(data, data + GetSize());
+}
+
+SharedBuffer TFC::ServiceModel::SharedBuffer::Map(int fd)
+{
+	SharedBuffer buffer;
+	struct stat info;
+
+	TFCAssert<Serialization::SerializationException>(fd >= 0 && fstat(fd, &info) == 0,
+			"The message does not carry the file descriptor of the shared buffer");
+
+	if(info.st_size == 0)
+		return buffer;
+
+	if(!IsSealed(fd))
+	{
+		// The peer can still truncate the file, so it is copied instead of mapped
+		auto address = malloc(info.st_size);
+		TFCAssert<Serialization::SerializationException>(address != nullptr, "Cannot copy the shared buffer of the message");
+
+		buffer.mapping.reset(new Mapping { -1, address, ReadSharedMemory(fd, address, info.st_size) });
+		return buffer;
+	}
+
+	auto mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	TFCAssert<Serialization::SerializationException>(mapped != MAP_FAILED, "Cannot map the shared buffer of the message");
+
+	buffer.mapping.reset(new Mapping { dup(fd), mapped, (size_t)info.st_size });
+	return buffer;
+}
+
+SharedBuffer TFC::ServiceModel::SharedBuffer::Copy(void const* data, size_t size)
+{
+	SharedBuffer buffer;
+
+	if(size == 0)
+		return buffer;
+
+	auto address = malloc(size);
+	memcpy(address, data, size);
+
+	buffer.mapping.reset(new Mapping { -1, address, size });
+	return buffer;
+}
 
 LIBAPI
 GVariantSerializer::GVariantSerializer()
@@ -84,51 +537,99 @@ void GVariantSerializer::Serialize(std::string args)
 LIBAPI
 void GVariantSerializer::Serialize(std::vector<uint8_t> const& args)
 {
-	GVariantBuilder arrayBuilder;
-	g_variant_builder_init(&arrayBuilder, G_VARIANT_TYPE_ARRAY);
+	SerializeFixedArray("y", args.data(), args.size(), sizeof(uint8_t));
+}
+
+LIBAPI
+void GVariantSerializer::Serialize(SharedBuffer const& args)
+{
+	GVariant* value = nullptr;
 
-	for(auto& obj : args)
+	if(args.mapping == nullptr || args.mapping->fd < 0)
 	{
-		g_variant_builder_add(&arrayBuilder, "y", obj);
+		value = g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, args.GetData(), args.GetSize(), sizeof(uint8_t));
+	}
+	else
+	{
+		// Only the descriptor goes to the message, which is attached to its descriptor list when sent
+		value = NewLocalHandle(args.mapping->fd, args.mapping);
 	}
 
-	g_variant_builder_add_value(&builder, g_variant_builder_end(&arrayBuilder));
+	g_variant_builder_add_value(&builder, g_variant_new_variant(value));
 }
 
 LIBAPI
 void GVariantSerializer::Serialize(std::vector<int32_t> const& args)
 {
-	GVariantBuilder arrayBuilder;
-	g_variant_builder_init(&arrayBuilder, G_VARIANT_TYPE_ARRAY);
+	SerializeFixedArray("i", args.data(), args.size(), sizeof(int32_t));
+}
 
-	for(auto& obj : args)
-	{
-		g_variant_builder_add(&arrayBuilder, "i", obj);
-	}
+LIBAPI
+void GVariantSerializer::Serialize(std::vector<int64_t> const& args)
+{
+	SerializeFixedArray("x", args.data(), args.size(), sizeof(int64_t));
+}
 
-	g_variant_builder_add_value(&builder, g_variant_builder_end(&arrayBuilder));
+LIBAPI
+void GVariantSerializer::SerializeFixedArray(char const* elementType, void const* data, size_t count, size_t elementSize)
+{
+	auto arr = g_variant_new_fixed_array(G_VARIANT_TYPE(elementType), data, count, elementSize);
+	g_variant_builder_add_value(&builder, arr);
 }
 
 LIBAPI
-void GVariantSerializer::Serialize(std::vector<int64_t> const& args)
+void GVariantSerializer::SerializeElementArray(std::vector<SerializedType>& elements, char const* valueType)
 {
-	GVariantBuilder arrayBuilder;
-	g_variant_builder_init(&arrayBuilder, G_VARIANT_TYPE_ARRAY);
+	GVariant* arr = nullptr;
 
-	for(auto& obj : args)
+	if(elements.empty())
 	{
-		g_variant_builder_add(&arrayBuilder, "x", obj);
+		// Empty array still needs definite element type
+		bool definite = valueType != nullptr && g_variant_type_string_is_valid(valueType)
+				&& g_variant_type_is_definite(G_VARIANT_TYPE(valueType));
+		arr = g_variant_new_array(G_VARIANT_TYPE(definite ? valueType : "(i)"), nullptr, 0);
+	}
+	else
+	{
+		for(auto& element : elements)
+			g_variant_ref_sink(element);
+
+		auto type = g_variant_get_type(elements[0]);
+		bool uniform = std::all_of(elements.begin(), elements.end(),
+				[type] (GVariant* element) { return g_variant_type_equal(g_variant_get_type(element), type); });
+
+		for(auto& element : elements)
+		{
+			GVariant* replacement = nullptr;
+
+			if(!uniform)
+				replacement = g_variant_new_variant(element);
+			else if(valueType != nullptr && g_variant_n_children(element) == 1)
+				replacement = g_variant_get_child_value(element, 0);
+
+			if(replacement != nullptr)
+			{
+				g_variant_unref(element);
+				element = g_variant_ref_sink(replacement);
+			}
+		}
+
+		arr = g_variant_new_array(nullptr, elements.data(), elements.size());
+
+		for(auto element : elements)
+			g_variant_unref(element);
 	}
 
-	g_variant_builder_add_value(&builder, g_variant_builder_end(&arrayBuilder));
+	g_variant_builder_add_value(&builder, arr);
 }
 
 LIBAPI
 GVariantDeserializer::GVariantDeserializer(SerializedType p) : variant(p) {
-	dlog_print(DLOG_DEBUG, "TFC-RPC", "Got to serialize: %d", p);
-	auto str = g_variant_print(p, true);
-	dlog_print(DLOG_DEBUG, "TFC-RPC", "The value is: %s", str);
-	g_free(str);
+#ifdef TFC_GDBUS_TRACE
+	gchar* printed = g_variant_print(p, true);
+	TFC_GDBusTrace("Deserialize value: %s", printed);
+	g_free(printed);
+#endif
 
 	if(!g_variant_type_is_tuple(g_variant_get_type(p)))
 	{
@@ -150,6 +651,40 @@ GVariantDeserializer::GVariantAutoPtr GVariantDeserializer::NextField() {
 	return GVariantAutoPtr { next };
 }
 
+LIBAPI
+GVariantDeserializer::SerializedType GVariantDeserializer::UnboxElement(SerializedType element) {
+	// Shared buffer field is a variant too, but its content is never a tuple
+	if(!g_variant_is_of_type(element, G_VARIANT_TYPE_VARIANT))
+		return element;
+
+	auto inner = g_variant_get_variant(element);
+
+	if(!g_variant_type_is_tuple(g_variant_get_type(inner)))
+	{
+		g_variant_unref(inner);
+		return element;
+	}
+
+	g_variant_unref(element);
+	return inner;
+}
+
+LIBAPI
+GVariantDeserializer::GVariantAutoPtr GVariantDeserializer::NextFixedArray(char const* elementType, size_t elementSize, void const*& data, size_t& count) {
+	auto arr = NextField();
+	auto type = g_variant_get_type(arr.get());
+
+	TFCAssert<Serialization::SerializationException>(g_variant_type_is_array(type)
+		&& g_variant_type_equal(g_variant_type_element(type), G_VARIANT_TYPE(elementType)),
+		"The specified field is not an array of the expected type");
+
+	gsize len = 0;
+	data = g_variant_get_fixed_array(arr.get(), &len, elementSize);
+	count = len;
+
+	return arr;
+}
+
 
 template<>
 LIBAPI
@@ -201,9 +736,140 @@ bool GVariantDeserializer::DeserializeImpl<bool>(SerializedType obj)
 
 
 
+namespace {
+
+std::mutex connectionPoolLock;
+std::unordered_map<std::string, GDBusConnection*> connectionPool;
+std::unordered_map<std::string, GDBusProxy*> proxyPool;
+
+// Number of clients subscribed to the event of the object path on a pooled connection
+typedef std::tuple<GDBusConnection*, std::string, std::string> SubscriptionKey;
+std::map<SubscriptionKey, size_t> subscriptionCount;
+
+GDBusConnection* GetConnection(GBusType busType, gpointer handle)
+{
+	if(busType == G_BUS_TYPE_NONE)
+		return (GDBusConnection*)handle;
+	else
+		return g_dbus_proxy_get_connection((GDBusProxy*)handle);
+}
+
+void AddSubscription(GDBusConnection* connection, std::string const& objectPath, std::string const& eventName)
+{
+	std::lock_guard<std::mutex> guard(connectionPoolLock);
+	subscriptionCount[SubscriptionKey { connection, objectPath, eventName }]++;
+}
+
+/*
+ * Returns true if no other client is subscribed to the event on the connection anymore.
+ */
+bool RemoveSubscription(GDBusConnection* connection, std::string const& objectPath, std::string const& eventName)
+{
+	std::lock_guard<std::mutex> guard(connectionPoolLock);
+
+	auto iter = subscriptionCount.find(SubscriptionKey { connection, objectPath, eventName });
+
+	if(iter == subscriptionCount.end())
+		return true;
+
+	if(--iter->second != 0)
+		return false;
+
+	subscriptionCount.erase(iter);
+	return true;
+}
+
+/*
+ * Get the pooled object which passes the health check, otherwise create it outside the lock, so
+ * a slow connect does not block the clients of the other addresses. If concurrent clients create
+ * the same object, the first one pooled is kept.
+ */
+template<typename T, typename TIsClosed, typename TCreate>
+T* AcquirePooled(std::unordered_map<std::string, T*>& pool, std::string const& key, TIsClosed isClosed, TCreate create)
+{
+	{
+		std::lock_guard<std::mutex> guard(connectionPoolLock);
+
+		auto iter = pool.find(key);
+
+		// Health check, the connection is closed when the peer goes away
+		if(iter != pool.end() && !isClosed(iter->second))
+			return static_cast<T*>(g_object_ref(iter->second));
+	}
+
+	T* created = create();
+
+	if(created == nullptr)
+		return nullptr;
+
+	std::lock_guard<std::mutex> guard(connectionPoolLock);
+
+	auto& pooled = pool[key];
+
+	if(pooled != nullptr && !isClosed(pooled))
+	{
+		g_object_unref(created);
+	}
+	else
+	{
+		if(pooled != nullptr)
+		{
+			dlog_print(DLOG_DEBUG, "RPC-Test", "Pooled connection of %s is closed, replaced", key.c_str());
+			g_object_unref(pooled);
+		}
+
+		pooled = created;
+	}
+
+	return static_cast<T*>(g_object_ref(pooled));
+}
+
+}
+
+LIBAPI
+GDBusConnection* TFC::ServiceModel::GDBusConnectionPool::AcquireConnection(std::string const& address, GError** error)
+{
+	return AcquirePooled(connectionPool, address,
+		[] (GDBusConnection* connection) { return g_dbus_connection_is_closed(connection); },
+		[&address, error] () {
+			return g_dbus_connection_new_for_address_sync(address.c_str(), G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT, nullptr, nullptr, error);
+		});
+}
+
+LIBAPI
+GDBusProxy* TFC::ServiceModel::GDBusConnectionPool::AcquireProxy(GDBusConfiguration const& config,
+		char const* objectPath, char const* interfaceName, GError** error)
+{
+	std::stringstream keyStream;
+	keyStream << config.busType << ':' << config.proxyFlags << ':' << config.busName << ':' << objectPath << ':' << interfaceName;
+
+	return AcquirePooled(proxyPool, keyStream.str(),
+		[] (GDBusProxy* proxy) { return g_dbus_connection_is_closed(g_dbus_proxy_get_connection(proxy)); },
+		[&config, objectPath, interfaceName, error] () {
+			return g_dbus_proxy_new_for_bus_sync(config.busType, config.proxyFlags, nullptr, config.busName, objectPath, interfaceName, nullptr, error);
+		});
+}
+
+LIBAPI
+void TFC::ServiceModel::GDBusConnectionPool::Clear()
+{
+	std::lock_guard<std::mutex> guard(connectionPoolLock);
+
+	for(auto& entry : connectionPool)
+		if(entry.second != nullptr)
+			g_object_unref(entry.second);
+
+	for(auto& entry : proxyPool)
+		if(entry.second != nullptr)
+			g_object_unref(entry.second);
+
+	connectionPool.clear();
+	proxyPool.clear();
+}
+
 LIBAPI
 TFC::ServiceModel::GDBusClient::GDBusClient(GDBusConfiguration const& config,
-		const char* objectPath, const char* interfaceName) : objectPath(objectPath), interfaceName(interfaceName) {
+		const char* objectPath, const char* interfaceName) : objectPath(objectPath), interfaceName(interfaceName), signalSubscriptionId(0) {
 	this->busType = config.busType;
 
 	TFCAssert<ArgumentException>(objectPath != nullptr && objectPath[0] != '\0', "Object path cannot be null or empty string.");
@@ -214,19 +880,18 @@ TFC::ServiceModel::GDBusClient::GDBusClient(GDBusConfiguration const& config,
 	// Check if the user speficy bus type NONE
 	if(this->busType == G_BUS_TYPE_NONE)
 	{
-		std::string realPath("unix:path=");
-		realPath.append(config.busPath);
+		address = "unix:path=";
+		address.append(config.busPath);
 
-		dlog_print(DLOG_DEBUG, "RPC-Test", "Create connection for address %s", realPath.c_str());
+		dlog_print(DLOG_DEBUG, "RPC-Test", "Acquire connection for address %s", address.c_str());
 
-		// Create connection using direct addressing
-		this->handle = g_dbus_connection_new_for_address_sync(realPath.c_str(), G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT, nullptr, nullptr, &err);
-		//g_dbus_connection_set_exit_on_close((GDBusConnection*)this->handle, false);
+		// Share the connection using direct addressing
+		this->handle = GDBusConnectionPool::AcquireConnection(address, &err);
 	}
 	else if(this->busType == G_BUS_TYPE_SYSTEM || this->busType == G_BUS_TYPE_SESSION)
 	{
-		// Create connection using DBus proxy
-		this->handle = g_dbus_proxy_new_for_bus_sync(config.busType, config.proxyFlags, nullptr, config.busName, objectPath, interfaceName, nullptr, &err);
+		// Share the DBus proxy of the object
+		this->handle = GDBusConnectionPool::AcquireProxy(config, objectPath, interfaceName, &err);
 	}
 	dlog_print(DLOG_DEBUG, "RPC-Test", "After new proxy for: %s %s %s, result %d", config.busName, objectPath, interfaceName, handle);
 
@@ -287,14 +952,104 @@ GVariant* TFC::ServiceModel::GDBusClient::RemoteCall(const char* methodName, GVa
 
 	dlog_print(DLOG_DEBUG, "RPC-Test", "Calling: %s", methodName);
 
+	// Descriptors are attached before connecting, as connecting may call the remote side too
+	GUnixFDList* inFDList = nullptr;
+	GVariantAutoPtr parameterRef { parameter != nullptr ? AttachSharedBuffers(parameter, inFDList) : nullptr };
+	std::unique_ptr<GUnixFDList, GObjectDeleter> fdList(inFDList);
+
+	std::unique_ptr<void, GObjectDeleter> handle(EnsureConnected());
+
 	GError* err = nullptr;
 	GVariant* ptr = nullptr;
+	GUnixFDList* outFDList = nullptr;
 
 	// Call the remote method based on the bus type
 	if(busType == G_BUS_TYPE_NONE)
-		ptr = g_dbus_connection_call_sync((GDBusConnection*)this->handle, nullptr, objectPath.c_str(), interfaceName.c_str(), methodName, parameter, nullptr, G_DBUS_CALL_FLAGS_NONE, G_MAXINT, nullptr, &err);
+		ptr = g_dbus_connection_call_with_unix_fd_list_sync((GDBusConnection*)handle.get(), nullptr, objectPath.c_str(), interfaceName.c_str(), methodName, parameterRef.get(), nullptr, G_DBUS_CALL_FLAGS_NONE, G_MAXINT, fdList.get(), &outFDList, nullptr, &err);
+	else
+		ptr = g_dbus_proxy_call_with_unix_fd_list_sync((GDBusProxy*)handle.get(), methodName, parameterRef.get(), G_DBUS_CALL_FLAGS_NONE, G_MAXINT, fdList.get(), &outFDList, nullptr, &err);
+
+	std::unique_ptr<GUnixFDList, GObjectDeleter> replyFDList(outFDList);
+	GVariantAutoPtr result { FinishRemoteCall(ptr, err) };
+
+	return ResolveSharedBuffers(result.get(), replyFDList.get());
+}
+
+namespace {
+
+struct RemoteCallAsyncContext
+{
+	GDBusClient::RemoteCallCompletion completion;
+};
+
+}
+
+LIBAPI
+void TFC::ServiceModel::GDBusClient::RemoteCallAsync(const char* methodName, GVariant* parameter, RemoteCallCompletion completion) {
+
+	if(methodName == nullptr || methodName[0] == '\0')
+		throw ArgumentException("Method name cannot be null or empty string.");
+
+	// Descriptors are attached before connecting, as connecting may call the remote side too
+	GUnixFDList* inFDList = nullptr;
+	GVariantAutoPtr parameterRef { parameter != nullptr ? AttachSharedBuffers(parameter, inFDList) : nullptr };
+	std::unique_ptr<GUnixFDList, GObjectDeleter> fdList(inFDList);
+
+	std::unique_ptr<void, GObjectDeleter> handle(EnsureConnected());
+
+	auto context = new RemoteCallAsyncContext { std::move(completion) };
+
+	// The reply is dispatched to the source object, so the callback can tell the bus type from it
+	if(busType == G_BUS_TYPE_NONE)
+		g_dbus_connection_call_with_unix_fd_list((GDBusConnection*)handle.get(), nullptr, objectPath.c_str(), interfaceName.c_str(), methodName, parameterRef.get(), nullptr, G_DBUS_CALL_FLAGS_NONE, G_MAXINT, fdList.get(), nullptr, GDBusClient::RemoteCallAsyncCallback, context);
 	else
-		ptr = g_dbus_proxy_call_sync((GDBusProxy*)this->handle, methodName, parameter, G_DBUS_CALL_FLAGS_NONE, G_MAXINT, nullptr, &err);
+		g_dbus_proxy_call_with_unix_fd_list((GDBusProxy*)handle.get(), methodName, parameterRef.get(), G_DBUS_CALL_FLAGS_NONE, G_MAXINT, fdList.get(), nullptr, GDBusClient::RemoteCallAsyncCallback, context);
+}
+
+LIBAPI
+void TFC::ServiceModel::GDBusClient::RemoteCallAsyncCallback(GObject* source, GAsyncResult* res, gpointer user_data) {
+	std::unique_ptr<RemoteCallAsyncContext> context(static_cast<RemoteCallAsyncContext*>(user_data));
+
+	GError* err = nullptr;
+	GVariant* ptr = nullptr;
+	GUnixFDList* outFDList = nullptr;
+
+	if(G_IS_DBUS_PROXY(source))
+		ptr = g_dbus_proxy_call_with_unix_fd_list_finish(G_DBUS_PROXY(source), &outFDList, res, &err);
+	else
+		ptr = g_dbus_connection_call_with_unix_fd_list_finish(G_DBUS_CONNECTION(source), &outFDList, res, &err);
+
+	std::unique_ptr<GUnixFDList, GObjectDeleter> replyFDList(outFDList);
+	GVariant* result = nullptr;
+	std::exception_ptr error;
+
+	try
+	{
+		GVariantAutoPtr reply { FinishRemoteCall(ptr, err) };
+		result = ResolveSharedBuffers(reply.get(), replyFDList.get());
+	}
+	catch(...)
+	{
+		error = std::current_exception();
+	}
+
+	try
+	{
+		context->completion(result, error);
+	}
+	catch(std::exception const& ex)
+	{
+		// Exception cannot propagate through GLib main loop
+		dlog_print(DLOG_ERROR, "TFC-RPC", "Unhandled exception in remote call completion: %s", ex.what());
+	}
+	catch(...)
+	{
+		dlog_print(DLOG_ERROR, "TFC-RPC", "Unhandled exception in remote call completion");
+	}
+}
+
+LIBAPI
+GVariant* TFC::ServiceModel::GDBusClient::FinishRemoteCall(GVariant* ptr, GError* err) {
 
 	dlog_print(DLOG_DEBUG, "RPC-Test", "Result: %d", ptr);
 
@@ -313,37 +1068,21 @@ GVariant* TFC::ServiceModel::GDBusClient::RemoteCall(const char* methodName, GVa
 
 			dlog_print(DLOG_ERROR, "RPC-Test", "Error when calling: %s => %s", typeName.c_str(), err->message);
 
-			try
-			{
-				auto& info = Core::FindTypeByName(typeName);
-
-				std::regex errRegex(R"REGEX(^GDBus\.Error:[A-Za-z0-9._]*:\s?(.*))REGEX");
-				std::cmatch match;
+			std::regex errRegex(R"REGEX(^GDBus\.Error:[A-Za-z0-9._]*:\s?(.*))REGEX");
+			std::cmatch match;
 
-				std::string errMessage;
+			std::string errMessage;
 
-				if(std::regex_match(err->message, match, errRegex))
-				{
-					errMessage = match[1].str();
-				}
-				else
-				{
-					errMessage = err->message;
-				}
-
-				try
-				{
-					info.Throw(errMessage);
-				}
-				catch(Core::FunctionNotFoundException const& ex)
-				{
-					info.Throw();
-				}
+			if(std::regex_match(err->message, match, errRegex))
+			{
+				errMessage = match[1].str();
 			}
-			catch(Core::ReflectionException const& ex)
+			else
 			{
-				throw Core::InvocationException(err->message);
+				errMessage = err->message;
 			}
+
+			std::rethrow_exception(CreateRemoteException(typeName, errMessage));
 		}
 	}
 
@@ -354,33 +1093,100 @@ GVariant* TFC::ServiceModel::GDBusClient::RemoteCall(const char* methodName, GVa
 		auto child = g_variant_get_child_value(ptr, 0);
 		g_variant_unref(ptr);
 
-		auto debug = g_variant_print(child, true);
-		dlog_print(DLOG_DEBUG, "TFC-RPC", "Client receive response: %s", debug);
-		g_free(debug);
+#ifdef TFC_GDBUS_TRACE
+		gchar* printed = g_variant_print(child, true);
+		TFC_GDBusTrace("Client receive response: %s", printed);
+		g_free(printed);
+#endif
 
 		return child;
 	}
 
-	return ptr;
+	return ptr;
+}
+
+LIBAPI
+TFC::ServiceModel::GDBusClient::~GDBusClient()
+{
+	if(this->handle)
+	{
+		// The connection is shared with other clients, so the server is told to stop delivering
+		// the events nobody else on the connection is subscribed to
+		auto connection = GetConnection(busType, this->handle);
+
+		for(auto& eventName : this->subscribedEvents)
+			if(RemoveSubscription(connection, objectPath, eventName))
+				SendUnsubscribe(eventName.c_str());
+
+		// The connection is shared with other clients, so it is left open in the pool
+		UnregisterEvent();
+
+		g_object_unref(this->handle);
+		this->handle = nullptr;
+	}
+}
+
+gpointer TFC::ServiceModel::GDBusClient::EnsureConnected()
+{
+	{
+		std::lock_guard<std::mutex> guard(connectionLock);
+
+		if(this->busType != G_BUS_TYPE_NONE || !g_dbus_connection_is_closed((GDBusConnection*) this->handle))
+			return g_object_ref(this->handle);
+	}
+
+	dlog_print(DLOG_DEBUG, "RPC-Test", "Connection of %s is closed, reconnecting", objectPath.c_str());
+
+	// Connecting blocks, so it is done without the lock. The threads reconnecting at the same time
+	// get the same connection from the pool.
+	GError* err = nullptr;
+	std::unique_ptr<void, GObjectDeleter> connection(GDBusConnectionPool::AcquireConnection(address, &err));
+
+	if(err != nullptr)
+	{
+		std::unique_ptr<GError, GErrorDeleter> errPtr(err);
+		throw GDBusException(std::string("Cannot reconnect client for object path: ") + objectPath + "; Reason: " + errPtr->message);
+	}
+
+	std::vector<std::string> restoredEvents;
+
+	{
+		std::lock_guard<std::mutex> guard(connectionLock);
+
+		// Another thread has replaced the handle meanwhile
+		if(!g_dbus_connection_is_closed((GDBusConnection*) this->handle))
+			return g_object_ref(this->handle);
+
+		UnregisterEvent();
+
+		// The subscriptions of this client move to the new connection
+		for(auto& eventName : this->subscribedEvents)
+		{
+			RemoveSubscription((GDBusConnection*)this->handle, objectPath, eventName);
+			AddSubscription((GDBusConnection*)connection.get(), objectPath, eventName);
+		}
+
+		g_object_unref(this->handle);
+		this->handle = g_object_ref(connection.get());
+
+		RegisterEvent();
+
+		restoredEvents = this->subscribedEvents;
+	}
+
+	// The server dropped the subscriptions of the closed connection. They are sent without the
+	// lock, so the other calls of this client do not wait for the replies.
+	for(auto& eventName : restoredEvents)
+		SendSubscribe(connection.get(), eventName.c_str());
+
+	return connection.release();
 }
 
 LIBAPI
-TFC::ServiceModel::GDBusClient::~GDBusClient()
+bool TFC::ServiceModel::GDBusClient::IsClosed()
 {
-	if(this->handle)
-	{
-		if(this->busType == G_BUS_TYPE_NONE)
-		{
-			g_dbus_connection_close_sync((GDBusConnection*) this->handle, nullptr, nullptr);
-		}
-		else
-		{
-			g_signal_handlers_disconnect_by_data(this->handle, this);
-		}
-
-		g_object_unref(this->handle);
-		this->handle = nullptr;
-	}
+	std::lock_guard<std::mutex> guard(connectionLock);
+	return busType != G_BUS_TYPE_NONE || g_dbus_connection_is_closed((GDBusConnection*) handle);
 }
 
 
@@ -394,6 +1200,7 @@ LIBAPI
 TFC::ServiceModel::GDBusInterfaceDefinition::GDBusInterfaceDefinition() {
 	this->interfaceInfo.ref_count = -1;
 	this->interfaceInfo.name = nullptr;
+	this->subscriptionMethodInfo = nullptr;
 
 	this->methodInfoList.push_back(nullptr);
 	this->signalInfoList.push_back(nullptr);
@@ -422,6 +1229,16 @@ void TFC::ServiceModel::GDBusInterfaceDefinition::SetInterfaceName(
 	this->interfaceInfo.name = const_cast<char*>(this->interfaceNameStd.c_str());
 }
 
+LIBAPI
+int TFC::ServiceModel::GDBusInterfaceDefinition::GetFunctionIndex(GDBusMethodInfo const* methodInfo) const
+{
+	auto iter = this->methodIndexMap.find(methodInfo);
+	if(iter == this->methodIndexMap.end())
+		return -1;
+
+	return iter->second;
+}
+
 LIBAPI
 void TFC::ServiceModel::GDBusInterfaceDefinition::RegisterFunction(
 		std::string const& funcName,
@@ -463,11 +1280,27 @@ void TFC::ServiceModel::GDBusInterfaceDefinition::RegisterFunction(
 	int lastIndex = this->methodInfoList.size();
 	this->methodInfoList[lastIndex - 1] = m;
 	this->methodInfoList.push_back(nullptr);
+	this->methodIndexMap.emplace(m, lastIndex - 1);
 
 	// Refresh the address
 	this->interfaceInfo.methods = &this->methodInfoList[0];
 }
 
+LIBAPI
+void TFC::ServiceModel::GDBusInterfaceDefinition::RegisterBatchFunction(char const* funcName)
+{
+	// Batch request and response are single tuple of variable content
+	RegisterFunction(funcName, { "r" }, "r");
+}
+
+LIBAPI
+void TFC::ServiceModel::GDBusInterfaceDefinition::RegisterSubscriptionFunction(char const* funcName)
+{
+	// Takes the event name and a flag whether to subscribe or unsubscribe
+	RegisterFunction(funcName, { "s", "b" }, "");
+	this->subscriptionMethodInfo = this->methodInfoList[this->methodInfoList.size() - 2];
+}
+
 LIBAPI
 void TFC::ServiceModel::GDBusInterfaceDefinition::RegisterEvent(
 		const std::string& eventName, const std::string& arg)
@@ -580,30 +1413,28 @@ std::regex dotRegex("\\.");
 void TFC::ServiceModel::GDBusServer::OnBusAcquired(GDBusConnection* connection,
 		const gchar* name) {
 
-	std::cout << "Bus acq\n";
+	// Peer connections are accepted on the server thread while objects are added and events are
+	// emitted from others
+	std::lock_guard<std::mutex> guard(this->eventLock);
 
-	for(auto& obj : this->objectList)
+	for(auto& entry : this->objectPathMap)
 	{
-		auto& serverObj = obj.second;
-
-		std::string objPath = rootPath;
-		objPath += std::regex_replace(serverObj->GetName(), dotRegex, "/");
-
+		auto& registration = entry.second;
 		GError* errPtr = nullptr;
 
-		std::cout << "Object path: " << objPath << "\n";
-
-		for(auto& iface : serverObj->GetInterfaceList())
+		for(auto& ifaceReg : registration.interfaces)
 		{
+			auto& ifaceInfo = ifaceReg.iface->definition.GetInterfaceInfo();
+
 			g_dbus_connection_register_object(connection,
-										objPath.c_str(),
-										const_cast<GDBusInterfaceInfo*>(&(iface->GetInterfaceInfo())),
+										registration.objectPath.c_str(),
+										const_cast<GDBusInterfaceInfo*>(&ifaceInfo),
 										&defaultVtable,
-										this,
+										&ifaceReg,
 										nullptr,
 										&errPtr);
 
-			dlog_print(DLOG_DEBUG, LOG_TAG, "Registering %s (%s)", objPath.c_str(), iface->GetInterfaceInfo().name);
+			dlog_print(DLOG_DEBUG, LOG_TAG, "Registering %s (%s)", registration.objectPath.c_str(), ifaceInfo.name);
 
 			if(errPtr != nullptr)
 			{
@@ -611,7 +1442,7 @@ void TFC::ServiceModel::GDBusServer::OnBusAcquired(GDBusConnection* connection,
 
 				std::stringstream ss;
 
-				ss << "Error registering object at path " << objPath;
+				ss << "Error registering object at path " << registration.objectPath;
 				ss << ": " << errPtr->message << ".";
 
 				g_error_free(errPtr);
@@ -621,6 +1452,16 @@ void TFC::ServiceModel::GDBusServer::OnBusAcquired(GDBusConnection* connection,
 		}
 	}
 
+	// Subscription on message bus is addressed to the unique name of the client, which is
+	// released when the client process exits without unsubscribing
+	if(this->config.busType != G_BUS_TYPE_NONE && this->nameOwnerSubscriptionId == 0)
+	{
+		this->busConnection = static_cast<GDBusConnection*>(g_object_ref(connection));
+		this->nameOwnerSubscriptionId = g_dbus_connection_signal_subscribe(connection, "org.freedesktop.DBus",
+				"org.freedesktop.DBus", "NameOwnerChanged", "/org/freedesktop/DBus", nullptr, G_DBUS_SIGNAL_FLAGS_NONE,
+				&GDBusServer::OnNameOwnerChangedCallback, this, nullptr);
+	}
+
 	this->connectionList.push_back(connection);
 }
 
@@ -637,9 +1478,28 @@ void TFC::ServiceModel::GDBusServer::OnNameLost(GDBusConnection* connection,
 
 LIBAPI
 TFC::ServiceModel::GDBusServer::GDBusServer(Configuration const& config) :
-	busId(0), server(nullptr), config(config)
+	busId(0), busConnection(nullptr), nameOwnerSubscriptionId(0), server(nullptr), workerPool(nullptr),
+	perObjectStrand(true), config(config)
+{
+
+}
+
+LIBAPI
+void TFC::ServiceModel::GDBusServer::EnableWorkerPool(unsigned int threadCount, bool perObjectStrand)
 {
+	TFCAssert<GDBusException>(this->workerPool == nullptr, "Worker pool is already enabled");
+	TFCAssert<GDBusException>(threadCount > 0, "Worker pool requires at least one thread");
 
+	GError* err = nullptr;
+	this->workerPool = g_thread_pool_new(OnWorkerCallback, this, threadCount, FALSE, &err);
+
+	if(err != nullptr)
+	{
+		std::unique_ptr<GError, GErrorDeleter> errPtr(err);
+		throw GDBusException(errPtr->message);
+	}
+
+	this->perObjectStrand = perObjectStrand;
 }
 
 static gboolean
@@ -660,6 +1520,9 @@ void TFC::ServiceModel::GDBusServer::Initialize()
 	rootPath += std::regex_replace(this->config.busName, dotRegex, "/");
 	rootPath += "/";
 
+	for(auto& obj : this->objectList)
+		RegisterObjectPath(obj.second.get());
+
 	if(config.busType == GBusType::G_BUS_TYPE_NONE)
 	{
 		// Not a message bus
@@ -721,75 +1584,239 @@ void TFC::ServiceModel::GDBusServer::OnMethodCallCallback(
 		const gchar* object_path, const gchar* interface_name,
 		const gchar* method_name, GVariant* parameters,
 		GDBusMethodInvocation* invocation, gpointer user_data) {
-	static_cast<GDBusServer*>(user_data)->OnMethodCall(
-			connection, sender,
+	auto registration = static_cast<InterfaceRegistration*>(user_data);
+	registration->server->OnMethodCall(
+			registration, connection, sender,
 			object_path, interface_name,
 			method_name, parameters,
 			invocation);
 }
 
-void TFC::ServiceModel::GDBusServer::OnMethodCall(GDBusConnection* connection,
-		const gchar* sender, const gchar* object_path,
+void TFC::ServiceModel::GDBusServer::OnMethodCall(InterfaceRegistration* registration,
+		GDBusConnection* connection, const gchar* sender, const gchar* object_path,
 		const gchar* interface_name, const gchar* method_name,
 		GVariant* parameters, GDBusMethodInvocation* invocation) {
 
-	std::cout << "Method Call (" << object_path << ", " << interface_name << ", " << method_name << ")\n";
+	TFC_GDBusTrace("Method call (%s, %s, %s)", object_path, interface_name, method_name);
+
+	// Subscription only touches the server state, so it is not dispatched to the workers
+	if(registration->iface->definition.IsSubscriptionFunction(g_dbus_method_invocation_get_method_info(invocation)))
+	{
+		Subscribe(registration, connection, sender, parameters, invocation);
+		return;
+	}
+
+	if(this->workerPool == nullptr)
+	{
+		ExecuteCall(registration, invocation);
+	}
+	else if(this->perObjectStrand)
+	{
+		auto strand = registration->strand;
+		bool schedule = false;
+
+		{
+			std::lock_guard<std::mutex> guard(strand->lock);
+			strand->queue.push_back({ registration, invocation });
+			schedule = !strand->scheduled;
+			strand->scheduled = true;
+		}
+
+		// Only one worker may drain the strand, the others are left for the other objects
+		if(schedule)
+			g_thread_pool_push(this->workerPool, strand, nullptr);
+	}
+	else
+	{
+		g_thread_pool_push(this->workerPool, new PendingCall { registration, invocation }, nullptr);
+	}
+}
+
+void TFC::ServiceModel::GDBusServer::OnWorkerCallback(gpointer data, gpointer user_data)
+{
+	static_cast<GDBusServer*>(user_data)->ExecuteWork(data);
+}
 
-	std::regex objectNameRegex("[A-Za-z0-9]+$");
-	std::cmatch match;
-	if(std::regex_search(object_path, match, objectNameRegex))
+void TFC::ServiceModel::GDBusServer::ExecuteWork(gpointer data)
+{
+	if(!this->perObjectStrand)
 	{
-		auto parsedObjectName = match.str();
+		std::unique_ptr<PendingCall> call(static_cast<PendingCall*>(data));
+		ExecuteCall(call->registration, call->invocation);
+		return;
+	}
 
-		std::cout << "PArsed: " << parsedObjectName << "\n";
+	auto strand = static_cast<ObjectStrand*>(data);
 
-		auto obj = this->objectList.find(parsedObjectName);
+	while(true)
+	{
+		PendingCall call;
 
-		if(obj != this->objectList.end())
 		{
-			try
-			{
-				auto result = obj->second->Invoke(interface_name, method_name, parameters);
+			std::lock_guard<std::mutex> guard(strand->lock);
 
-				gchar* printed = g_variant_print(result, true);
-				dlog_print(DLOG_DEBUG, LOG_TAG, "Invocation result: %s", printed);
-				g_free(printed);
-				g_dbus_method_invocation_return_value(invocation, result);
-				dlog_print(DLOG_DEBUG, LOG_TAG, "After return");
-			}
-			catch(std::exception& ex)
+			if(strand->queue.empty())
 			{
-				dlog_print(DLOG_DEBUG, LOG_TAG, "Type name: %s", typeid(ex).name());
-				g_dbus_method_invocation_return_error(invocation, g_quark_from_string(typeid(ex).name()), 0, ex.what());
-				//g_dbus_method_invocation_return_dbus_error(invocation, GetInterfaceName("", typeid(ex)).c_str(), ex.what());
+				strand->scheduled = false;
+				return;
 			}
+
+			call = strand->queue.front();
+			strand->queue.pop_front();
 		}
-	} else std::cout << "Failed parsing object name\n";
+
+		ExecuteCall(call.registration, call.invocation);
+	}
+}
+
+void TFC::ServiceModel::GDBusServer::ExecuteCall(InterfaceRegistration* registration,
+		GDBusMethodInvocation* invocation) {
+	try
+	{
+		// GDBus passes the method info of the registered interface, so the method is resolved by
+		// its address instead of its name
+		auto iface = registration->iface;
+		auto functionIndex = iface->definition.GetFunctionIndex(g_dbus_method_invocation_get_method_info(invocation));
+		// Shared buffers in the parameters are resolved against the descriptors of the message
+		auto inFDList = g_dbus_message_get_unix_fd_list(g_dbus_method_invocation_get_message(invocation));
+		GVariantAutoPtr parameters { ResolveSharedBuffers(g_dbus_method_invocation_get_parameters(invocation), inFDList) };
+
+		GVariant* result = nullptr;
+
+		if(functionIndex >= 0)
+			result = iface->invoker->Invoke((size_t)functionIndex, parameters.get());
+		else
+			result = iface->invoker->Invoke(g_dbus_method_invocation_get_method_name(invocation), parameters.get());
+
+#ifdef TFC_GDBUS_TRACE
+		gchar* printed = g_variant_print(result, true);
+		TFC_GDBusTrace("Invocation result: %s", printed);
+		g_free(printed);
+#endif
+
+		GUnixFDList* outFDList = nullptr;
+		GVariantAutoPtr resultRef { result != nullptr ? AttachSharedBuffers(result, outFDList) : nullptr };
+		std::unique_ptr<GUnixFDList, GObjectDeleter> fdList(outFDList);
+
+		g_dbus_method_invocation_return_value_with_unix_fd_list(invocation, resultRef.get(), fdList.get());
+	}
+	catch(std::exception& ex)
+	{
+		dlog_print(DLOG_DEBUG, LOG_TAG, "Type name: %s", typeid(ex).name());
+		g_dbus_method_invocation_return_error(invocation, g_quark_from_string(typeid(ex).name()), 0, ex.what());
+		//g_dbus_method_invocation_return_dbus_error(invocation, GetInterfaceName("", typeid(ex)).c_str(), ex.what());
+	}
+}
+
+std::string TFC::ServiceModel::GDBusServer::GetObjectPath(std::string const& objectName) const
+{
+	std::string objPath = rootPath;
+	objPath += objectName;
+	std::replace(objPath.begin() + rootPath.size(), objPath.end(), '.', '/');
+	return objPath;
+}
+
+void TFC::ServiceModel::GDBusServer::RegisterObjectPath(IServerObject<GDBusChannel>* obj)
+{
+	auto objPath = GetObjectPath(obj->GetName());
+
+	// The connections may be accepted on the server thread while the object is added
+	std::lock_guard<std::mutex> guard(this->eventLock);
+
+	// The registered interfaces are the user data of the objects registered on the connections,
+	// so they are never replaced
+	if(this->objectPathMap.find(objPath) != this->objectPathMap.end())
+		throw GDBusException("Object path " + objPath + " is already registered");
+
+	auto& registration = this->objectPathMap[objPath];
+
+	registration.object = obj;
+	registration.objectPath = objPath;
+	registration.strand.reset(new ObjectStrand);
+	registration.strand->scheduled = false;
+
+	for(auto iface : obj->GetInterfaceEntryList())
+		registration.interfaces.push_back({ this, iface, registration.strand.get(), &registration });
 }
 
 LIBAPI
 void TFC::ServiceModel::GDBusServer::AddServerObject(IServerObject<GDBusChannel>* obj)
 {
-	std::string const& name = obj->GetName();
-	this->objectList.emplace(name, std::unique_ptr<IServerObject<GDBusChannel>>(obj));
-
-	obj->eventEventRaised += EventHandler(GDBusServer::EventCaptureHandler);
+	AddServerObject(std::unique_ptr<IServerObject<GDBusChannel>>(obj));
 }
 
 LIBAPI
 void TFC::ServiceModel::GDBusServer::AddServerObject(std::unique_ptr<IServerObject<GDBusChannel>> obj)
 {
+	auto ptr = obj.get();
 	std::string const& name = obj->GetName();
+
+	// Registered first, so the object rejected for its path is not kept
+	if(!rootPath.empty())
+		RegisterObjectPath(ptr);
+
 	this->objectList.emplace(name, std::move(obj));
+
+	ptr->eventEventRaised += EventHandler(GDBusServer::EventCaptureHandler);
+}
+
+LIBAPI
+void TFC::ServiceModel::GDBusServer::SetEventCoalescing(std::string const& eventName, unsigned int windowInMilliseconds)
+{
+	std::lock_guard<std::mutex> guard(this->eventLock);
+	this->coalescingWindowMap[eventName] = windowInMilliseconds;
 }
 
 LIBAPI
 TFC::ServiceModel::GDBusServer::~GDBusServer() {
+	if(nameOwnerSubscriptionId != 0)
+	{
+		g_dbus_connection_signal_unsubscribe(this->busConnection, this->nameOwnerSubscriptionId);
+		g_object_unref(this->busConnection);
+	}
+
 	if(busId != 0)
 		g_bus_unown_name(this->busId);
 
 	if(server != nullptr)
+	{
 		g_dbus_server_stop(this->server);
+
+		// Stopping the server only stops listening. Close the peer connections as well, so the
+		// clients sharing them notice and reconnect instead of calling the destroyed objects.
+		std::vector<GDBusConnection*> connections;
+
+		{
+			std::lock_guard<std::mutex> guard(this->eventLock);
+			connections.swap(this->connectionList);
+		}
+
+		for(auto connection : connections)
+		{
+			g_signal_handlers_disconnect_by_data(connection, this);
+			g_dbus_connection_close_sync(connection, nullptr, nullptr);
+			g_object_unref(connection);
+		}
+	}
+
+	// Let the workers complete the calls already queued before the server objects are destroyed
+	if(workerPool != nullptr)
+		g_thread_pool_free(this->workerPool, FALSE, TRUE);
+
+	// The coalescing timers refer to the event state owned by this server
+	for(auto& entry : this->objectPathMap)
+	{
+		for(auto& event : entry.second.events)
+		{
+			auto& state = event.second;
+
+			if(state.timerId != 0)
+				g_source_remove(state.timerId);
+
+			if(state.pendingArgument != nullptr)
+				g_variant_unref(state.pendingArgument);
+		}
+	}
 }
 
 
@@ -856,39 +1883,41 @@ void TFC::ServiceModel::GVariantDeserializer::Deserialize(double& target) {
 
 LIBAPI
 void TFC::ServiceModel::GVariantDeserializer::Deserialize(std::vector<uint8_t>& target) {
-	target.clear();
-	auto arrVariant = g_variant_iter_next_value(&iter);
-	auto arrIter = g_variant_iter_new(arrVariant);
-	uint8_t value;
-	while (g_variant_iter_next(arrIter, "y", &value)) {
-		target.push_back(value);
+	DeserializeSequence(target, std::true_type());
+}
+
+LIBAPI
+void TFC::ServiceModel::GVariantDeserializer::Deserialize(SharedBuffer& target) {
+	auto field = NextField();
+
+	TFCAssert<Serialization::SerializationException>(g_variant_is_of_type(field.get(), G_VARIANT_TYPE_VARIANT),
+			"The specified field is not a shared buffer");
+
+	GVariantAutoPtr value { g_variant_get_variant(field.get()) };
+
+	if(g_variant_is_of_type(value.get(), G_VARIANT_TYPE_HANDLE))
+	{
+		target = SharedBuffer::Map(g_variant_get_handle(value.get()));
+	}
+	else
+	{
+		TFCAssert<Serialization::SerializationException>(g_variant_is_of_type(value.get(), G_VARIANT_TYPE_BYTESTRING),
+				"The specified field is not a shared buffer");
+
+		gsize len = 0;
+		auto ptr = g_variant_get_fixed_array(value.get(), &len, sizeof(uint8_t));
+		target = SharedBuffer::Copy(ptr, len);
 	}
-	g_variant_iter_free(arrIter);
 }
 
 LIBAPI
 void TFC::ServiceModel::GVariantDeserializer::Deserialize(std::vector<int32_t>& target) {
-	target.clear();
-	dlog_print(DLOG_DEBUG, "TFC-RPC", "Deserialize vector");
-	auto arrVariant = g_variant_iter_next_value(&iter);
-	auto arrIter = g_variant_iter_new(arrVariant);
-	int32_t value;
-	while (g_variant_iter_next(arrIter, "i", &value)) {
-		target.push_back(value);
-	}
-	g_variant_iter_free(arrIter);
+	DeserializeSequence(target, std::true_type());
 }
 
 LIBAPI
 void TFC::ServiceModel::GVariantDeserializer::Deserialize(std::vector<int64_t>& target) {
-	target.clear();
-	auto arrVariant = g_variant_iter_next_value(&iter);
-	auto arrIter = g_variant_iter_new(arrVariant);
-	int64_t value;
-	while (g_variant_iter_next(arrIter, "x", &value)) {
-		target.push_back(value);
-	}
-	g_variant_iter_free(arrIter);
+	DeserializeSequence(target, std::true_type());
 }
 
 LIBAPI
@@ -922,9 +1951,11 @@ GVariantDeserializer TFC::ServiceModel::GVariantDeserializer::DeserializeScope()
 {
 	auto val = g_variant_iter_next_value(&iter);
 
-	auto str = g_variant_print(val, true);
-	dlog_print(DLOG_DEBUG, "TFC-RPC", "The value of scope is: %s", str);
-	g_free(str);
+#ifdef TFC_GDBUS_TRACE
+	gchar* printed = g_variant_print(val, true);
+	TFC_GDBusTrace("The value of scope is: %s", printed);
+	g_free(printed);
+#endif
 
 	TFCAssert(g_variant_type_is_tuple(g_variant_get_type(val)), "Invalid value. Scope value is not tuple.");
 	return { val };
@@ -935,67 +1966,303 @@ void TFC::ServiceModel::GDBusServer::OnConnectionClosedCallback(
 		GError* error, gpointer user_data) {
 	auto thiz = static_cast<GDBusServer*>(user_data);
 	dlog_print(DLOG_DEBUG, "RPC-Test-Connection", "Connection is closed");
+
+	{
+		std::lock_guard<std::mutex> guard(thiz->eventLock);
+
+		auto& connections = thiz->connectionList;
+		connections.erase(std::remove(connections.begin(), connections.end(), connection), connections.end());
+
+		// Drop the subscription of the closed connection
+		thiz->RemoveSubscribers(connection, nullptr);
+	}
+
 	g_object_unref(connection);
-	std::remove_if(thiz->connectionList.begin(), thiz->connectionList.end(), [connection] (GDBusConnection* data) { return data == connection; });
 }
 
-void TFC::ServiceModel::GDBusServer::EventCaptureHandler(IServerObject<GDBusChannel>* source, IServerObject<GDBusChannel>::EventEmissionInfo const& eventInfo)
+void TFC::ServiceModel::GDBusServer::OnNameOwnerChangedCallback(GDBusConnection* connection,
+		const gchar* sender_name, const gchar* object_path, const gchar* interface_name,
+		const gchar* signal_name, GVariant* parameters, gpointer user_data) {
+	auto thiz = static_cast<GDBusServer*>(user_data);
+
+	const gchar* name = nullptr;
+	const gchar* oldOwner = nullptr;
+	const gchar* newOwner = nullptr;
+	g_variant_get(parameters, "(&s&s&s)", &name, &oldOwner, &newOwner);
+
+	// Only the unique name of a client which left the bus is of interest
+	if(name[0] != ':' || newOwner[0] != '\0')
+		return;
+
+	dlog_print(DLOG_DEBUG, LOG_TAG, "Client %s left the bus, dropping its subscriptions", name);
+
+	std::lock_guard<std::mutex> guard(thiz->eventLock);
+	thiz->RemoveSubscribers(connection, name);
+}
+
+void TFC::ServiceModel::GDBusServer::RemoveSubscribers(GDBusConnection* connection, char const* destination)
 {
-	decltype(auto) name = source->GetName();
+	for(auto& entry : this->objectPathMap)
+	{
+		for(auto& event : entry.second.events)
+		{
+			auto& subscribers = event.second.subscribers;
+			subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+					[connection, destination] (EventSubscriber const& subscriber) {
+						return subscriber.connection == connection
+							&& (destination == nullptr || subscriber.destination == destination);
+					}),
+					subscribers.end());
+		}
+	}
+}
 
-	dlog_print(DLOG_DEBUG, LOG_TAG, "EventCaptureHandler %s", name.c_str());
+TFC::ServiceModel::GDBusServer::EventState& TFC::ServiceModel::GDBusServer::GetEventState(
+		ObjectRegistration& registration, std::string const& eventName)
+{
+	auto iter = registration.events.find(eventName);
 
-	std::string objPath = rootPath;
-	objPath += std::regex_replace(name, dotRegex, "/");
+	if(iter != registration.events.end())
+		return iter->second;
 
-	char const* ifaceName = nullptr;
+	auto& state = registration.events[eventName];
+	state.server = this;
+	state.owner = &registration;
+	state.eventName = eventName;
+	state.interfaceName = nullptr;
+	state.pendingArgument = nullptr;
+	state.timerId = 0;
 
+	auto window = this->coalescingWindowMap.find(eventName);
+	state.coalescingWindow = window != this->coalescingWindowMap.end() ? window->second : 0;
 
 	// Find interface
-	for(auto& iface : source->GetInterfaceList())
+	for(auto& ifaceReg : registration.interfaces)
 	{
-		auto signalPtr = iface->GetInterfaceInfo().signals;
+		auto& ifaceInfo = ifaceReg.iface->definition.GetInterfaceInfo();
+		auto signalPtr = ifaceInfo.signals;
 
 		while(auto currSignal = *signalPtr)
 		{
-			if(eventInfo.eventName.compare(currSignal->name) == 0)
+			if(eventName.compare(currSignal->name) == 0)
 			{
-				ifaceName = iface->GetInterfaceInfo().name;
+				state.interfaceName = ifaceInfo.name;
 				break;
 			}
 			else
 				++signalPtr;
 		}
+
+		if(state.interfaceName != nullptr)
+			break;
 	}
 
-	dlog_print(DLOG_DEBUG, LOG_TAG, "Found interface %s and object path %s", ifaceName, objPath.c_str());
-	auto paramArg = g_variant_ref_sink(eventInfo.eventArgument);
+	return state;
+}
+
+void TFC::ServiceModel::GDBusServer::Subscribe(InterfaceRegistration* registration,
+		GDBusConnection* connection, const gchar* sender, GVariant* parameters,
+		GDBusMethodInvocation* invocation) {
+	const gchar* eventName = nullptr;
+	gboolean subscribe = FALSE;
+	g_variant_get(parameters, "(&sb)", &eventName, &subscribe);
 
-	for(auto connection : this->connectionList)
 	{
-		GError* err = nullptr;
+		std::lock_guard<std::mutex> guard(this->eventLock);
+
+		auto& state = GetEventState(*registration->owner, eventName);
 
-		g_dbus_connection_emit_signal(connection, nullptr, objPath.c_str(), ifaceName, eventInfo.eventName.c_str(), paramArg, &err);
+		if(state.interfaceName == nullptr)
+		{
+			registration->owner->events.erase(eventName);
+			g_dbus_method_invocation_return_error(invocation, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS, "Unknown event %s", eventName);
+			return;
+		}
+
+		// Peer-to-peer connection belongs to a single client, while message bus connection is
+		// shared so the signal is directed to the unique name of the client
+		std::string destination;
+		if(this->config.busType != G_BUS_TYPE_NONE && sender != nullptr)
+			destination = sender;
+
+		auto& subscribers = state.subscribers;
+		auto existing = std::find_if(subscribers.begin(), subscribers.end(),
+				[connection, &destination] (EventSubscriber const& subscriber) {
+					return subscriber.connection == connection && subscriber.destination == destination;
+				});
+
+		if(subscribe && existing == subscribers.end())
+			subscribers.push_back({ connection, std::move(destination) });
+		else if(!subscribe && existing != subscribers.end())
+			subscribers.erase(existing);
+	}
+
+	g_dbus_method_invocation_return_value(invocation, nullptr);
+}
+
+void TFC::ServiceModel::GDBusServer::EmitEvent(EventState& state, GVariant* argument)
+{
+	for(auto& subscriber : state.subscribers)
+	{
+		GError* err = nullptr;
 
+		g_dbus_connection_emit_signal(subscriber.connection,
+				subscriber.destination.empty() ? nullptr : subscriber.destination.c_str(),
+				state.owner->objectPath.c_str(), state.interfaceName, state.eventName.c_str(), argument, &err);
 
-		dlog_print(DLOG_DEBUG, LOG_TAG, "Emit signal on connection");
 		if(err != nullptr)
 		{
 			dlog_print(DLOG_ERROR, LOG_TAG, "Error on emit signal to connection: %s (%d)", err->message, err->code);
 			g_error_free(err);
 		}
 	}
+}
+
+gboolean TFC::ServiceModel::GDBusServer::OnCoalescingTimeoutCallback(gpointer user_data)
+{
+	auto& state = *static_cast<EventState*>(user_data);
+	std::lock_guard<std::mutex> guard(state.server->eventLock);
+
+	if(state.pendingArgument == nullptr)
+	{
+		// No event raised during the window, the next event is emitted immediately
+		state.timerId = 0;
+		return G_SOURCE_REMOVE;
+	}
+
+	state.server->EmitEvent(state, state.pendingArgument);
+	g_variant_unref(state.pendingArgument);
+	state.pendingArgument = nullptr;
+
+	return G_SOURCE_CONTINUE;
+}
+
+void TFC::ServiceModel::GDBusServer::EventCaptureHandler(IServerObject<GDBusChannel>* source, IServerObject<GDBusChannel>::EventEmissionInfo const& eventInfo)
+{
+	// Signal is emitted without file descriptor, so the shared buffers are sent inline
+	auto paramArg = InlineSharedBuffers(g_variant_ref_sink(eventInfo.eventArgument));
+
+	{
+		std::lock_guard<std::mutex> guard(this->eventLock);
+
+		auto registration = this->objectPathMap.find(GetObjectPath(source->GetName()));
+
+		if(registration != this->objectPathMap.end())
+		{
+			auto& state = GetEventState(registration->second, eventInfo.eventName);
+
+			if(state.interfaceName == nullptr || state.subscribers.empty())
+			{
+				// Nobody listens, so nothing is serialized to the bus
+			}
+			else if(state.coalescingWindow == 0)
+			{
+				EmitEvent(state, paramArg);
+			}
+			else if(state.timerId == 0)
+			{
+				// Leading edge of the window is emitted immediately
+				EmitEvent(state, paramArg);
+				state.timerId = g_timeout_add(state.coalescingWindow, OnCoalescingTimeoutCallback, &state);
+			}
+			else
+			{
+				// Only the latest argument within the window is delivered
+				if(state.pendingArgument != nullptr)
+					g_variant_unref(state.pendingArgument);
+
+				state.pendingArgument = g_variant_ref(paramArg);
+			}
+		}
+	}
 
 	g_variant_unref(paramArg);
 }
 
 void TFC::ServiceModel::GDBusClient::ReceiveEvent(const char* eventName,
 		GVariant* eventArg) {
-	auto str = g_variant_print(eventArg, true);
-	dlog_print(DLOG_DEBUG, "TFC-RPC-EVENT", "The event arg of %s is: %s", eventName, str);
-	g_free(str);
+#ifdef TFC_GDBUS_TRACE
+	gchar* printed = g_variant_print(eventArg, true);
+	TFC_GDBusTrace("The event arg of %s is: %s", eventName, printed);
+	g_free(printed);
+#endif
+
+	// Signal does not carry file descriptor, so a handle in it is never taken as a descriptor
+	GVariantAutoPtr argument { ResolveSharedBuffers(eventArg, nullptr) };
+
+	this->eventEventReceived(this, { eventName, argument.get() });
+}
+
+void TFC::ServiceModel::GDBusClient::SubscribeEvent(char const* eventName)
+{
+	{
+		std::lock_guard<std::mutex> guard(connectionLock);
+
+		// Remembered before it is sent, so reconnecting meanwhile subscribes it on the new
+		// connection as well
+		if(std::find(subscribedEvents.begin(), subscribedEvents.end(), eventName) == subscribedEvents.end())
+		{
+			subscribedEvents.push_back(eventName);
+			AddSubscription(GetConnection(busType, this->handle), objectPath, eventName);
+		}
+	}
+
+	// Subscribing is idempotent on the server, so it is always sent to restore a subscription the
+	// server may have dropped. It is sent without the lock on the connection which delivers the
+	// event.
+	std::unique_ptr<void, GObjectDeleter> handle(EnsureConnected());
+	SendSubscribe(handle.get(), eventName);
+}
+
+void TFC::ServiceModel::GDBusClient::UnsubscribeEvent(char const* eventName)
+{
+	std::lock_guard<std::mutex> guard(connectionLock);
+
+	auto iter = std::find(subscribedEvents.begin(), subscribedEvents.end(), eventName);
+
+	if(iter == subscribedEvents.end())
+		return;
 
-	this->eventEventReceived(this, { eventName, eventArg });
+	subscribedEvents.erase(iter);
+
+	if(RemoveSubscription(GetConnection(busType, this->handle), objectPath, eventName))
+		SendUnsubscribe(eventName);
+}
+
+void TFC::ServiceModel::GDBusClient::SendSubscribe(gpointer handle, char const* eventName)
+{
+	GError* err = nullptr;
+	GVariant* ptr = nullptr;
+	auto parameter = g_variant_new("(sb)", eventName, TRUE);
+
+	if(busType == G_BUS_TYPE_NONE)
+		ptr = g_dbus_connection_call_sync((GDBusConnection*)handle, nullptr, objectPath.c_str(), interfaceName.c_str(), subscriptionFunctionName, parameter, nullptr, G_DBUS_CALL_FLAGS_NONE, G_MAXINT, nullptr, &err);
+	else
+		ptr = g_dbus_proxy_call_sync((GDBusProxy*)handle, subscriptionFunctionName, parameter, G_DBUS_CALL_FLAGS_NONE, G_MAXINT, nullptr, &err);
+
+	auto result = FinishRemoteCall(ptr, err);
+
+	if(result != nullptr)
+		g_variant_unref(result);
+}
+
+void TFC::ServiceModel::GDBusClient::SendUnsubscribe(char const* eventName)
+{
+	auto parameter = g_variant_new("(sb)", eventName, FALSE);
+
+	// Without callback, the call is sent without expecting a reply, so the client never blocks on
+	// a server which has gone away
+	if(busType == G_BUS_TYPE_NONE)
+	{
+		if(!g_dbus_connection_is_closed((GDBusConnection*)this->handle))
+			g_dbus_connection_call((GDBusConnection*)this->handle, nullptr, objectPath.c_str(), interfaceName.c_str(), subscriptionFunctionName, parameter, nullptr, G_DBUS_CALL_FLAGS_NONE, -1, nullptr, nullptr, nullptr);
+		else
+			g_variant_unref(g_variant_ref_sink(parameter));
+	}
+	else
+	{
+		g_dbus_proxy_call((GDBusProxy*)this->handle, subscriptionFunctionName, parameter, G_DBUS_CALL_FLAGS_NONE, -1, nullptr, nullptr, nullptr);
+	}
 }
 
 void TFC::ServiceModel::GDBusClient::RegisterEvent()
@@ -1003,7 +2270,7 @@ void TFC::ServiceModel::GDBusClient::RegisterEvent()
 	if(busType == G_BUS_TYPE_NONE)
 	{
 		auto conn = (GDBusConnection*)this->handle;
-		g_dbus_connection_signal_subscribe(conn, nullptr, interfaceName.c_str(), nullptr, objectPath.c_str(), nullptr, G_DBUS_SIGNAL_FLAGS_NONE, GDBusClient::GDBusConnectionReceiveSignal, this, nullptr);
+		this->signalSubscriptionId = g_dbus_connection_signal_subscribe(conn, nullptr, interfaceName.c_str(), nullptr, objectPath.c_str(), nullptr, G_DBUS_SIGNAL_FLAGS_NONE, GDBusClient::GDBusConnectionReceiveSignal, this, nullptr);
 	}
 	else
 	{
@@ -1012,6 +2279,21 @@ void TFC::ServiceModel::GDBusClient::RegisterEvent()
 	}
 }
 
+void TFC::ServiceModel::GDBusClient::UnregisterEvent()
+{
+	if(busType == G_BUS_TYPE_NONE)
+	{
+		if(this->signalSubscriptionId != 0)
+			g_dbus_connection_signal_unsubscribe((GDBusConnection*)this->handle, this->signalSubscriptionId);
+
+		this->signalSubscriptionId = 0;
+	}
+	else
+	{
+		g_signal_handlers_disconnect_by_data(this->handle, this);
+	}
+}
+
 void TFC::ServiceModel::GDBusClient::GDBusProxyReceiveSignal(GDBusProxy* proxy,
 		gchar* sender_name, gchar* signal_name, GVariant* parameters,
 		gpointer user_data) {